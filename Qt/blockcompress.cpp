@@ -0,0 +1,156 @@
+#include "blockcompress.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const size_t MIN_COPIA = 4;          // lunghezza minima di una copia
+const size_t ULTIMI_LETTERALI = 5;   // gli ultimi byte sono sempre letterali
+const size_t MARGINE_FINE = 12;      // una copia non può iniziare negli ultimi byte
+const int BIT_HASH = 14;             // dimensione della tabella hash delle sequenze di 4 byte
+
+// Legge 4 byte senza vincoli di allineamento
+uint32_t leggi32(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Posizione nella tabella hash di una sequenza di 4 byte
+uint32_t hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - BIT_HASH);
+}
+
+// Scrive una lunghezza oltre i 4 bit del comando: byte da 255 seguiti dal resto
+void scriviLunghezza(std::string& out, size_t lunghezza) {
+    while (lunghezza >= 255) {
+        out += static_cast<char>(255);
+        lunghezza -= 255;
+    }
+    out += static_cast<char>(lunghezza);
+}
+
+// Scrive un comando: letterali [inizio, inizio + nLetterali) e, se nCopia > 0, la copia
+void scriviSequenza(std::string& out, const char* inizio, size_t nLetterali, size_t distanza, size_t nCopia) {
+    size_t resto = nCopia > 0 ? nCopia - MIN_COPIA : 0;
+    unsigned char comando = static_cast<unsigned char>((nLetterali < 15 ? nLetterali : 15) << 4);
+    if (nCopia > 0) {
+        comando |= static_cast<unsigned char>(resto < 15 ? resto : 15);
+    }
+    out += static_cast<char>(comando);
+    if (nLetterali >= 15) {
+        scriviLunghezza(out, nLetterali - 15);
+    }
+    out.append(inizio, nLetterali);
+    if (nCopia > 0) {
+        out += static_cast<char>(distanza & 0xFF);
+        out += static_cast<char>(distanza >> 8);
+        if (resto >= 15) {
+            scriviLunghezza(out, resto - 15);
+        }
+    }
+}
+
+// Legge una lunghezza oltre i 4 bit del comando
+size_t leggiLunghezza(const unsigned char*& p, const unsigned char* fine) {
+    size_t lunghezza = 0;
+    unsigned char b;
+    do {
+        if (p >= fine) {
+            throw std::runtime_error("Blocco compresso danneggiato");
+        }
+        b = *p++;
+        lunghezza += b;
+    } while (b == 255);
+    return lunghezza;
+}
+
+} // namespace
+
+
+// Comprime un blocco di byte
+std::string compressBlock(const char* dati, size_t n) {
+    std::string out;
+    out.reserve(n / 2 + 16);
+    size_t ancora = 0; // inizio dei letterali non ancora scritti
+    if (n > MARGINE_FINE) {
+        std::vector<uint32_t> tabella(size_t(1) << BIT_HASH, UINT32_MAX);
+        size_t limite = n - MARGINE_FINE;
+        size_t i = 0;
+        while (i < limite) {
+            uint32_t sequenza = leggi32(dati + i);
+            uint32_t h = hash4(sequenza);
+            uint32_t candidato = tabella[h];
+            tabella[h] = static_cast<uint32_t>(i);
+            if (candidato == UINT32_MAX || i - candidato > 0xFFFF || leggi32(dati + candidato) != sequenza) {
+                ++i;
+                continue;
+            }
+            // si estende la copia in avanti, lasciando gli ultimi byte come letterali
+            size_t lunghezza = MIN_COPIA;
+            size_t massimo = n - ULTIMI_LETTERALI - i;
+            while (lunghezza < massimo && dati[candidato + lunghezza] == dati[i + lunghezza]) {
+                ++lunghezza;
+            }
+            scriviSequenza(out, dati + ancora, i - ancora, i - candidato, lunghezza);
+            i += lunghezza;
+            ancora = i;
+        }
+    }
+    // l'ultimo comando contiene solo letterali
+    scriviSequenza(out, dati + ancora, n - ancora, 0, 0);
+    return out;
+}
+
+
+// Decomprime un blocco scritto da compressBlock
+std::string decompressBlock(const char* dati, size_t n, size_t dimOriginale) {
+    std::string out;
+    out.resize(dimOriginale);
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(dati);
+    const unsigned char* fine = p + n;
+    size_t pos = 0;
+    while (p < fine) {
+        unsigned char comando = *p++;
+        size_t nLetterali = comando >> 4;
+        if (nLetterali == 15) {
+            nLetterali += leggiLunghezza(p, fine);
+        }
+        if (nLetterali > static_cast<size_t>(fine - p) || nLetterali > dimOriginale - pos) {
+            throw std::runtime_error("Blocco compresso danneggiato");
+        }
+        std::memcpy(&out[pos], p, nLetterali);
+        p += nLetterali;
+        pos += nLetterali;
+        if (p == fine) {
+            break; // ultimo comando: solo letterali
+        }
+
+        if (fine - p < 2) {
+            throw std::runtime_error("Blocco compresso danneggiato");
+        }
+        size_t distanza = p[0] | (size_t(p[1]) << 8);
+        p += 2;
+        size_t nCopia = comando & 0x0F;
+        if (nCopia == 15) {
+            nCopia += leggiLunghezza(p, fine);
+        }
+        nCopia += MIN_COPIA;
+        if (distanza == 0 || distanza > pos || nCopia > dimOriginale - pos) {
+            throw std::runtime_error("Blocco compresso danneggiato");
+        }
+        // la copia può sovrapporsi ai byte che sta scrivendo, quindi si procede byte per byte
+        size_t da = pos - distanza;
+        for (size_t k = 0; k < nCopia; ++k) {
+            out[pos + k] = out[da + k];
+        }
+        pos += nCopia;
+    }
+    if (pos != dimOriginale) {
+        throw std::runtime_error("Blocco compresso danneggiato");
+    }
+    return out;
+}
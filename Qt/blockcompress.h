@@ -0,0 +1,43 @@
+/**
+ * @file blockcompress.h
+ *
+ * @brief File header delle funzioni di compressione a blocchi
+ *
+ * File di dichiarazioni delle funzioni che comprimono e decomprimono un blocco di byte
+ * con un algoritmo della famiglia LZ77, usate dagli snapshot del catalogo.
+ */
+
+#ifndef BLOCKCOMPRESS_H
+#define BLOCKCOMPRESS_H
+
+#include <string>
+
+/**
+ * @brief Comprime un blocco di byte.
+ *
+ * Il blocco compresso usa lo stesso schema del formato a blocchi di LZ4: una sequenza di
+ * comandi, ognuno con dei byte letterali seguiti da una copia di byte già decompressi
+ * (distanza fino a 65535 byte, lunghezza minima 4). La compressione cerca le ripetizioni
+ * con una tabella hash di sequenze di 4 byte, quindi costa un tempo lineare.
+ *
+ * @param dati puntatore ai byte da comprimere
+ * @param n il numero di byte
+ *
+ * @return il blocco compresso
+ */
+std::string compressBlock(const char* dati, size_t n);
+
+/**
+ * @brief Decomprime un blocco scritto da compressBlock.
+ *
+ * @param dati puntatore al blocco compresso
+ * @param n la dimensione del blocco compresso
+ * @param dimOriginale la dimensione del blocco decompresso
+ *
+ * @return i byte decompressi
+ *
+ * @throw std::runtime_error se il blocco è danneggiato
+ */
+std::string decompressBlock(const char* dati, size_t n, size_t dimOriginale);
+
+#endif // BLOCKCOMPRESS_H
@@ -0,0 +1,410 @@
+#include "catalog.h"
+#include "catalogquery.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// Controlla se un carattere è uno spazio (come QByteArray::trimmed)
+bool spazio(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+// Ritorna il valore senza spazi iniziali e finali
+std::string senzaSpazi(const std::string& s) {
+    size_t inizio = 0, fine = s.size();
+    while (inizio < fine && spazio(s[inizio])) ++inizio;
+    while (fine > inizio && spazio(s[fine - 1])) --fine;
+    return s.substr(inizio, fine - inizio);
+}
+
+} // namespace
+
+
+// Costruttore
+Catalog::Catalog(Tracer* traccia) : traccia(traccia), versioni(1), corrente(0), prossimoId(0) {
+}
+
+
+// Divide una riga CSV nei suoi valori; le virgolette non fanno parte dei valori
+std::vector<std::string> Catalog::parseCsvLine(const char* riga, size_t n) {
+    std::vector<std::string> result;
+    bool inQuotes = false;
+    std::string current;
+
+    for (size_t i = 0; i < n; ++i) {
+        if (riga[i] == '"') {
+            inQuotes = !inQuotes;
+        } else if (riga[i] == ',' && !inQuotes) {
+            result.push_back(senzaSpazi(current));
+            current.clear();
+        } else {
+            current += riga[i];
+        }
+    }
+    if (!current.empty()) {
+        result.push_back(senzaSpazi(current));
+    }
+    return result;
+}
+
+
+// Carica il catalogo da un file CSV
+void Catalog::loadCsv(const std::string& percorso) {
+    std::string dati;
+    {
+        Tracer::Scope misura(traccia, "lettura CSV", "avvio");
+        std::FILE* in = std::fopen(percorso.c_str(), "rb");
+        if (in == nullptr) {
+            throw std::runtime_error("Impossibile aprire il file " + percorso);
+        }
+        char blocco[1 << 16];
+        size_t letti;
+        while ((letti = std::fread(blocco, 1, sizeof(blocco), in)) > 0) {
+            dati.append(blocco, letti);
+        }
+        std::fclose(in);
+    }
+    loadCsvData(dati);
+}
+
+
+// Carica il catalogo dal contenuto di un file CSV
+void Catalog::loadCsvData(const std::string& dati) {
+    // valori di ogni riga del file, convertiti poi negli id dei dizionari di colonna
+    std::vector<std::vector<std::string>> valoriRighe;
+    {
+        Tracer::Scope misura(traccia, "analisi CSV", "avvio");
+        size_t inizio = dati.find('\n');
+        // la prima riga contiene i titoli delle colonne
+        inizio = (inizio == std::string::npos) ? dati.size() : inizio + 1;
+        while (inizio < dati.size()) {
+            size_t fine = dati.find('\n', inizio);
+            if (fine == std::string::npos) {
+                fine = dati.size();
+            }
+            std::vector<std::string> valori = parseCsvLine(dati.data() + inizio, fine - inizio);
+            if (!valori.empty()) {
+                valoriRighe.push_back(std::move(valori));
+            }
+            inizio = fine + 1;
+        }
+    }
+
+    std::vector<RigaCatalogo> lette;
+    {
+        Tracer::Scope misura(traccia, "costruzione righe", "avvio");
+        // ogni valore distinto viene conservato una sola volta: la riga diventa una tupla di id
+        lette.reserve(valoriRighe.size());
+        for (const std::vector<std::string>& valori : valoriRighe) {
+            lette.push_back(dizionario.intern(valori));
+        }
+    }
+    loadRows(lette);
+}
+
+
+// Sostituisce le righe iniziali e correnti: le righe diventano la prima versione
+void Catalog::loadRows(const std::vector<RigaCatalogo>& nuove) {
+    std::vector<RigaStabile> stabili(nuove.size());
+    for (int i = 0; i < static_cast<int>(nuove.size()); ++i) {
+        stabili[i].id = i;
+        stabili[i].riga = nuove[i];
+    }
+    versioni.assign(1, Versione{PersistentRows(stabili), Differenza()});
+    corrente = 0;
+    prossimoId = static_cast<int>(nuove.size());
+    ricostruisciIndici();
+}
+
+
+// Sostituisce le righe correnti con una nuova versione e ricostruisce gli indici
+void Catalog::setRows(const std::vector<RigaCatalogo>& nuove) {
+    // le righe ricevono id nuovi: un id stabile indica sempre la stessa riga in tutte le versioni
+    Differenza modifica;
+    versioni[corrente].righe.forEach([&modifica](const RigaStabile& r) { modifica.rimosse.push_back(r.id); });
+    std::vector<RigaStabile> stabili(nuove.size());
+    for (size_t i = 0; i < nuove.size(); ++i) {
+        stabili[i].id = prossimoId++;
+        stabili[i].riga = nuove[i];
+        modifica.aggiunte.push_back(stabili[i].id);
+    }
+    nuovaVersione(PersistentRows(stabili), std::move(modifica));
+    ricostruisciIndici();
+}
+
+
+// Riporta le righe correnti a quelle iniziali, aggiornando gli indici solo per le righe cambiate
+void Catalog::reset() {
+    Differenza modifica = diff(corrente, 0);
+    if (modifica.aggiunte.empty() && modifica.rimosse.empty()) {
+        return;
+    }
+    for (int id : modifica.rimosse) {
+        deindicizza(id, versioni[corrente].righe.find(id)->riga);
+    }
+    for (int id : modifica.aggiunte) {
+        indicizza(id, versioni[0].righe.find(id)->riga);
+    }
+    PersistentRows iniziali = versioni[0].righe;
+    nuovaVersione(iniziali, std::move(modifica));
+}
+
+
+// Torna alla versione precedente
+bool Catalog::undo() {
+    if (!canUndo()) {
+        return false;
+    }
+    vaiA(corrente - 1);
+    return true;
+}
+
+
+// Ripristina la versione annullata da undo
+bool Catalog::redo() {
+    if (!canRedo()) {
+        return false;
+    }
+    vaiA(corrente + 1);
+    return true;
+}
+
+
+// Controlla se c'è una versione precedente
+bool Catalog::canUndo() const {
+    return corrente > 0;
+}
+
+
+// Controlla se c'è una versione da ripristinare
+bool Catalog::canRedo() const {
+    return corrente + 1 < versioni.size();
+}
+
+
+// Ritorna il numero della versione corrente
+size_t Catalog::version() const {
+    return corrente;
+}
+
+
+// Ritorna il numero di versioni conservate
+size_t Catalog::versionCount() const {
+    return versioni.size();
+}
+
+
+// Ritorna le righe di una versione
+const PersistentRows& Catalog::versionRows(size_t versione) const {
+    return versioni.at(versione).righe;
+}
+
+
+// Compone le differenze delle versioni tra da e a: ogni id ha un saldo di +1
+// (aggiunto), -1 (rimosso) o 0 (aggiunto e poi rimosso, o viceversa)
+Catalog::Differenza Catalog::diff(size_t da, size_t a) const {
+    if (da >= versioni.size() || a >= versioni.size()) {
+        throw std::out_of_range("Versione del catalogo non valida");
+    }
+    std::unordered_map<int, int> saldo;
+    if (da < a) {
+        for (size_t v = da + 1; v <= a; ++v) {
+            for (int id : versioni[v].modifica.aggiunte) ++saldo[id];
+            for (int id : versioni[v].modifica.rimosse) --saldo[id];
+        }
+    } else {
+        // all'indietro le modifiche si applicano al contrario
+        for (size_t v = da; v > a; --v) {
+            for (int id : versioni[v].modifica.aggiunte) --saldo[id];
+            for (int id : versioni[v].modifica.rimosse) ++saldo[id];
+        }
+    }
+    Differenza result;
+    for (const std::pair<const int, int>& s : saldo) {
+        if (s.second > 0) {
+            result.aggiunte.push_back(s.first);
+        } else if (s.second < 0) {
+            result.rimosse.push_back(s.first);
+        }
+    }
+    std::sort(result.aggiunte.begin(), result.aggiunte.end());
+    std::sort(result.rimosse.begin(), result.rimosse.end());
+    return result;
+}
+
+
+// Aggiunge una versione dopo quella corrente, scartando quelle annullate
+void Catalog::nuovaVersione(const PersistentRows& righe, Differenza modifica) {
+    versioni.resize(corrente + 1);
+    versioni.push_back(Versione{righe, std::move(modifica)});
+    ++corrente;
+}
+
+
+// Passa a un'altra versione aggiornando gli indici solo per le righe che cambiano
+void Catalog::vaiA(size_t versione) {
+    Differenza modifica = diff(corrente, versione);
+    for (int id : modifica.rimosse) {
+        deindicizza(id, versioni[corrente].righe.find(id)->riga);
+    }
+    for (int id : modifica.aggiunte) {
+        indicizza(id, versioni[versione].righe.find(id)->riga);
+    }
+    corrente = versione;
+}
+
+
+// Ricostruisce gli indici dalle righe della versione corrente
+void Catalog::ricostruisciIndici() {
+    Tracer::Scope misura(traccia, "indicizzazione", "avvio");
+    indiceRicerca.clear();
+    conteggi.clear();
+    indiceDate.clear();
+    versioni[corrente].righe.forEach([this](const RigaStabile& r) { indicizza(r.id, r.riga); });
+    // i termini si ordinano subito, altrimenti la prima ricerca ne pagherebbe l'ordinamento
+    indiceRicerca.prepare();
+}
+
+
+// Aggiunge una riga agli indici con l'id stabile indicato; una riga tolta
+// in precedenza viene riattivata senza duplicarla negli indici
+void Catalog::indicizza(int id, const RigaCatalogo& riga) {
+    std::vector<std::string> valori = dizionario.values(riga);
+    indiceRicerca.addRow(id, valori); // la riga viene indicizzata per la ricerca
+    conteggi.add(riga); // si aggiornano i conteggi per colonna usati dai grafici
+    indiceDate.addRow(id, valori[3]); // la data viene interpretata come intervallo di anni
+}
+
+
+// Toglie una riga dagli indici
+void Catalog::deindicizza(int id, const RigaCatalogo& riga) {
+    indiceRicerca.removeRow(id);
+    conteggi.remove(riga);
+    indiceDate.removeRow(id);
+}
+
+
+// Aggiunge un dipinto in fondo al catalogo: ha l'id più grande, quindi va in fondo
+int Catalog::add(const std::vector<std::string>& valori) {
+    RigaStabile nuova;
+    nuova.id = prossimoId++;
+    nuova.riga = dizionario.intern(valori);
+    Differenza modifica;
+    modifica.aggiunte.push_back(nuova.id);
+    nuovaVersione(versioni[corrente].righe.insert(nuova), std::move(modifica));
+    indicizza(nuova.id, nuova.riga);
+    return size() - 1;
+}
+
+
+// Elimina la riga in una posizione
+void Catalog::remove(int posizione) {
+    RigaStabile eliminata = versioni[corrente].righe.at(posizione);
+    Differenza modifica;
+    modifica.rimosse.push_back(eliminata.id);
+    nuovaVersione(versioni[corrente].righe.erase(eliminata.id), std::move(modifica));
+    deindicizza(eliminata.id, eliminata.riga);
+}
+
+
+// Cerca nella colonna indicata oppure esegue un'interrogazione con più predicati
+std::vector<int> Catalog::search(const std::string& testo, int colonna, size_t limite) const {
+    if (CatalogQuery::isQuery(testo)) {
+        std::vector<int> result = CatalogQuery::parse(testo).run(indiceRicerca, &indiceDate);
+        if (limite > 0 && result.size() > limite) {
+            result.resize(limite);
+        }
+        return result;
+    }
+
+    // corrispondenze esatte, per prefisso, per sottostringa e approssimate
+    std::vector<int> result;
+    for (const SearchIndex::Risultato& r : indiceRicerca.search(testo, colonna, limite)) {
+        result.push_back(r.riga);
+    }
+    return result;
+}
+
+
+// Conta le righe per ogni valore di una colonna
+std::vector<std::pair<std::string, int>> Catalog::counts(int colonna) const {
+    if (colonna < 0 || colonna >= COLONNE_CATALOGO) {
+        return std::vector<std::pair<std::string, int>>();
+    }
+    return conteggi.sorted(colonna, dizionario.column(colonna));
+}
+
+
+// Calcola la percentuale di righe per ogni valore di una colonna
+std::vector<std::pair<std::string, double>> Catalog::percentages(int colonna) const {
+    std::vector<std::pair<std::string, double>> result;
+    int totale = conteggi.total();
+    for (const std::pair<std::string, int>& c : counts(colonna)) {
+        result.push_back(std::make_pair(c.first, totale > 0 ? static_cast<double>(c.second) / totale * 100.0 : 0.0));
+    }
+    return result;
+}
+
+
+// Conta le righe per periodi di anni
+std::vector<std::pair<int, int>> Catalog::histogram(int ampiezza) const {
+    return indiceDate.histogram(ampiezza);
+}
+
+
+// Ritorna il numero di righe con una data non interpretabile
+int Catalog::undatedCount() const {
+    return indiceDate.undatedCount();
+}
+
+
+// Ritorna il numero di righe correnti
+int Catalog::size() const {
+    return versioni[corrente].righe.size();
+}
+
+
+// Ritorna la riga in una posizione
+const RigaCatalogo& Catalog::row(int posizione) const {
+    return versioni[corrente].righe.at(posizione).riga;
+}
+
+
+// Ritorna una copia delle righe correnti
+std::vector<RigaCatalogo> Catalog::rows() const {
+    return versioni[corrente].righe.rows();
+}
+
+
+// Ritorna una copia delle righe iniziali
+std::vector<RigaCatalogo> Catalog::originalRows() const {
+    return versioni[0].righe.rows();
+}
+
+
+// Ritorna l'id stabile della riga in una posizione
+int Catalog::rowId(int posizione) const {
+    return versioni[corrente].righe.at(posizione).id;
+}
+
+
+// Ritorna la posizione della riga con un id stabile
+int Catalog::position(int id) const {
+    return versioni[corrente].righe.position(id);
+}
+
+
+// Ritorna i dizionari dei valori delle colonne
+CatalogDictionary& Catalog::dictionary() {
+    return dizionario;
+}
+
+
+// Ritorna i dizionari dei valori delle colonne
+const CatalogDictionary& Catalog::dictionary() const {
+    return dizionario;
+}
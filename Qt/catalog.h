@@ -0,0 +1,348 @@
+/**
+ * @file catalog.h
+ *
+ * @brief File header della classe Catalog
+ *
+ * File di dichiarazioni della classe Catalog, che raccoglie i dati del catalogo dei
+ * dipinti e i loro indici senza dipendere da Qt: la usano sia la finestra principale
+ * sia lo strumento da riga di comando.
+ */
+
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include "stringpool.h"
+#include "persistentrows.h"
+#include "searchindex.h"
+#include "columncounts.h"
+#include "dateindex.h"
+#include "tracer.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Catalogo dei dipinti con i suoi indici.
+ *
+ * Le righe sono tuple di id dei dizionari di colonna (RigaCatalogo) in ordine di
+ * posizione; ad ogni riga corrisponde anche un id stabile, usato dagli indici di
+ * ricerca e delle date, che non cambia quando vengono eliminate altre righe.
+ *
+ * Ogni modifica crea una nuova versione delle righe (PersistentRows) che condivide
+ * con la precedente tutti i nodi non toccati, insieme alla differenza tra le due
+ * (id aggiunti e rimossi). La prima versione sono le righe iniziali (lette dal file
+ * CSV o da uno snapshot): reset, undo e redo passano da una versione all'altra
+ * aggiornando gli indici solo per le righe che cambiano, senza ricostruirli e senza
+ * tenere una seconda copia del catalogo.
+ *
+ * Se viene indicato un Tracer, il caricamento misura separatamente lettura,
+ * analisi, costruzione delle righe e indicizzazione.
+ */
+class Catalog {
+public:
+    /**
+     * @brief Differenza tra due versioni delle righe.
+     */
+    struct Differenza {
+        std::vector<int> aggiunte; ///< id stabili delle righe aggiunte, in ordine crescente
+        std::vector<int> rimosse;  ///< id stabili delle righe rimosse, in ordine crescente
+    };
+
+    /**
+     * @brief Costruttore.
+     *
+     * @param traccia il tracer in cui misurare il caricamento (opzionale)
+     */
+    explicit Catalog(Tracer* traccia = nullptr);
+
+    /**
+     * @brief Divide una riga di un file CSV nei suoi valori.
+     *
+     * Le virgolette delimitano i valori che contengono virgole e non fanno parte
+     * del valore; gli spazi iniziali e finali di ogni valore vengono tolti.
+     *
+     * @param riga il testo della riga
+     * @param n la lunghezza della riga in byte
+     *
+     * @return i valori della riga
+     */
+    static std::vector<std::string> parseCsvLine(const char* riga, size_t n);
+
+    /**
+     * @brief Carica il catalogo da un file CSV con una riga di intestazione.
+     *
+     * Le righe lette diventano sia le righe correnti sia le righe iniziali.
+     * Le righe vuote vengono ignorate.
+     *
+     * @param percorso il file CSV
+     *
+     * @throw std::runtime_error se il file non si può aprire
+     */
+    void loadCsv(const std::string& percorso);
+
+    /**
+     * @brief Carica il catalogo dal contenuto di un file CSV con una riga di intestazione.
+     *
+     * @param dati il contenuto del file
+     */
+    void loadCsvData(const std::string& dati);
+
+    /**
+     * @brief Sostituisce le righe iniziali e correnti e ricostruisce gli indici.
+     *
+     * Le righe ricevono gli id stabili 0..n-1 e diventano l'unica versione: la
+     * cronologia precedente viene scartata.
+     *
+     * @param righe le nuove righe, con id dei dizionari di questo catalogo
+     */
+    void loadRows(const std::vector<RigaCatalogo>& righe);
+
+    /**
+     * @brief Sostituisce le righe correnti con una nuova versione, lasciando invariate quelle iniziali.
+     *
+     * Le righe ricevono nuovi id stabili e gli indici vengono ricostruiti.
+     *
+     * @param righe le nuove righe, con id dei dizionari di questo catalogo
+     */
+    void setRows(const std::vector<RigaCatalogo>& righe);
+
+    /**
+     * @brief Riporta le righe correnti a quelle iniziali, con una nuova versione.
+     *
+     * Costa quanto le modifiche fatte dalle righe iniziali, e si può annullare con undo.
+     */
+    void reset();
+
+    /**
+     * @brief Torna alla versione precedente.
+     *
+     * @return false se la versione corrente è la prima
+     */
+    bool undo();
+
+    /**
+     * @brief Ripristina la versione annullata da undo.
+     *
+     * Una modifica fatta dopo undo scarta le versioni che si potevano ripristinare.
+     *
+     * @return false se non ci sono versioni da ripristinare
+     */
+    bool redo();
+
+    /**
+     * @brief Controlla se c'è una versione precedente.
+     *
+     * @return true o false
+     */
+    bool canUndo() const;
+
+    /**
+     * @brief Controlla se c'è una versione da ripristinare.
+     *
+     * @return true o false
+     */
+    bool canRedo() const;
+
+    /**
+     * @brief Ritorna il numero della versione corrente (0 = righe iniziali).
+     *
+     * @return il numero della versione
+     */
+    size_t version() const;
+
+    /**
+     * @brief Ritorna il numero di versioni conservate.
+     *
+     * @return il numero di versioni
+     */
+    size_t versionCount() const;
+
+    /**
+     * @brief Ritorna le righe di una versione.
+     *
+     * @param versione il numero della versione
+     *
+     * @return le righe, con i loro id stabili
+     *
+     * @throw std::out_of_range se la versione non esiste
+     */
+    const PersistentRows& versionRows(size_t versione) const;
+
+    /**
+     * @brief Calcola le righe che cambiano passando da una versione a un'altra.
+     *
+     * Compone le differenze delle versioni intermedie, quindi costa quanto le
+     * modifiche fatte tra le due versioni e non quanto il catalogo.
+     *
+     * @param da la versione di partenza
+     * @param a la versione di arrivo
+     *
+     * @return gli id delle righe presenti solo in a (aggiunte) e solo in da (rimosse)
+     *
+     * @throw std::out_of_range se una delle versioni non esiste
+     */
+    Differenza diff(size_t da, size_t a) const;
+
+    /**
+     * @brief Aggiunge un dipinto in fondo al catalogo.
+     *
+     * @param valori i cinque valori del dipinto (scuola, autore, titolo, data, sala)
+     *
+     * @return la posizione della nuova riga
+     */
+    int add(const std::vector<std::string>& valori);
+
+    /**
+     * @brief Elimina la riga in una posizione.
+     *
+     * @param posizione la posizione della riga
+     *
+     * @throw std::out_of_range se la posizione non è valida
+     */
+    void remove(int posizione);
+
+    /**
+     * @brief Cerca nel catalogo.
+     *
+     * Se il testo ha la forma "colonna operatore valore AND ..." viene eseguito come
+     * interrogazione con più predicati (CatalogQuery); altrimenti si cercano
+     * corrispondenze esatte, per prefisso, per sottostringa e approssimate nella colonna.
+     *
+     * @param testo il testo cercato
+     * @param colonna la colonna in cui cercare, oppure -1 per tutte
+     * @param limite il numero massimo di righe (0 = nessun limite): con un limite si
+     *        classificano solo le corrispondenze necessarie, come nella ricerca durante la digitazione
+     *
+     * @return gli id stabili delle righe trovate, in ordine di rilevanza
+     *
+     * @throw std::invalid_argument se il testo è un'interrogazione non valida
+     */
+    std::vector<int> search(const std::string& testo, int colonna = -1, size_t limite = 0) const;
+
+    /**
+     * @brief Conta le righe per ogni valore di una colonna.
+     *
+     * @param colonna la colonna
+     *
+     * @return le coppie (valore, numero di righe) in ordine di valore
+     */
+    std::vector<std::pair<std::string, int>> counts(int colonna) const;
+
+    /**
+     * @brief Calcola la percentuale di righe per ogni valore di una colonna.
+     *
+     * @param colonna la colonna (ad esempio 0 per la scuola)
+     *
+     * @return le coppie (valore, percentuale) in ordine di valore
+     */
+    std::vector<std::pair<std::string, double>> percentages(int colonna) const;
+
+    /**
+     * @brief Conta le righe per periodi di anni della colonna Data.
+     *
+     * @param ampiezza l'ampiezza dei periodi in anni (10 = decenni)
+     *
+     * @return le coppie (primo anno del periodo, numero di righe) in ordine di anno
+     */
+    std::vector<std::pair<int, int>> histogram(int ampiezza) const;
+
+    /**
+     * @brief Ritorna il numero di righe con una data non interpretabile.
+     *
+     * @return il numero di righe senza data
+     */
+    int undatedCount() const;
+
+    /**
+     * @brief Ritorna il numero di righe correnti.
+     *
+     * @return il numero di righe
+     */
+    int size() const;
+
+    /**
+     * @brief Ritorna la riga in una posizione.
+     *
+     * @param posizione la posizione della riga
+     *
+     * @return la riga
+     *
+     * @throw std::out_of_range se la posizione non è valida
+     */
+    const RigaCatalogo& row(int posizione) const;
+
+    /**
+     * @brief Ritorna una copia delle righe correnti in ordine di posizione.
+     *
+     * @return le righe correnti
+     */
+    std::vector<RigaCatalogo> rows() const;
+
+    /**
+     * @brief Ritorna una copia delle righe iniziali.
+     *
+     * @return le righe iniziali
+     */
+    std::vector<RigaCatalogo> originalRows() const;
+
+    /**
+     * @brief Ritorna l'id stabile della riga in una posizione.
+     *
+     * @param posizione la posizione della riga
+     *
+     * @return l'id stabile
+     *
+     * @throw std::out_of_range se la posizione non è valida
+     */
+    int rowId(int posizione) const;
+
+    /**
+     * @brief Ritorna la posizione della riga con un id stabile.
+     *
+     * @param id l'id stabile
+     *
+     * @return la posizione, oppure -1 se la riga non è presente
+     */
+    int position(int id) const;
+
+    /**
+     * @brief Ritorna i dizionari dei valori delle colonne.
+     *
+     * @return i dizionari
+     */
+    CatalogDictionary& dictionary();
+
+    /**
+     * @brief Ritorna i dizionari dei valori delle colonne.
+     *
+     * @return i dizionari
+     */
+    const CatalogDictionary& dictionary() const;
+
+private:
+    /**
+     * @brief Versione delle righe, con la differenza rispetto alla precedente.
+     */
+    struct Versione {
+        PersistentRows righe; ///< righe della versione
+        Differenza modifica;  ///< righe aggiunte e rimosse rispetto alla versione precedente
+    };
+
+    void indicizza(int id, const RigaCatalogo& riga);
+    void deindicizza(int id, const RigaCatalogo& riga);
+    void ricostruisciIndici();
+    void nuovaVersione(const PersistentRows& righe, Differenza modifica);
+    void vaiA(size_t versione);
+
+    Tracer* traccia;                     ///< tracer del caricamento (può essere nullptr)
+    CatalogDictionary dizionario;        ///< dizionari dei valori distinti di ogni colonna
+    std::vector<Versione> versioni;      ///< versioni delle righe (la prima sono le righe iniziali)
+    size_t corrente;                     ///< numero della versione corrente
+    int prossimoId;                      ///< id stabile da assegnare alla prossima riga aggiunta
+    SearchIndex indiceRicerca;           ///< indice di ricerca sulle colonne
+    ColumnCounts conteggi;               ///< conteggi dei valori di ogni colonna
+    DateIndex indiceDate;                ///< intervalli di anni della colonna Data
+};
+
+#endif // CATALOG_H
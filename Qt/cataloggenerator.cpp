@@ -0,0 +1,224 @@
+#include "cataloggenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+
+// Scuole del catalogo reale, dalla più alla meno frequente
+const char* const SCUOLE[] = {
+    "fiorentina", "veneta", "olandese", "fiamminga", "emiliana", "tedesca", "francese",
+    "lombarda", "romana", "senese", "spagnola", "marchigiana", "urbinate", "umbra",
+    "ferrarese", "mantovana", "ligure", "siciliana", "napoletana", "lucchese", "forlivese",
+    "toscana", "bolognese", "genovese", "piemontese"
+};
+
+const char* const NOMI[] = {
+    "Giovanni", "Andrea", "Francesco", "Jacopo", "Domenico", "Antonio", "Pietro", "Bernardo",
+    "Lorenzo", "Filippo", "Agnolo", "Sandro", "Tiziano", "Paolo", "Alessandro", "Cristofano",
+    "Rosso", "Giorgio", "Ludovico", "Orazio", "Artemisia", "Rembrandt", "Lucas", "Hans",
+    "Albrecht", "Peter Paul", "Anton", "Jan", "Simone", "Gentile"
+};
+
+const char* const COGNOMI[] = {
+    "da San Giovanni", "del Sarto", "Vasari", "Bronzino", "Allori", "Lippi", "Botticelli",
+    "Ghirlandaio", "Vecellio", "Veronese", "Tintoretto", "Caliari", "Carracci", "Reni",
+    "Gentileschi", "van Rijn", "Cranach", "Holbein", "Durer", "Rubens", "van Dyck", "Brueghel",
+    "Martini", "da Fabriano", "Lorenzetti", "Pontormo", "Fiorentino", "Salviati", "Empoli",
+    "Cigoli", "Furini", "Dolci", "Sustermans", "Rosa", "Giordano"
+};
+
+const char* const SOGGETTI[] = {
+    "Ritratto di", "Madonna con il Bambino e", "Adorazione dei Magi con", "Annunciazione con",
+    "Sacra Famiglia con", "Natura morta con", "Paesaggio con", "Battaglia di", "Allegoria di",
+    "Nozze di", "Storie di", "Martirio di", "Deposizione con", "Trionfo di", "Veduta di"
+};
+
+const char* const PERSONAGGI[] = {
+    "san Giovannino", "santa Caterina", "Cosimo I de' Medici", "Eleonora di Toledo",
+    "Maria de' Medici", "Enrico IV di Francia", "Apollo e Marsia", "Venere", "Bacco",
+    "un gentiluomo", "una dama", "angeli musicanti", "fiori e frutta", "pastori", "Firenze"
+};
+
+const char* const SALE[] = {
+    "Tribuna", "Primo vestibolo d'entrata", "Anticamera della direzione", "Corridoio di Ponente",
+    "Corridoio di Levante", "Sala delle Carte Geografiche", "Sala della Niobe", "Terrazza dei Mappamondi"
+};
+
+const char* const ROMANI[] = {"XIII", "XIV", "XV", "XVI", "XVII", "XVIII"};
+
+template <typename T, size_t N>
+size_t numero(const T (&)[N]) {
+    return N;
+}
+
+// Aggiunge un valore al CSV, tra virgolette se contiene una virgola
+void campo(std::string& out, const std::string& valore) {
+    if (valore.find(',') != std::string::npos) {
+        out += '"';
+        out += valore;
+        out += '"';
+    } else {
+        out += valore;
+    }
+}
+
+} // namespace
+
+
+// Prepara le probabilità cumulate della distribuzione di Zipf su n ranghi
+CatalogGenerator::Zipf::Zipf(size_t n, double esponente) {
+    cumulata.resize(n);
+    double somma = 0;
+    for (size_t k = 0; k < n; ++k) {
+        somma += 1.0 / std::pow(static_cast<double>(k + 1), esponente);
+        cumulata[k] = somma;
+    }
+    for (double& c : cumulata) {
+        c /= somma;
+    }
+}
+
+
+// Estrae un rango con una ricerca binaria sulla probabilità cumulata
+size_t CatalogGenerator::Zipf::operator()(std::mt19937_64& rng) const {
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    size_t k = std::lower_bound(cumulata.begin(), cumulata.end(), u) - cumulata.begin();
+    return std::min(k, cumulata.size() - 1);
+}
+
+
+// Costruttore
+CatalogGenerator::CatalogGenerator(uint64_t seme)
+    : rng(seme), seme(seme), numAutori(0), numSale(0), numTitoli(0) {
+}
+
+
+// Sceglie il numero di valori distinti in base alla dimensione del catalogo
+void CatalogGenerator::prepara(size_t righe) {
+    rng.seed(seme);
+    // nel catalogo reale ci sono circa 8 dipinti per autore e 11 per sala
+    numAutori = std::max<size_t>(50, righe / 8);
+    numSale = std::max<size_t>(20, righe / 12);
+    numTitoli = std::max<size_t>(100, righe / 2);
+    distribuzioni.clear();
+    distribuzioni.emplace_back(numero(SCUOLE), 1.2);
+    distribuzioni.emplace_back(numAutori, 1.0);
+    distribuzioni.emplace_back(numSale, 0.9);
+}
+
+
+// Nome dell'autore con un certo rango; circa un autore su cinque ha la forma "Cognome, Nome"
+std::string CatalogGenerator::nomeAutore(size_t rango) const {
+    size_t nomi = numero(NOMI), cognomi = numero(COGNOMI);
+    std::string nome = NOMI[rango % nomi];
+    std::string cognome = COGNOMI[(rango / nomi) % cognomi];
+    // oltre le combinazioni dei nomi si distinguono gli autori con un numero (bottega, seguace, ...)
+    size_t variante = rango / (nomi * cognomi);
+    if (variante > 0) {
+        cognome += " " + std::to_string(variante + 1);
+    }
+    if (rango % 5 == 3) {
+        return cognome + ", " + nome;
+    }
+    return nome + " " + cognome;
+}
+
+
+// Nome della sala con un certo rango: le prime hanno un nome, le altre "numero - autore"
+std::string CatalogGenerator::nomeSala(size_t rango) const {
+    if (rango < numero(SALE)) {
+        return SALE[rango];
+    }
+    return std::to_string(rango - numero(SALE) + 1) + " - " + COGNOMI[rango % numero(COGNOMI)];
+}
+
+
+// Data con le grafie del catalogo reale
+std::string CatalogGenerator::data() {
+    int anno = std::uniform_int_distribution<int>(1250, 1790)(rng);
+    int tipo = std::uniform_int_distribution<int>(0, 99)(rng);
+    int durata = std::uniform_int_distribution<int>(1, 30)(rng);
+    char testo[48];
+    if (tipo < 35) {
+        std::snprintf(testo, sizeof(testo), "%d", anno);
+    } else if (tipo < 55) {
+        std::snprintf(testo, sizeof(testo), "%d circa", anno);
+    } else if (tipo < 75) {
+        std::snprintf(testo, sizeof(testo), "%d-%d", anno, anno + durata);
+    } else if (tipo < 85) {
+        std::snprintf(testo, sizeof(testo), "%d-%d circa", anno, anno + durata);
+    } else if (tipo < 90) {
+        std::snprintf(testo, sizeof(testo), "%d-%02d", anno, (anno + durata % 9 + 1) % 100);
+    } else if (tipo < 94) {
+        std::snprintf(testo, sizeof(testo), "%d (ante)", anno);
+    } else if (tipo < 97) {
+        std::snprintf(testo, sizeof(testo), "post %d", anno);
+    } else if (tipo < 99) {
+        std::snprintf(testo, sizeof(testo), "%s secolo", ROMANI[(anno - 1201) / 100]);
+    } else {
+        return "";
+    }
+    return testo;
+}
+
+
+// Aggiunge una riga al CSV
+void CatalogGenerator::aggiungiRiga(std::string& out) {
+    campo(out, SCUOLE[distribuzioni[0](rng)]);
+    out += ',';
+    campo(out, nomeAutore(distribuzioni[1](rng)));
+    out += ',';
+    size_t titolo = std::uniform_int_distribution<size_t>(0, numTitoli - 1)(rng);
+    std::string testo = std::string(SOGGETTI[titolo % numero(SOGGETTI)]) + " "
+                      + PERSONAGGI[(titolo / numero(SOGGETTI)) % numero(PERSONAGGI)];
+    size_t variante = titolo / (numero(SOGGETTI) * numero(PERSONAGGI));
+    if (variante > 0) {
+        testo += " " + std::to_string(variante);
+    }
+    campo(out, testo);
+    out += ',';
+    campo(out, data());
+    out += ',';
+    campo(out, nomeSala(distribuzioni[2](rng)));
+    out += '\n';
+}
+
+
+// Genera un catalogo in formato CSV
+std::string CatalogGenerator::generate(size_t righe) {
+    prepara(righe);
+    std::string out = "Scuola,Autore,Soggetto/Titolo,Data,Sala\n";
+    out.reserve(out.size() + righe * 90);
+    for (size_t i = 0; i < righe; ++i) {
+        aggiungiRiga(out);
+    }
+    return out;
+}
+
+
+// Scrive un catalogo sintetico in un file, un blocco di righe alla volta
+void CatalogGenerator::write(const std::string& percorso, size_t righe) {
+    std::FILE* f = std::fopen(percorso.c_str(), "wb");
+    if (f == nullptr) {
+        throw std::runtime_error("Impossibile scrivere il file " + percorso);
+    }
+    prepara(righe);
+    std::string blocco = "Scuola,Autore,Soggetto/Titolo,Data,Sala\n";
+    bool ok = true;
+    for (size_t i = 0; i < righe && ok; ++i) {
+        aggiungiRiga(blocco);
+        if (blocco.size() >= (1 << 20) || i + 1 == righe) {
+            ok = std::fwrite(blocco.data(), 1, blocco.size(), f) == blocco.size();
+            blocco.clear();
+        }
+    }
+    if (righe == 0) {
+        ok = std::fwrite(blocco.data(), 1, blocco.size(), f) == blocco.size();
+    }
+    if (std::fclose(f) != 0 || !ok) {
+        throw std::runtime_error("Errore durante la scrittura del file " + percorso);
+    }
+}
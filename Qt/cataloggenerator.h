@@ -0,0 +1,86 @@
+/**
+ * @file cataloggenerator.h
+ *
+ * @brief File header della classe CatalogGenerator
+ *
+ * File di dichiarazioni della classe CatalogGenerator, che produce cataloghi sintetici
+ * con lo stesso schema di dipinti_uffizi.csv per misurare il motore del catalogo su
+ * dimensioni molto maggiori di quelle reali.
+ */
+
+#ifndef CATALOGGENERATOR_H
+#define CATALOGGENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Generatore di cataloghi sintetici.
+ *
+ * Le righe hanno le cinque colonne del catalogo (Scuola, Autore, Soggetto/Titolo,
+ * Data, Sala). Scuole, autori e sale seguono una distribuzione di Zipf, come nel
+ * catalogo reale, dove poche scuole e pochi autori coprono la maggior parte dei
+ * dipinti; il numero di autori e di sale distinti cresce con il numero di righe.
+ * Una parte degli autori ha la forma "Cognome, Nome" e viene scritta tra virgolette
+ * (come "Empoli, L'"); le date usano le grafie del catalogo reale ("1600-1630 circa",
+ * "1338 (ante)", "XV secolo", ...).
+ *
+ * A parità di seme e di numero di righe il catalogo generato è sempre lo stesso.
+ */
+class CatalogGenerator {
+public:
+    /**
+     * @brief Costruttore.
+     *
+     * @param seme il seme del generatore di numeri casuali
+     */
+    explicit CatalogGenerator(uint64_t seme = 1);
+
+    /**
+     * @brief Genera un catalogo in formato CSV, con la riga di intestazione.
+     *
+     * @param righe il numero di dipinti
+     *
+     * @return il contenuto del file CSV
+     */
+    std::string generate(size_t righe);
+
+    /**
+     * @brief Scrive un catalogo sintetico in un file CSV, a blocchi.
+     *
+     * @param percorso il file da scrivere
+     * @param righe il numero di dipinti
+     *
+     * @throw std::runtime_error se il file non si può scrivere
+     */
+    void write(const std::string& percorso, size_t righe);
+
+private:
+    /**
+     * @brief Estrazione di un rango con distribuzione di Zipf (rango 0 il più frequente).
+     */
+    class Zipf {
+    public:
+        Zipf(size_t n, double esponente);
+        size_t operator()(std::mt19937_64& rng) const;
+    private:
+        std::vector<double> cumulata; ///< probabilità cumulata dei ranghi
+    };
+
+    void prepara(size_t righe);
+    void aggiungiRiga(std::string& out);
+    std::string nomeAutore(size_t rango) const;
+    std::string nomeSala(size_t rango) const;
+    std::string data();
+
+    std::mt19937_64 rng;
+    uint64_t seme;
+    std::vector<Zipf> distribuzioni; ///< scuole, autori e sale, nell'ordine
+    size_t numAutori;
+    size_t numSale;
+    size_t numTitoli;
+};
+
+#endif // CATALOGGENERATOR_H
@@ -0,0 +1,285 @@
+#include "catalogjournal.h"
+#include "catalogsnapshot.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+// Costruttore della classe CatalogJournal
+CatalogJournal::CatalogJournal(const std::string& prefisso, uint64_t soglia)
+    : prefisso(prefisso), soglia(soglia), generazione(0), dimPrecedenti(0), inCorso(false) {}
+
+
+// Distruttore: scrive le modifiche in attesa e aspetta la fine della compattazione
+CatalogJournal::~CatalogJournal() {
+    if (compattazione.joinable()) {
+        compattazione.join();
+    }
+    log.reset();
+}
+
+
+// Nome del segmento del registro numero g
+std::string CatalogJournal::segmento(uint64_t g) const {
+    return prefisso + ".wal." + std::to_string(g);
+}
+
+
+// Nome del checkpoint numero g
+std::string CatalogJournal::checkpoint(uint64_t g) const {
+    return prefisso + ".checkpoint." + std::to_string(g);
+}
+
+
+// Numeri dei file "prefisso.tipo.N" presenti, in ordine crescente
+std::vector<uint64_t> CatalogJournal::generazioni(const std::string& tipo) const {
+    std::vector<uint64_t> result;
+    std::filesystem::path base(prefisso);
+    std::filesystem::path cartella = base.has_parent_path() ? base.parent_path() : std::filesystem::path(".");
+    std::string inizio = base.filename().string() + "." + tipo + ".";
+    std::error_code errore;
+    for (std::filesystem::directory_iterator it(cartella, errore), fine; !errore && it != fine; it.increment(errore)) {
+        std::string nome = it->path().filename().string();
+        if (nome.compare(0, inizio.size(), inizio) != 0 || nome.size() == inizio.size()) {
+            continue;
+        }
+        std::string numero = nome.substr(inizio.size());
+        if (numero.find_first_not_of("0123456789") == std::string::npos) {
+            result.push_back(std::stoull(numero));
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+
+// Elimina i segmenti e i checkpoint già compresi nel checkpoint numero g
+void CatalogJournal::eliminaPrecedenti(uint64_t g) const {
+    std::error_code errore;
+    for (uint64_t s : generazioni("wal")) {
+        if (s < g) std::filesystem::remove(segmento(s), errore);
+    }
+    for (uint64_t c : generazioni("checkpoint")) {
+        if (c < g) std::filesystem::remove(checkpoint(c), errore);
+    }
+}
+
+
+// Legge l'impronta delle righe iniziali del registro e il primo segmento che si riferisce
+// a loro; ritorna false se il file della base non esiste o non è leggibile
+bool CatalogJournal::leggiBase(uint64_t& impronta, uint64_t& inizio) const {
+    std::ifstream in(prefisso + ".base");
+    return static_cast<bool>(in >> impronta >> inizio);
+}
+
+
+// Scrive il file della base in un file temporaneo rinominato alla fine,
+// così un'interruzione lascia quello precedente intatto
+void CatalogJournal::scriviBase(uint64_t impronta, uint64_t inizio) const {
+    std::string percorso = prefisso + ".base";
+    std::string temp = percorso + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        if (!(out << impronta << ' ' << inizio << '\n') || !out.flush()) {
+            out.close();
+            std::remove(temp.c_str());
+            throw std::runtime_error("Impossibile scrivere la base del registro delle modifiche");
+        }
+    }
+    std::error_code errore;
+    std::filesystem::rename(temp, percorso, errore);
+    if (errore) {
+        std::remove(temp.c_str());
+        throw std::runtime_error("Impossibile scrivere la base del registro delle modifiche");
+    }
+}
+
+
+// Impronta (FNV-1a a 64 bit) dei valori delle righe: non dipende dagli id dei dizionari,
+// che cambiano da un avvio all'altro
+uint64_t CatalogJournal::improntaDi(const std::vector<RigaCatalogo>& righe, const CatalogDictionary& dizionario) {
+    uint64_t h = 14695981039346656037ull;
+    auto aggiungi = [&h](unsigned char c) {
+        h ^= c;
+        h *= 1099511628211ull;
+    };
+    for (const RigaCatalogo& riga : righe) {
+        for (int c = 0; c < COLONNE_CATALOGO; ++c) {
+            for (char ch : dizionario.value(c, riga[c])) {
+                aggiungi(static_cast<unsigned char>(ch));
+            }
+            // separatori di colonna e di riga, che non compaiono nei valori del CSV
+            aggiungi(c + 1 < COLONNE_CATALOGO ? 0x1f : 0x1e);
+        }
+    }
+    return h;
+}
+
+
+// Ricostruisce le righe correnti e apre un nuovo segmento per le modifiche
+bool CatalogJournal::recover(CatalogDictionary& dizionario, const std::vector<RigaCatalogo>& originali,
+                             std::vector<RigaCatalogo>& righe) {
+    uint64_t impronta = improntaDi(originali, dizionario);
+    uint64_t salvata = 0;
+    uint64_t inizio = 0;
+    if (!leggiBase(salvata, inizio)) {
+        // registro nuovo, oppure scritto prima che si salvasse la base: si riferisce a queste righe
+        scriviBase(impronta, 0);
+    } else if (salvata != impronta) {
+        // il registro è stato scritto su altre righe iniziali: i file presenti non si rileggono
+        // e le modifiche ripartono da un numero successivo a tutti loro
+        std::vector<uint64_t> segmenti = generazioni("wal");
+        std::vector<uint64_t> checkpoints = generazioni("checkpoint");
+        inizio = std::max(segmenti.empty() ? 0 : segmenti.back() + 1,
+                          checkpoints.empty() ? 0 : checkpoints.back() + 1);
+        scriviBase(impronta, inizio);
+    }
+
+    bool modificate = false;
+    uint64_t base = inizio;
+    std::vector<uint64_t> checkpoints = generazioni("checkpoint");
+    righe = originali;
+    if (!checkpoints.empty() && checkpoints.back() >= inizio) {
+        // il checkpoint più recente comprende tutti i segmenti con numero minore
+        base = checkpoints.back();
+        righe.clear();
+        CatalogSnapshot(checkpoint(base)).readAll(dizionario, righe);
+        modificate = true;
+    }
+
+    dimPrecedenti = 0;
+    uint64_t prossimo = base;
+    for (uint64_t g : generazioni("wal")) {
+        if (g < base) {
+            continue;
+        }
+        EditLog::replay(segmento(g), [&](const EditLog::Operazione& op) {
+            switch (op.tipo) {
+            case EditLog::AGGIUNTA:
+                righe.push_back(dizionario.intern(op.valori));
+                break;
+            case EditLog::ELIMINAZIONE:
+                if (op.posizione < righe.size()) {
+                    righe.erase(righe.begin() + static_cast<std::ptrdiff_t>(op.posizione));
+                }
+                break;
+            case EditLog::INSERIMENTO:
+                righe.insert(righe.begin() + static_cast<std::ptrdiff_t>(std::min<uint64_t>(op.posizione, righe.size())),
+                             dizionario.intern(op.valori));
+                break;
+            case EditLog::RIPRISTINO:
+                righe = originali;
+                break;
+            }
+            modificate = true;
+        });
+        std::error_code errore;
+        dimPrecedenti += std::filesystem::file_size(segmento(g), errore);
+        prossimo = g + 1;
+    }
+    eliminaPrecedenti(base);
+
+    // le nuove modifiche vanno in un segmento nuovo: un record troncato in fondo
+    // all'ultimo segmento letto non viene mai seguito da altri record
+    generazione = prossimo;
+    log.reset(new EditLog(segmento(generazione)));
+    return modificate;
+}
+
+
+// Registra l'aggiunta di una riga in fondo alla tabella
+void CatalogJournal::add(const std::vector<std::string>& valori) {
+    if (log) log->add(valori);
+}
+
+
+// Registra l'eliminazione di una riga
+void CatalogJournal::remove(uint64_t posizione) {
+    if (log) log->remove(posizione);
+}
+
+
+// Registra l'inserimento di una riga in una posizione
+void CatalogJournal::insert(uint64_t posizione, const std::vector<std::string>& valori) {
+    if (log) log->insert(posizione, valori);
+}
+
+
+// Registra il ripristino della tabella iniziale
+void CatalogJournal::reset() {
+    if (log) log->reset();
+}
+
+
+// Scrive su disco le modifiche in attesa
+bool CatalogJournal::commit(bool sincronizza) {
+    return !log || log->commit(sincronizza);
+}
+
+
+// Controlla se il registro ha superato la soglia di compattazione
+bool CatalogJournal::needsCompaction() const {
+    return log && !inCorso && dimPrecedenti + log->size() > soglia;
+}
+
+
+// Controlla se una compattazione è in corso
+bool CatalogJournal::compacting() const {
+    return inCorso;
+}
+
+
+// Salva le righe correnti in un nuovo checkpoint in un thread separato
+void CatalogJournal::compact(const std::vector<RigaCatalogo>& righe, const CatalogDictionary& dizionario) {
+    if (!log) {
+        return;
+    }
+    // una compattazione in corso ha già chiuso il suo segmento: si aspetta che finisca,
+    // altrimenti queste righe non verrebbero mai salvate
+    if (compattazione.joinable()) {
+        compattazione.join();
+    }
+
+    // le modifiche già registrate finiscono nel checkpoint, le prossime in un nuovo segmento
+    log->commit();
+    uint64_t g = generazione + 1;
+    log.reset(new EditLog(segmento(g)));
+    generazione = g;
+    dimPrecedenti = 0;
+
+    inCorso = true;
+    compattazione = std::thread([this, g, righe, dizionario]() {
+        try {
+            CatalogSnapshot::write(checkpoint(g), righe, dizionario);
+            eliminaPrecedenti(g);
+        } catch (...) {
+            // senza il checkpoint restano validi i segmenti precedenti
+        }
+        inCorso = false;
+    });
+}
+
+
+// Rende le righe correnti le nuove righe iniziali del registro
+void CatalogJournal::rebase(const std::vector<RigaCatalogo>& righe, const CatalogDictionary& dizionario) {
+    if (!log) {
+        return;
+    }
+    if (compattazione.joinable()) {
+        compattazione.join();
+    }
+
+    // le modifiche già registrate sono comprese nelle righe, le prossime vanno in un nuovo segmento
+    log->commit();
+    uint64_t g = generazione + 1;
+    log.reset(new EditLog(segmento(g)));
+    generazione = g;
+    dimPrecedenti = 0;
+
+    // la base si scrive prima di eliminare i file precedenti: dopo un'interruzione
+    // quelli rimasti hanno un numero minore dell'inizio e vengono ignorati
+    scriviBase(improntaDi(righe, dizionario), g);
+    eliminaPrecedenti(g);
+}
@@ -0,0 +1,169 @@
+/**
+ * @file catalogjournal.h
+ *
+ * @brief File header della classe CatalogJournal
+ *
+ * File di dichiarazioni della classe CatalogJournal, che rende persistenti le modifiche
+ * fatte al catalogo con un registro delle operazioni e checkpoint periodici.
+ */
+
+#ifndef CATALOGJOURNAL_H
+#define CATALOGJOURNAL_H
+
+#include "editlog.h"
+#include "stringpool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Persistenza delle modifiche al catalogo.
+ *
+ * Le modifiche vengono aggiunte in coda a un segmento del registro (EditLog), quindi
+ * salvarle costa quanto la modifica e non quanto l'intero catalogo. I file usati sono:
+ * - prefisso.wal.G: segmenti del registro, numerati in ordine crescente;
+ * - prefisso.checkpoint.G: snapshot delle righe dopo tutti i segmenti con numero minore di G;
+ * - prefisso.base: l'impronta delle righe iniziali su cui è stato scritto il registro e il
+ *   numero del primo segmento che si riferisce a loro.
+ *
+ * All'avvio si parte dal checkpoint più recente (o dai dati iniziali) e si rileggono
+ * i segmenti successivi, solo se le righe iniziali sono ancora quelle del registro. Quando il registro supera una soglia, le righe correnti vengono
+ * salvate in un nuovo checkpoint da un thread separato: le modifiche successive vanno in
+ * un nuovo segmento e i segmenti già compresi nel checkpoint vengono eliminati.
+ */
+class CatalogJournal {
+public:
+    /**
+     * @brief Costruttore.
+     *
+     * @param prefisso il prefisso dei nomi dei file (ad esempio "dipinti_uffizi")
+     * @param soglia la dimensione del registro oltre la quale conviene compattarlo
+     */
+    explicit CatalogJournal(const std::string& prefisso, uint64_t soglia = 1 << 20);
+
+    CatalogJournal(const CatalogJournal&) = delete;
+    CatalogJournal& operator=(const CatalogJournal&) = delete;
+
+    /**
+     * @brief Distruttore: scrive le modifiche in attesa e aspetta la fine della compattazione.
+     */
+    ~CatalogJournal();
+
+    /**
+     * @brief Ricostruisce le righe correnti e apre un nuovo segmento per le modifiche.
+     *
+     * @param dizionario i dizionari in cui inserire i valori letti
+     * @param originali le righe iniziali del catalogo, a cui riporta un ripristino
+     * @param righe le righe correnti ricostruite
+     *
+     * Se le righe iniziali non sono quelle su cui è stato scritto il registro (ad esempio
+     * perché lo snapshot aperto all'avvio è stato sostituito) i segmenti e i checkpoint
+     * non vengono riletti, ma eliminati: applicati a righe diverse le modificherebbero
+     * due volte.
+     *
+     * @return true se le righe correnti sono diverse da quelle iniziali
+     *
+     * @throw std::runtime_error se un checkpoint è danneggiato o il registro non si può aprire
+     */
+    bool recover(CatalogDictionary& dizionario, const std::vector<RigaCatalogo>& originali,
+                 std::vector<RigaCatalogo>& righe);
+
+    /**
+     * @brief Registra l'aggiunta di una riga in fondo alla tabella.
+     *
+     * @param valori i valori della riga
+     */
+    void add(const std::vector<std::string>& valori);
+
+    /**
+     * @brief Registra l'eliminazione di una riga.
+     *
+     * @param posizione la posizione della riga nella tabella
+     */
+    void remove(uint64_t posizione);
+
+    /**
+     * @brief Registra l'inserimento di una riga in una posizione.
+     *
+     * @param posizione la posizione della riga nella tabella dopo l'inserimento
+     * @param valori i valori della riga
+     */
+    void insert(uint64_t posizione, const std::vector<std::string>& valori);
+
+    /**
+     * @brief Registra il ripristino della tabella iniziale.
+     */
+    void reset();
+
+    /**
+     * @brief Scrive su disco le modifiche in attesa (group commit).
+     *
+     * @param sincronizza se true il registro viene forzato su disco (fsync)
+     *
+     * @return true se la scrittura è andata a buon fine
+     */
+    bool commit(bool sincronizza = true);
+
+    /**
+     * @brief Controlla se il registro ha superato la soglia di compattazione.
+     *
+     * @return true se conviene chiamare compact
+     */
+    bool needsCompaction() const;
+
+    /**
+     * @brief Salva le righe correnti in un nuovo checkpoint in un thread separato.
+     *
+     * Le righe e i dizionari vengono copiati, quindi si possono modificare subito dopo
+     * la chiamata. Se una compattazione è già in corso la chiamata aspetta che finisca.
+     *
+     * @param righe le righe correnti
+     * @param dizionario i dizionari a cui si riferiscono le righe
+     */
+    void compact(const std::vector<RigaCatalogo>& righe, const CatalogDictionary& dizionario);
+
+    /**
+     * @brief Rende le righe correnti le nuove righe iniziali del registro.
+     *
+     * Da chiamare quando le righe correnti diventano i dati letti al prossimo avvio
+     * (ad esempio salvando lo snapshot aperto all'avvio): i segmenti già scritti sono
+     * compresi in quelle righe e non vengono più riletti, e un ripristino registrato
+     * da qui in avanti riporta a queste righe.
+     *
+     * @param righe le righe correnti
+     * @param dizionario i dizionari a cui si riferiscono le righe
+     *
+     * @throw std::runtime_error se il file della base non si può scrivere
+     */
+    void rebase(const std::vector<RigaCatalogo>& righe, const CatalogDictionary& dizionario);
+
+    /**
+     * @brief Controlla se una compattazione è in corso.
+     *
+     * @return true o false
+     */
+    bool compacting() const;
+
+private:
+    std::string segmento(uint64_t g) const;
+    std::string checkpoint(uint64_t g) const;
+    std::vector<uint64_t> generazioni(const std::string& tipo) const;
+    void eliminaPrecedenti(uint64_t g) const;
+    bool leggiBase(uint64_t& impronta, uint64_t& inizio) const;
+    void scriviBase(uint64_t impronta, uint64_t inizio) const;
+    static uint64_t improntaDi(const std::vector<RigaCatalogo>& righe, const CatalogDictionary& dizionario);
+
+    std::string prefisso;              ///< prefisso dei nomi dei file
+    uint64_t soglia;                   ///< dimensione del registro oltre la quale compattare
+    uint64_t generazione;              ///< numero del segmento aperto
+    uint64_t dimPrecedenti;            ///< byte dei segmenti non ancora compresi in un checkpoint, escluso quello aperto
+    std::unique_ptr<EditLog> log;      ///< segmento aperto (nullptr prima di recover)
+    std::thread compattazione;         ///< thread dell'ultima compattazione
+    std::atomic<bool> inCorso;         ///< true mentre il thread di compattazione lavora
+};
+
+#endif // CATALOGJOURNAL_H
@@ -0,0 +1,257 @@
+#include "catalogquery.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+
+// Ritorna la stringa senza spazi iniziali e finali
+std::string senzaSpazi(const std::string& s) {
+    size_t inizio = s.find_first_not_of(" \t\r\n");
+    if (inizio == std::string::npos) {
+        return std::string();
+    }
+    size_t fine = s.find_last_not_of(" \t\r\n");
+    return s.substr(inizio, fine - inizio + 1);
+}
+
+// Ritorna la stringa in minuscolo (solo ASCII)
+std::string minuscolo(const std::string& s) {
+    std::string result(s);
+    for (char& ch : result) {
+        ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+    return result;
+}
+
+} // namespace
+
+
+// Aggiunge un predicato di uguaglianza
+CatalogQuery& CatalogQuery::equals(int colonna, const std::string& valore) {
+    predicati.push_back(Predicato{colonna, UGUALE, SearchIndex::normalize(valore), 0, 0});
+    return *this;
+}
+
+
+// Aggiunge un predicato di prefisso
+CatalogQuery& CatalogQuery::startsWith(int colonna, const std::string& valore) {
+    predicati.push_back(Predicato{colonna, INIZIA, SearchIndex::normalize(valore), 0, 0});
+    return *this;
+}
+
+
+// Aggiunge un predicato di sottostringa
+CatalogQuery& CatalogQuery::contains(int colonna, const std::string& valore) {
+    predicati.push_back(Predicato{colonna, CONTIENE, SearchIndex::normalize(valore), 0, 0});
+    return *this;
+}
+
+
+// Aggiunge un predicato sull'intervallo di anni
+CatalogQuery& CatalogQuery::years(int da, int a) {
+    if (da > a) {
+        std::swap(da, a);
+    }
+    predicati.push_back(Predicato{DATA, ANNI, std::string(), da, a});
+    return *this;
+}
+
+
+// Ritorna i predicati dell'interrogazione
+const std::vector<CatalogQuery::Predicato>& CatalogQuery::predicates() const {
+    return predicati;
+}
+
+
+// Controlla se un valore normalizzato soddisfa un predicato
+bool CatalogQuery::soddisfa(const Predicato& p, const std::string& valore) {
+    switch (p.op) {
+    case UGUALE:
+        return valore == p.valore;
+    case INIZIA:
+        return valore.compare(0, p.valore.size(), p.valore) == 0;
+    case CONTIENE:
+        return valore.find(p.valore) != std::string::npos;
+    case ANNI: {
+        DateIndex::Intervallo intervallo;
+        return DateIndex::parse(valore, intervallo) && intervallo.da <= p.a && intervallo.a >= p.da;
+    }
+    }
+    return false;
+}
+
+
+// Esegue l'interrogazione intersecando gli insiemi di righe dei predicati
+std::vector<int> CatalogQuery::run(const SearchIndex& indice, const DateIndex* date) const {
+    std::vector<int> righe;
+    if (predicati.empty()) {
+        // senza predicati si ritornano tutte le righe presenti
+        for (int riga = 0; riga < static_cast<int>(indice.rowCount()); ++riga) {
+            if (indice.contains(riga)) {
+                righe.push_back(riga);
+            }
+        }
+        return righe;
+    }
+
+    // si stima la selettività di ogni predicato senza costruire gli insiemi di righe
+    std::vector<std::pair<size_t, const Predicato*>> ordine;
+    for (const Predicato& p : predicati) {
+        size_t stima;
+        switch (p.op) {
+        case UGUALE:   stima = indice.estimate(p.colonna, p.valore, SearchIndex::ESATTA); break;
+        case INIZIA:   stima = indice.estimate(p.colonna, p.valore, SearchIndex::PREFISSO); break;
+        case CONTIENE: stima = indice.estimate(p.colonna, p.valore, SearchIndex::SOTTOSTRINGA); break;
+        default:       stima = date ? date->estimate(p.da, p.a) : indice.rowCount(); break;
+        }
+        ordine.push_back(std::make_pair(stima, &p));
+    }
+    std::stable_sort(ordine.begin(), ordine.end(),
+        [](const std::pair<size_t, const Predicato*>& a, const std::pair<size_t, const Predicato*>& b) {
+            return a.first < b.first;
+        });
+
+    // si costruisce l'insieme di righe di un predicato a partire dall'indice della sua colonna
+    auto righePredicato = [&indice, date](const Predicato& p) {
+        switch (p.op) {
+        case UGUALE:   return indice.rows(p.colonna, p.valore, SearchIndex::ESATTA);
+        case INIZIA:   return indice.rows(p.colonna, p.valore, SearchIndex::PREFISSO);
+        case CONTIENE: return indice.rows(p.colonna, p.valore, SearchIndex::SOTTOSTRINGA);
+        default:
+            if (date) {
+                return date->rowsOverlapping(p.da, p.a);
+            }
+            return indice.rowsWhere(p.colonna, [&p](const std::string& v) { return soddisfa(p, v); });
+        }
+    };
+
+    righe = righePredicato(*ordine[0].second);
+    for (size_t k = 1; k < ordine.size() && !righe.empty(); ++k) {
+        const Predicato& p = *ordine[k].second;
+        if (righe.size() * 8 <= ordine[k].first) {
+            // pochi candidati: si verifica il predicato sul valore di ogni candidato
+            std::vector<int> rimaste;
+            for (int riga : righe) {
+                const std::string* valore = indice.value(riga, p.colonna);
+                if (valore != nullptr && soddisfa(p, *valore)) {
+                    rimaste.push_back(riga);
+                }
+            }
+            righe.swap(rimaste);
+        } else {
+            std::vector<int> altre = righePredicato(p);
+            std::vector<int> intersezione;
+            std::set_intersection(righe.begin(), righe.end(), altre.begin(), altre.end(),
+                                  std::back_inserter(intersezione));
+            righe.swap(intersezione);
+        }
+    }
+    return righe;
+}
+
+
+// Ritorna la colonna corrispondente a un nome
+int CatalogQuery::columnFromName(const std::string& nome) {
+    std::string n = minuscolo(senzaSpazi(nome));
+    if (n == "scuola") return SCUOLA;
+    if (n == "autore") return AUTORE;
+    if (n == "titolo" || n == "soggetto" || n == "soggetto/titolo") return TITOLO;
+    if (n == "data") return DATA;
+    if (n == "sala") return SALA;
+    return -1;
+}
+
+
+// Controlla se un testo inizia con il nome di una colonna seguito da un operatore
+bool CatalogQuery::isQuery(const std::string& testo) {
+    std::string t = minuscolo(senzaSpazi(testo));
+    size_t i = 0;
+    while (i < t.size() && (std::isalpha(static_cast<unsigned char>(t[i])) || t[i] == '/')) ++i;
+    if (columnFromName(t.substr(0, i)) < 0) {
+        return false;
+    }
+    std::string resto = senzaSpazi(t.substr(i));
+    return resto.compare(0, 1, "=") == 0 || resto.compare(0, 2, "^=") == 0 || resto.compare(0, 1, "~") == 0
+        || (resto.compare(0, 3, "in ") == 0 && i < t.size() && t[i] == ' ');
+}
+
+
+// Costruisce un'interrogazione dal testo
+CatalogQuery CatalogQuery::parse(const std::string& testo) {
+    CatalogQuery query;
+    std::string basso = minuscolo(testo);
+
+    // si divide il testo nei predicati separati da AND, tranne quelli tra virgolette
+    // che fanno parte di un valore (Titolo ~ "Venere and Marte")
+    std::vector<std::string> clausole;
+    size_t inizio = 0;
+    bool traVirgolette = false;
+    for (size_t i = 0; i < basso.size(); ++i) {
+        if (basso[i] == '"') {
+            traVirgolette = !traVirgolette;
+        } else if (!traVirgolette && basso.compare(i, 5, " and ") == 0) {
+            clausole.push_back(testo.substr(inizio, i - inizio));
+            inizio = i + 5;
+            i += 4;
+        }
+    }
+    clausole.push_back(testo.substr(inizio));
+
+    for (const std::string& grezza : clausole) {
+        std::string clausola = senzaSpazi(grezza);
+        size_t i = 0;
+        while (i < clausola.size() && (std::isalpha(static_cast<unsigned char>(clausola[i])) || clausola[i] == '/')) ++i;
+        int colonna = columnFromName(clausola.substr(0, i));
+        if (colonna < 0) {
+            throw std::invalid_argument("Colonna sconosciuta nel predicato: " + clausola);
+        }
+
+        std::string resto = senzaSpazi(clausola.substr(i));
+        Operatore op;
+        size_t lunghezzaOp;
+        if (resto.compare(0, 2, "^=") == 0) {
+            op = INIZIA;
+            lunghezzaOp = 2;
+        } else if (resto.compare(0, 1, "=") == 0) {
+            op = UGUALE;
+            lunghezzaOp = 1;
+        } else if (resto.compare(0, 1, "~") == 0) {
+            op = CONTIENE;
+            lunghezzaOp = 1;
+        } else if (minuscolo(resto).compare(0, 3, "in ") == 0) {
+            op = ANNI;
+            lunghezzaOp = 3;
+        } else {
+            throw std::invalid_argument("Operatore mancante nel predicato: " + clausola);
+        }
+
+        std::string valore = senzaSpazi(resto.substr(lunghezzaOp));
+        if (valore.size() >= 2 && valore.front() == '"' && valore.back() == '"') {
+            valore = valore.substr(1, valore.size() - 2);
+        }
+        if (valore.empty()) {
+            throw std::invalid_argument("Valore mancante nel predicato: " + clausola);
+        }
+
+        if (op == ANNI) {
+            if (colonna != DATA) {
+                throw std::invalid_argument("L'operatore 'in' si usa solo sulla colonna Data: " + clausola);
+            }
+            // il periodo si scrive come una data del catalogo: "1500-1550", "1500", "XVI secolo"
+            DateIndex::Intervallo periodo;
+            if (!DateIndex::parse(valore, periodo)) {
+                throw std::invalid_argument("Intervallo di anni non valido: " + valore);
+            }
+            query.years(periodo.da, periodo.a);
+        } else if (op == UGUALE) {
+            query.equals(colonna, valore);
+        } else if (op == INIZIA) {
+            query.startsWith(colonna, valore);
+        } else {
+            query.contains(colonna, valore);
+        }
+    }
+    return query;
+}
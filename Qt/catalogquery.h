@@ -0,0 +1,172 @@
+/**
+ * @file catalogquery.h
+ *
+ * @brief File header della classe CatalogQuery
+ *
+ * File di dichiarazioni della classe CatalogQuery, che combina più predicati sulle
+ * colonne del catalogo intersecando gli insiemi di righe che li soddisfano.
+ */
+
+#ifndef CATALOGQUERY_H
+#define CATALOGQUERY_H
+
+#include "searchindex.h"
+#include "dateindex.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Interrogazione del catalogo composta da più predicati in AND.
+ *
+ * Ogni predicato viene valutato sull'indice della sua colonna e produce l'insieme
+ * degli id delle righe che lo soddisfano. Gli insiemi vengono poi intersecati
+ * partendo dal predicato più selettivo: quando i candidati rimasti sono pochi
+ * rispetto alla stima di un predicato, quest'ultimo viene verificato direttamente
+ * sui candidati invece di costruire il suo insieme di righe.
+ *
+ * Esempio di uso dall'API:
+ * @code
+ * CatalogQuery q;
+ * q.equals(CatalogQuery::SCUOLA, "fiorentina").equals(CatalogQuery::SALA, "Tribuna").years(1500, 1550);
+ * std::vector<int> righe = q.run(indice, &date);
+ * @endcode
+ *
+ * oppure dal testo, come nel campo di ricerca:
+ * @code
+ * CatalogQuery q = CatalogQuery::parse("Scuola = fiorentina AND Sala ~ Tribuna AND Data in 1500-1550");
+ * @endcode
+ */
+class CatalogQuery {
+public:
+    /**
+     * @brief Colonne del catalogo.
+     */
+    enum Colonna { SCUOLA, AUTORE, TITOLO, DATA, SALA };
+
+    /**
+     * @brief Operatori disponibili per un predicato.
+     */
+    enum Operatore {
+        UGUALE,   ///< il valore coincide (sintassi: colonna = valore)
+        INIZIA,   ///< il valore inizia con il testo (sintassi: colonna ^= valore)
+        CONTIENE, ///< il valore contiene il testo (sintassi: colonna ~ valore)
+        ANNI      ///< la data cade nell'intervallo di anni (sintassi: colonna in da-a)
+    };
+
+    /**
+     * @brief Singolo predicato dell'interrogazione.
+     */
+    struct Predicato {
+        int colonna;        ///< colonna interrogata
+        Operatore op;       ///< operatore
+        std::string valore; ///< testo da confrontare (UGUALE, INIZIA, CONTIENE)
+        int da;             ///< primo anno dell'intervallo (ANNI)
+        int a;              ///< ultimo anno dell'intervallo (ANNI)
+    };
+
+    /**
+     * @brief Aggiunge un predicato di uguaglianza.
+     *
+     * @param colonna la colonna interrogata
+     * @param valore il valore cercato
+     *
+     * @return reference a questa interrogazione
+     */
+    CatalogQuery& equals(int colonna, const std::string& valore);
+
+    /**
+     * @brief Aggiunge un predicato di prefisso.
+     *
+     * @param colonna la colonna interrogata
+     * @param valore il prefisso cercato
+     *
+     * @return reference a questa interrogazione
+     */
+    CatalogQuery& startsWith(int colonna, const std::string& valore);
+
+    /**
+     * @brief Aggiunge un predicato di sottostringa.
+     *
+     * @param colonna la colonna interrogata
+     * @param valore il testo cercato
+     *
+     * @return reference a questa interrogazione
+     */
+    CatalogQuery& contains(int colonna, const std::string& valore);
+
+    /**
+     * @brief Aggiunge un predicato sull'intervallo di anni della colonna Data.
+     *
+     * Una riga soddisfa il predicato se la sua data si sovrappone all'intervallo [da, a].
+     *
+     * @param da primo anno
+     * @param a ultimo anno
+     *
+     * @return reference a questa interrogazione
+     */
+    CatalogQuery& years(int da, int a);
+
+    /**
+     * @brief Ritorna i predicati dell'interrogazione.
+     *
+     * @return i predicati, nell'ordine in cui sono stati aggiunti
+     */
+    const std::vector<Predicato>& predicates() const;
+
+    /**
+     * @brief Esegue l'interrogazione.
+     *
+     * I predicati sugli anni usano l'indice delle date, se presente; altrimenti
+     * vengono valutati sui valori distinti della colonna Data.
+     *
+     * @param indice l'indice delle colonne del catalogo
+     * @param date l'indice degli intervalli di anni della colonna Data (opzionale)
+     *
+     * @return gli id delle righe che soddisfano tutti i predicati, in ordine crescente
+     */
+    std::vector<int> run(const SearchIndex& indice, const DateIndex* date = nullptr) const;
+
+    /**
+     * @brief Costruisce un'interrogazione dal testo.
+     *
+     * I predicati sono separati da AND; ogni predicato ha la forma
+     * "colonna operatore valore" con operatore "=", "^=", "~" oppure "in".
+     * Un valore tra virgolette può contenere AND ("Titolo ~ \"Venere and Marte\"").
+     *
+     * @param testo il testo dell'interrogazione
+     *
+     * @return l'interrogazione
+     *
+     * @throw std::invalid_argument se il testo non è un'interrogazione valida
+     */
+    static CatalogQuery parse(const std::string& testo);
+
+    /**
+     * @brief Controlla se un testo ha la forma di un'interrogazione.
+     *
+     * Il testo deve iniziare con il nome di una colonna seguito da un operatore;
+     * altrimenti viene trattato come una ricerca semplice.
+     *
+     * @param testo il testo da controllare
+     *
+     * @return true o false
+     */
+    static bool isQuery(const std::string& testo);
+
+    /**
+     * @brief Ritorna la colonna corrispondente a un nome.
+     *
+     * @param nome il nome della colonna (Scuola, Autore, Titolo, Soggetto/Titolo, Data, Sala)
+     *
+     * @return l'indice della colonna, oppure -1 se il nome non è valido
+     */
+    static int columnFromName(const std::string& nome);
+
+private:
+    static bool soddisfa(const Predicato& p, const std::string& valore);
+
+    std::vector<Predicato> predicati; ///< predicati in AND
+};
+
+#endif // CATALOGQUERY_H
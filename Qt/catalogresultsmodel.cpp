@@ -0,0 +1,58 @@
+#include "catalogresultsmodel.h"
+
+#include <utility>
+
+// Costruttore della classe CatalogResultsModel
+CatalogResultsModel::CatalogResultsModel(const Catalog& catalogo, TestoCella testo, const QStringList& intestazioni,
+                                         QObject* parent)
+    : QAbstractTableModel(parent), catalogo(catalogo), testo(std::move(testo)), intestazioni(intestazioni) {}
+
+
+// Sostituisce i risultati: la vista rilegge solo le celle che mostra
+void CatalogResultsModel::setResults(const std::vector<int>& nuovi) {
+    beginResetModel();
+    ids = nuovi;
+    endResetModel();
+}
+
+
+// Ritorna l'id stabile della riga in una posizione del modello
+int CatalogResultsModel::rowId(int row) const {
+    if (row < 0 || row >= static_cast<int>(ids.size()))
+        return -1;
+    return ids[row];
+}
+
+
+// Numero di risultati
+int CatalogResultsModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(ids.size());
+}
+
+
+// Numero di colonne del catalogo
+int CatalogResultsModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : COLONNE_CATALOGO;
+}
+
+
+// Testo di una cella, letto dalla riga corrente del catalogo con quell'id
+QVariant CatalogResultsModel::data(const QModelIndex& index, int role) const {
+    if (role != Qt::DisplayRole || !index.isValid())
+        return QVariant();
+    // una riga eliminata dopo la ricerca non ha più una posizione
+    int posizione = catalogo.position(rowId(index.row()));
+    if (posizione < 0)
+        return QVariant();
+    return testo(index.column(), catalogo.row(posizione)[index.column()]);
+}
+
+
+// Nomi delle colonne e numeri delle righe
+QVariant CatalogResultsModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (orientation == Qt::Horizontal)
+        return section < intestazioni.size() ? intestazioni[section] : QVariant();
+    return section + 1;
+}
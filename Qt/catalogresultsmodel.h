@@ -0,0 +1,77 @@
+/**
+ * @file catalogresultsmodel.h
+ *
+ * @brief File header della classe CatalogResultsModel
+ *
+ * File di dichiarazioni della classe CatalogResultsModel, il modello Qt con le sole
+ * righe trovate dalla ricerca durante la digitazione.
+ */
+
+#ifndef CATALOGRESULTSMODEL_H
+#define CATALOGRESULTSMODEL_H
+
+#include <QAbstractTableModel>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+#include <vector>
+
+#include "catalog.h"
+
+/**
+ * @brief Modello delle righe trovate da una ricerca, in ordine di rilevanza.
+ *
+ * Il modello conserva solo gli id stabili dei risultati: il testo delle celle viene
+ * letto dal catalogo quando la vista lo chiede, quindi solo per le righe visibili.
+ * Cambiare i risultati costa quanto il loro numero, non quanto le righe del catalogo.
+ */
+class CatalogResultsModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Funzione che ritorna il testo di un valore di una colonna (colonna, id del valore).
+     */
+    typedef std::function<QString(int, int)> TestoCella;
+
+    /**
+     * @brief Costruttore.
+     *
+     * @param catalogo il catalogo da cui leggere le righe
+     * @param testo la funzione che ritorna il testo di un valore di una colonna
+     * @param intestazioni i nomi delle colonne
+     * @param parent l'oggetto padre
+     */
+    CatalogResultsModel(const Catalog& catalogo, TestoCella testo, const QStringList& intestazioni,
+                        QObject* parent = nullptr);
+
+    /**
+     * @brief Sostituisce i risultati mostrati.
+     *
+     * @param ids gli id stabili delle righe trovate, in ordine di rilevanza
+     */
+    void setResults(const std::vector<int>& ids);
+
+    /**
+     * @brief Ritorna l'id stabile della riga in una posizione del modello.
+     *
+     * @param row la posizione nel modello
+     *
+     * @return l'id stabile, oppure -1 se la posizione non è valida
+     */
+    int rowId(int row) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    const Catalog& catalogo;   ///< catalogo da cui leggere le righe
+    TestoCella testo;          ///< testo di un valore di una colonna
+    QStringList intestazioni;  ///< nomi delle colonne
+    std::vector<int> ids;      ///< id stabili dei risultati, in ordine di rilevanza
+};
+
+#endif // CATALOGRESULTSMODEL_H
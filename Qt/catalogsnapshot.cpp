@@ -0,0 +1,369 @@
+#include "catalogsnapshot.h"
+#include "blockcompress.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace {
+
+const char MAGIC[4] = {'C', 'A', 'T', 'S'};
+const uint32_t ENDIAN = 0x01020304;
+
+// Intestazione del file: magic, versione, ordine dei byte, numero di colonne,
+// righe per blocco, numero di blocchi e numero di righe
+const size_t DIM_INTESTAZIONE = 4 + 5 * sizeof(uint32_t) + sizeof(uint64_t);
+const size_t DIM_VOCE = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+// Un byte compresso produce al più 255 byte decompressi (una lunghezza di 255),
+// più i pochi byte del comando: limita le dimensioni dichiarate nella directory
+const uint64_t ESPANSIONE_MASSIMA = 255;
+
+void danneggiato() {
+    throw std::runtime_error("Snapshot del catalogo danneggiato");
+}
+
+void scrivi32(std::string& out, uint32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+void scrivi64(std::string& out, uint64_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+// Legge un intero a 32 bit dalla posizione pos, avanzandola
+uint32_t leggi32(const std::string& s, size_t& pos) {
+    if (pos + sizeof(uint32_t) > s.size()) {
+        danneggiato();
+    }
+    uint32_t v;
+    std::memcpy(&v, s.data() + pos, sizeof(v));
+    pos += sizeof(v);
+    return v;
+}
+
+uint64_t leggi64(const std::string& s, size_t& pos) {
+    if (pos + sizeof(uint64_t) > s.size()) {
+        danneggiato();
+    }
+    uint64_t v;
+    std::memcpy(&v, s.data() + pos, sizeof(v));
+    pos += sizeof(v);
+    return v;
+}
+
+// Legge una stringa preceduta dalla sua lunghezza
+std::string leggiTesto(const std::string& s, size_t& pos) {
+    uint32_t n = leggi32(s, pos);
+    if (n > s.size() - pos) {
+        danneggiato();
+    }
+    std::string testo = s.substr(pos, n);
+    pos += n;
+    return testo;
+}
+
+void scriviTesto(std::string& out, const std::string& testo) {
+    scrivi32(out, static_cast<uint32_t>(testo.size()));
+    out += testo;
+}
+
+} // namespace
+
+
+// Controlla se una colonna è codificata con un dizionario
+bool CatalogSnapshot::isDictionaryColumn(int colonna) {
+    // Scuola, Autore e Sala hanno pochi valori distinti ripetuti su molte righe
+    return colonna == 0 || colonna == 1 || colonna == 4;
+}
+
+
+// Salva le righe del catalogo in uno snapshot
+void CatalogSnapshot::write(const std::string& percorso, const std::vector<RigaCatalogo>& righe,
+                            const CatalogDictionary& dizionario, int righePerBlocco) {
+    if (righePerBlocco <= 0) {
+        righePerBlocco = 4096;
+    }
+    uint32_t blocchi = static_cast<uint32_t>((righe.size() + righePerBlocco - 1) / righePerBlocco);
+
+    // i dizionari dello snapshot contengono solo i valori usati dalle righe,
+    // numerati nell'ordine in cui compaiono
+    std::vector<std::vector<int>> nuovoId(COLONNE_CATALOGO);
+    std::vector<std::string> dizionariGrezzi(COLONNE_CATALOGO);
+    std::vector<uint32_t> valoriDizionario(COLONNE_CATALOGO, 0);
+    for (int c = 0; c < COLONNE_CATALOGO; ++c) {
+        if (isDictionaryColumn(c)) {
+            nuovoId[c].assign(dizionario.column(c).size(), -1);
+        }
+    }
+    for (const RigaCatalogo& riga : righe) {
+        for (int c = 0; c < COLONNE_CATALOGO; ++c) {
+            if (isDictionaryColumn(c) && nuovoId[c][riga[c]] < 0) {
+                nuovoId[c][riga[c]] = static_cast<int>(valoriDizionario[c]++);
+                scriviTesto(dizionariGrezzi[c], dizionario.value(c, riga[c]));
+            }
+        }
+    }
+
+    // si comprimono i dizionari e ogni colonna di ogni blocco
+    std::vector<std::string> compressi;
+    std::vector<uint32_t> originali;
+    for (int c = 0; c < COLONNE_CATALOGO; ++c) {
+        std::string grezzo;
+        if (isDictionaryColumn(c)) {
+            scrivi32(grezzo, valoriDizionario[c]);
+            grezzo += dizionariGrezzi[c];
+        }
+        compressi.push_back(compressBlock(grezzo.data(), grezzo.size()));
+        originali.push_back(static_cast<uint32_t>(grezzo.size()));
+    }
+    for (int c = 0; c < COLONNE_CATALOGO; ++c) {
+        for (uint32_t b = 0; b < blocchi; ++b) {
+            std::string grezzo;
+            size_t fine = std::min(righe.size(), size_t(b + 1) * righePerBlocco);
+            for (size_t r = size_t(b) * righePerBlocco; r < fine; ++r) {
+                if (isDictionaryColumn(c)) {
+                    scrivi32(grezzo, static_cast<uint32_t>(nuovoId[c][righe[r][c]]));
+                } else {
+                    scriviTesto(grezzo, dizionario.value(c, righe[r][c]));
+                }
+            }
+            compressi.push_back(compressBlock(grezzo.data(), grezzo.size()));
+            originali.push_back(static_cast<uint32_t>(grezzo.size()));
+        }
+    }
+
+    // intestazione e directory: i dizionari seguiti dai blocchi, colonna per colonna
+    std::string testa(MAGIC, sizeof(MAGIC));
+    scrivi32(testa, VERSIONE);
+    scrivi32(testa, ENDIAN);
+    scrivi32(testa, COLONNE_CATALOGO);
+    scrivi32(testa, static_cast<uint32_t>(righePerBlocco));
+    scrivi32(testa, blocchi);
+    scrivi64(testa, righe.size());
+    uint64_t offset = DIM_INTESTAZIONE + compressi.size() * DIM_VOCE;
+    for (size_t k = 0; k < compressi.size(); ++k) {
+        scrivi64(testa, offset);
+        scrivi32(testa, static_cast<uint32_t>(compressi[k].size()));
+        scrivi32(testa, originali[k]);
+        offset += compressi[k].size();
+    }
+
+    std::string temp = percorso + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Impossibile scrivere lo snapshot del catalogo");
+        }
+        out.write(testa.data(), testa.size());
+        for (const std::string& blocco : compressi) {
+            out.write(blocco.data(), blocco.size());
+        }
+        if (!out.flush()) {
+            out.close();
+            std::remove(temp.c_str());
+            throw std::runtime_error("Impossibile scrivere lo snapshot del catalogo");
+        }
+    }
+    std::error_code errore;
+    std::filesystem::rename(temp, percorso, errore);
+    if (errore) {
+        std::remove(temp.c_str());
+        throw std::runtime_error("Impossibile scrivere lo snapshot del catalogo");
+    }
+}
+
+
+// Costruttore che apre uno snapshot
+CatalogSnapshot::CatalogSnapshot(const std::string& percorso)
+    : file(percorso, std::ios::binary), righe(0), righePerBlocco(0), blocchi(0), dizionari(COLONNE_CATALOGO) {
+    if (!file) {
+        throw std::runtime_error("Impossibile aprire lo snapshot del catalogo");
+    }
+    file.seekg(0, std::ios::end);
+    uint64_t dimFile = static_cast<uint64_t>(std::max<std::streamoff>(file.tellg(), 0));
+    file.seekg(0);
+    std::string testa(DIM_INTESTAZIONE, '\0');
+    if (!file.read(&testa[0], testa.size()) || std::memcmp(testa.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Il file non è uno snapshot del catalogo");
+    }
+    size_t pos = sizeof(MAGIC);
+    uint32_t versione = leggi32(testa, pos);
+    uint32_t endian = leggi32(testa, pos);
+    uint32_t colonne = leggi32(testa, pos);
+    righePerBlocco = leggi32(testa, pos);
+    blocchi = leggi32(testa, pos);
+    righe = leggi64(testa, pos);
+    if (versione != VERSIONE || endian != ENDIAN || colonne != static_cast<uint32_t>(COLONNE_CATALOGO)
+        || righePerBlocco == 0) {
+        throw std::runtime_error("Versione dello snapshot del catalogo non supportata");
+    }
+    // i blocchi devono essere esattamente quelli che servono alle righe, e la
+    // directory deve stare nel file prima di allocarla
+    uint64_t blocchiNecessari = righe / righePerBlocco + (righe % righePerBlocco != 0 ? 1 : 0);
+    size_t voci = COLONNE_CATALOGO * (size_t(blocchi) + 1);
+    if (blocchi != blocchiNecessari || voci * DIM_VOCE > dimFile - DIM_INTESTAZIONE) {
+        danneggiato();
+    }
+
+    std::string grezza(voci * DIM_VOCE, '\0');
+    if (!file.read(&grezza[0], grezza.size())) {
+        danneggiato();
+    }
+    pos = 0;
+    for (size_t k = 0; k < voci; ++k) {
+        Voce v;
+        v.offset = leggi64(grezza, pos);
+        v.dimCompressa = leggi32(grezza, pos);
+        v.dimOriginale = leggi32(grezza, pos);
+        // ogni blocco sta nel file e non si espande oltre quanto permette il formato
+        if (v.offset > dimFile || v.dimCompressa > dimFile - v.offset
+            || v.dimOriginale > ESPANSIONE_MASSIMA * v.dimCompressa + 16) {
+            danneggiato();
+        }
+        directory.push_back(v);
+    }
+    // nelle colonne codificate con un dizionario ogni riga occupa 4 byte: questo limita
+    // anche il numero di righe dichiarato a quanto i blocchi possono contenere
+    for (int c = 0; c < COLONNE_CATALOGO; ++c) {
+        for (uint32_t b = 0; isDictionaryColumn(c) && b < blocchi; ++b) {
+            if (voce(c, static_cast<int>(b)).dimOriginale != righeBlocco(b) * sizeof(uint32_t)) {
+                danneggiato();
+            }
+        }
+    }
+
+    // i dizionari sono piccoli e servono a tutti i blocchi: si leggono subito
+    for (int c = 0; c < COLONNE_CATALOGO; ++c) {
+        if (!isDictionaryColumn(c)) {
+            continue;
+        }
+        std::string dati = leggi(directory[c]);
+        size_t p = 0;
+        uint32_t n = leggi32(dati, p);
+        // ogni valore occupa almeno i 4 byte della sua lunghezza
+        if (n > (dati.size() - p) / sizeof(uint32_t)) {
+            danneggiato();
+        }
+        dizionari[c].reserve(n);
+        for (uint32_t k = 0; k < n; ++k) {
+            dizionari[c].push_back(leggiTesto(dati, p));
+        }
+        if (p != dati.size()) {
+            danneggiato();
+        }
+    }
+}
+
+
+// Ritorna il numero di righe dello snapshot
+size_t CatalogSnapshot::rowCount() const {
+    return static_cast<size_t>(righe);
+}
+
+
+// Ritorna il numero di blocchi dello snapshot
+int CatalogSnapshot::blockCount() const {
+    return static_cast<int>(blocchi);
+}
+
+
+// Ritorna il numero di righe di ogni blocco
+int CatalogSnapshot::rowsPerBlock() const {
+    return static_cast<int>(righePerBlocco);
+}
+
+
+// Ritorna il numero di righe di un blocco (l'ultimo può essere incompleto)
+uint64_t CatalogSnapshot::righeBlocco(uint32_t blocco) const {
+    uint64_t inizio = uint64_t(blocco) * righePerBlocco;
+    return std::min<uint64_t>(righe - inizio, righePerBlocco);
+}
+
+
+// Ritorna la voce della directory di una colonna di un blocco (dopo quelle dei dizionari)
+const CatalogSnapshot::Voce& CatalogSnapshot::voce(int colonna, int blocco) const {
+    return directory[COLONNE_CATALOGO + size_t(colonna) * blocchi + blocco];
+}
+
+
+// Legge e decomprime un blocco compresso
+std::string CatalogSnapshot::leggi(const Voce& voce) const {
+    std::string compresso(voce.dimCompressa, '\0');
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(voce.offset));
+    if (!file.read(&compresso[0], compresso.size())) {
+        danneggiato();
+    }
+    return decompressBlock(compresso.data(), compresso.size(), voce.dimOriginale);
+}
+
+
+// Legge e decomprime un solo blocco
+std::vector<std::vector<std::string>> CatalogSnapshot::readBlock(int blocco) const {
+    if (blocco < 0 || blocco >= static_cast<int>(blocchi)) {
+        throw std::out_of_range("Blocco dello snapshot fuori dai limiti");
+    }
+    size_t n = static_cast<size_t>(righeBlocco(static_cast<uint32_t>(blocco)));
+    std::vector<std::vector<std::string>> result(n, std::vector<std::string>(COLONNE_CATALOGO));
+    for (int c = 0; c < COLONNE_CATALOGO; ++c) {
+        std::string dati = leggi(voce(c, blocco));
+        size_t p = 0;
+        for (size_t r = 0; r < n; ++r) {
+            if (isDictionaryColumn(c)) {
+                uint32_t id = leggi32(dati, p);
+                if (id >= dizionari[c].size()) {
+                    danneggiato();
+                }
+                result[r][c] = dizionari[c][id];
+            } else {
+                result[r][c] = leggiTesto(dati, p);
+            }
+        }
+        // il blocco contiene esattamente le righe dichiarate
+        if (p != dati.size()) {
+            danneggiato();
+        }
+    }
+    return result;
+}
+
+
+// Legge tutte le righe
+void CatalogSnapshot::readAll(CatalogDictionary& dizionario, std::vector<RigaCatalogo>& result) const {
+    // i valori dei dizionari dello snapshot vengono inseriti una volta sola
+    std::vector<std::vector<int>> idPool(COLONNE_CATALOGO);
+    for (int c = 0; c < COLONNE_CATALOGO; ++c) {
+        for (const std::string& valore : dizionari[c]) {
+            idPool[c].push_back(dizionario.intern(c, valore));
+        }
+    }
+
+    size_t primo = result.size();
+    result.resize(primo + righe);
+    for (uint32_t b = 0; b < blocchi; ++b) {
+        size_t inizio = size_t(b) * righePerBlocco;
+        size_t n = static_cast<size_t>(righeBlocco(b));
+        for (int c = 0; c < COLONNE_CATALOGO; ++c) {
+            std::string dati = leggi(voce(c, b));
+            size_t p = 0;
+            for (size_t r = 0; r < n; ++r) {
+                int id;
+                if (isDictionaryColumn(c)) {
+                    uint32_t k = leggi32(dati, p);
+                    if (k >= idPool[c].size()) {
+                        danneggiato();
+                    }
+                    id = idPool[c][k];
+                } else {
+                    id = dizionario.intern(c, leggiTesto(dati, p));
+                }
+                result[primo + inizio + r][c] = id;
+            }
+            if (p != dati.size()) {
+                danneggiato();
+            }
+        }
+    }
+}
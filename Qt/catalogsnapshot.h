@@ -0,0 +1,143 @@
+/**
+ * @file catalogsnapshot.h
+ *
+ * @brief File header della classe CatalogSnapshot
+ *
+ * File di dichiarazioni della classe CatalogSnapshot, che salva le righe del catalogo
+ * in un file compresso organizzato per colonne e le rilegge anche un blocco alla volta.
+ */
+
+#ifndef CATALOGSNAPSHOT_H
+#define CATALOGSNAPSHOT_H
+
+#include "stringpool.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Snapshot compresso del catalogo.
+ *
+ * Le righe vengono divise in blocchi di righe consecutive e ogni colonna di ogni blocco
+ * viene compressa separatamente con compressBlock. Le colonne con pochi valori distinti
+ * (Scuola, Autore e Sala) sono codificate con un dizionario salvato una volta sola:
+ * nei blocchi compare solo l'indice del valore. Le altre colonne (Soggetto/Titolo e Data)
+ * sono salvate come testo.
+ *
+ * Il file inizia con un'intestazione e una directory con posizione e dimensioni di ogni
+ * blocco compresso, così un singolo blocco si può leggere e decomprimere senza leggere
+ * il resto del file.
+ */
+class CatalogSnapshot {
+public:
+    /**
+     * @brief Versione corrente del formato.
+     */
+    static const uint32_t VERSIONE = 1;
+
+    /**
+     * @brief Salva le righe del catalogo in uno snapshot.
+     *
+     * Il file viene scritto in un file temporaneo che poi sostituisce quello indicato.
+     *
+     * @param percorso il nome del file
+     * @param righe le righe come tuple di id
+     * @param dizionario i dizionari a cui si riferiscono gli id
+     * @param righePerBlocco il numero di righe di ogni blocco
+     *
+     * @throw std::runtime_error se il file non si può scrivere
+     */
+    static void write(const std::string& percorso, const std::vector<RigaCatalogo>& righe,
+                      const CatalogDictionary& dizionario, int righePerBlocco = 4096);
+
+    /**
+     * @brief Controlla se una colonna è codificata con un dizionario.
+     *
+     * @param colonna la colonna
+     *
+     * @return true per Scuola, Autore e Sala
+     */
+    static bool isDictionaryColumn(int colonna);
+
+    /**
+     * @brief Costruttore che apre uno snapshot.
+     *
+     * Legge l'intestazione, la directory dei blocchi e i dizionari, ma non i blocchi.
+     *
+     * @param percorso il nome del file
+     *
+     * @throw std::runtime_error se il file non si può aprire o non è uno snapshot valido
+     */
+    explicit CatalogSnapshot(const std::string& percorso);
+
+    /**
+     * @brief Ritorna il numero di righe dello snapshot.
+     *
+     * @return il numero di righe
+     */
+    size_t rowCount() const;
+
+    /**
+     * @brief Ritorna il numero di blocchi dello snapshot.
+     *
+     * @return il numero di blocchi
+     */
+    int blockCount() const;
+
+    /**
+     * @brief Ritorna il numero di righe di ogni blocco (l'ultimo può averne meno).
+     *
+     * @return il numero di righe per blocco
+     */
+    int rowsPerBlock() const;
+
+    /**
+     * @brief Legge e decomprime un solo blocco.
+     *
+     * @param blocco l'indice del blocco
+     *
+     * @return i valori delle righe del blocco, uno per colonna
+     *
+     * @throw std::out_of_range se il blocco non esiste
+     * @throw std::runtime_error se il blocco è danneggiato
+     */
+    std::vector<std::vector<std::string>> readBlock(int blocco) const;
+
+    /**
+     * @brief Legge tutte le righe.
+     *
+     * I valori vengono inseriti nel dizionario; per le colonne codificate ogni valore
+     * del dizionario dello snapshot viene inserito una volta sola.
+     *
+     * @param dizionario i dizionari in cui inserire i valori
+     * @param righe le righe lette, aggiunte in coda
+     *
+     * @throw std::runtime_error se un blocco è danneggiato
+     */
+    void readAll(CatalogDictionary& dizionario, std::vector<RigaCatalogo>& righe) const;
+
+private:
+    /**
+     * @brief Posizione e dimensioni di un blocco compresso.
+     */
+    struct Voce {
+        uint64_t offset;        ///< posizione dall'inizio del file
+        uint32_t dimCompressa;  ///< dimensione compressa
+        uint32_t dimOriginale;  ///< dimensione decompressa
+    };
+
+    std::string leggi(const Voce& voce) const;
+    const Voce& voce(int colonna, int blocco) const;
+    uint64_t righeBlocco(uint32_t blocco) const;
+
+    mutable std::ifstream file;                          ///< lo snapshot aperto in lettura
+    uint64_t righe;                                      ///< numero di righe
+    uint32_t righePerBlocco;                             ///< righe per blocco
+    uint32_t blocchi;                                    ///< numero di blocchi
+    std::vector<Voce> directory;                         ///< colonna * blocchi + blocco -> blocco compresso
+    std::vector<std::vector<std::string>> dizionari;     ///< valori delle colonne codificate (vuoto per le altre)
+};
+
+#endif // CATALOGSNAPSHOT_H
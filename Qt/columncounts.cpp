@@ -0,0 +1,75 @@
+#include "columncounts.h"
+
+#include <algorithm>
+
+// Costruttore della classe ColumnCounts
+ColumnCounts::ColumnCounts(int numColonne) : conteggi(std::min(numColonne, COLONNE_CATALOGO)), righe(0) {}
+
+
+// Conta i valori di una riga aggiunta
+void ColumnCounts::add(const RigaCatalogo& riga) {
+    for (size_t j = 0; j < conteggi.size(); ++j) {
+        if (riga[j] < 0) {
+            continue;
+        }
+        if (static_cast<size_t>(riga[j]) >= conteggi[j].size()) {
+            conteggi[j].resize(riga[j] + 1, 0);
+        }
+        ++conteggi[j][riga[j]];
+    }
+    ++righe;
+}
+
+
+// Toglie dal conteggio i valori di una riga eliminata
+void ColumnCounts::remove(const RigaCatalogo& riga) {
+    for (size_t j = 0; j < conteggi.size(); ++j) {
+        if (riga[j] >= 0 && static_cast<size_t>(riga[j]) < conteggi[j].size() && conteggi[j][riga[j]] > 0) {
+            --conteggi[j][riga[j]];
+        }
+    }
+    if (righe > 0) {
+        --righe;
+    }
+}
+
+
+// Azzera tutti i conteggi
+void ColumnCounts::clear() {
+    for (std::vector<int>& colonna : conteggi) {
+        colonna.clear();
+    }
+    righe = 0;
+}
+
+
+// Ritorna il numero di righe contate
+int ColumnCounts::total() const {
+    return righe;
+}
+
+
+// Ritorna il numero di righe con un certo valore in una colonna
+int ColumnCounts::count(int colonna, int id) const {
+    if (colonna < 0 || colonna >= static_cast<int>(conteggi.size())
+        || id < 0 || id >= static_cast<int>(conteggi[colonna].size())) {
+        return 0;
+    }
+    return conteggi[colonna][id];
+}
+
+
+// Ritorna i conteggi di una colonna ordinati per valore
+std::vector<std::pair<std::string, int>> ColumnCounts::sorted(int colonna, const StringPool& dizionario) const {
+    std::vector<std::pair<std::string, int>> result;
+    if (colonna < 0 || colonna >= static_cast<int>(conteggi.size())) {
+        return result;
+    }
+    for (size_t id = 0; id < conteggi[colonna].size(); ++id) {
+        if (conteggi[colonna][id] > 0) {
+            result.push_back(std::make_pair(dizionario.value(static_cast<int>(id)), conteggi[colonna][id]));
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file columncounts.h
+ *
+ * @brief File header della classe ColumnCounts
+ *
+ * File di dichiarazioni della classe ColumnCounts, che mantiene il conteggio dei valori
+ * di ogni colonna del catalogo aggiornandolo ad ogni aggiunta o eliminazione di una riga.
+ */
+
+#ifndef COLUMNCOUNTS_H
+#define COLUMNCOUNTS_H
+
+#include "stringpool.h"
+
+#include <string>
+#include <vector>
+#include <utility>
+
+/**
+ * @brief Conteggi dei valori per colonna, mantenuti in modo incrementale.
+ *
+ * Le righe arrivano come tuple di id dei dizionari di colonna, quindi per ogni
+ * colonna basta un vettore id -> numero di righe, aggiornato con un incremento
+ * intero quando una riga viene aggiunta o eliminata. I grafici leggono i
+ * conteggi già pronti invece di riscandire tutta la tabella.
+ */
+class ColumnCounts {
+public:
+    /**
+     * @brief Costruttore.
+     *
+     * @param numColonne il numero di colonne da contare
+     */
+    explicit ColumnCounts(int numColonne = COLONNE_CATALOGO);
+
+    /**
+     * @brief Conta i valori di una riga aggiunta.
+     *
+     * @param riga la tupla di id della riga
+     */
+    void add(const RigaCatalogo& riga);
+
+    /**
+     * @brief Toglie dal conteggio i valori di una riga eliminata.
+     *
+     * @param riga la tupla di id della riga
+     */
+    void remove(const RigaCatalogo& riga);
+
+    /**
+     * @brief Azzera tutti i conteggi.
+     */
+    void clear();
+
+    /**
+     * @brief Ritorna il numero di righe contate.
+     *
+     * @return il numero di righe
+     */
+    int total() const;
+
+    /**
+     * @brief Ritorna il numero di righe con un certo valore in una colonna.
+     *
+     * @param colonna la colonna
+     * @param id l'id del valore nel dizionario della colonna
+     *
+     * @return il numero di righe
+     */
+    int count(int colonna, int id) const;
+
+    /**
+     * @brief Ritorna i conteggi di una colonna ordinati per valore.
+     *
+     * I valori senza righe vengono tralasciati.
+     *
+     * @param colonna la colonna
+     * @param dizionario il dizionario della colonna, per tradurre gli id in valori
+     *
+     * @return le coppie (valore, numero di righe) in ordine di valore
+     */
+    std::vector<std::pair<std::string, int>> sorted(int colonna, const StringPool& dizionario) const;
+
+private:
+    std::vector<std::vector<int>> conteggi; ///< per ogni colonna: id del valore -> numero di righe
+    int righe;                              ///< numero di righe contate
+};
+
+#endif // COLUMNCOUNTS_H
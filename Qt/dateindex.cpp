@@ -0,0 +1,316 @@
+#include "dateindex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <map>
+
+namespace {
+
+// Legge un numero intero a partire dalla posizione i, avanzandola. Le cifre oltre
+// la quinta vengono solo contate: un anno ne ha al più quattro e il testo libero della
+// colonna Data (ad esempio un numero di inventario) non deve far traboccare l'int
+bool leggiNumero(const std::string& s, size_t& i, int& numero, int& cifre) {
+    numero = 0;
+    cifre = 0;
+    while (i < s.size() && std::isdigit(static_cast<unsigned char>(s[i]))) {
+        if (cifre < 5) {
+            numero = numero * 10 + (s[i] - '0');
+        }
+        ++i;
+        ++cifre;
+    }
+    return cifre > 0;
+}
+
+// Salta un separatore di intervallo: trattino, trattino lungo (UTF-8) e spazi
+size_t saltaSeparatore(const std::string& s, size_t i) {
+    while (i < s.size() && s[i] == ' ') ++i;
+    if (i < s.size() && s[i] == '-') {
+        ++i;
+    } else if (s.compare(i, 3, "\xE2\x80\x93") == 0) {
+        i += 3;
+    } else {
+        return std::string::npos;
+    }
+    while (i < s.size() && s[i] == ' ') ++i;
+    return i;
+}
+
+// Valore di un numero romano (0 se la stringa non è un numero romano)
+int numeroRomano(const std::string& s) {
+    int result = 0, precedente = 0;
+    for (size_t i = s.size(); i-- > 0;) {
+        int v;
+        switch (s[i]) {
+        case 'i': v = 1; break;
+        case 'v': v = 5; break;
+        case 'x': v = 10; break;
+        case 'l': v = 50; break;
+        case 'c': v = 100; break;
+        default: return 0;
+        }
+        result += (v < precedente) ? -v : v;
+        precedente = std::max(precedente, v);
+    }
+    return result;
+}
+
+} // namespace
+
+
+// Interpreta un valore della colonna Data come intervallo di anni
+bool DateIndex::parse(const std::string& testo, Intervallo& risultato) {
+    std::string s(testo);
+    for (char& ch : s) {
+        ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+
+    size_t i = 0;
+    while (i < s.size() && !std::isdigit(static_cast<unsigned char>(s[i]))) ++i;
+    int da, cifre;
+    if (!leggiNumero(s, i, da, cifre) || cifre < 3 || cifre > 4) {
+        // senza anni si prova con un secolo in numeri romani ("xv secolo", "sec. xv")
+        if (s.find("sec") == std::string::npos) {
+            return false;
+        }
+        size_t j = 0;
+        while (j < s.size()) {
+            while (j < s.size() && !std::isalpha(static_cast<unsigned char>(s[j]))) ++j;
+            size_t inizio = j;
+            while (j < s.size() && std::isalpha(static_cast<unsigned char>(s[j]))) ++j;
+            int secolo = numeroRomano(s.substr(inizio, j - inizio));
+            if (secolo > 0 && secolo <= 21) {
+                risultato = Intervallo{(secolo - 1) * 100 + 1, secolo * 100, CIRCA};
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Precisione precisione = ESATTA;
+    int a = da;
+    size_t j = saltaSeparatore(s, i);
+    int secondo, cifreSecondo;
+    // un secondo numero di più di quattro cifre non è un anno (ad esempio un numero di inventario)
+    if (j != std::string::npos && leggiNumero(s, j, secondo, cifreSecondo) && cifreSecondo <= 4) {
+        if (cifreSecondo >= cifre) {
+            a = secondo;
+        } else {
+            // anno finale abbreviato: si completa con le cifre iniziali del primo ("1522-28")
+            int scala = 1;
+            for (int k = 0; k < cifreSecondo; ++k) scala *= 10;
+            a = da / scala * scala + secondo;
+            if (a < da) {
+                // abbreviazione non coerente ("1522-153"): si legge come decennio
+                int resto = 1;
+                for (int k = cifreSecondo; k < cifre; ++k) resto *= 10;
+                a = secondo * resto + resto - 1;
+                precisione = INCERTA;
+            }
+        }
+        if (a < da) {
+            a = da;
+            precisione = INCERTA;
+        }
+    }
+
+    if (precisione != INCERTA) {
+        if (s.find("ante") != std::string::npos) {
+            precisione = ANTE;
+            da = a - MARGINE_ANTE_POST;
+        } else if (s.find("post") != std::string::npos) {
+            precisione = POST;
+            a = da + MARGINE_ANTE_POST;
+        } else if (s.find("circa") != std::string::npos || s.find("ca.") != std::string::npos) {
+            precisione = CIRCA;
+        }
+    }
+
+    risultato = Intervallo{da, a, precisione};
+    return true;
+}
+
+
+// Aggiunge una riga all'indice
+void DateIndex::addRow(int id, const std::string& data) {
+    if (id < 0) {
+        return;
+    }
+    if (static_cast<size_t>(id) >= voceRiga.size()) {
+        voceRiga.resize(id + 1, -1);
+    }
+    if (voceRiga[id] >= 0) {
+        removeRow(id);
+    }
+
+    std::unordered_map<std::string, int>::iterator it = idVoce.find(data);
+    int v;
+    if (it == idVoce.end()) {
+        // nuovo valore distinto: viene interpretato una sola volta
+        v = static_cast<int>(voci.size());
+        Voce voce;
+        voce.valida = parse(data, voce.intervallo);
+        voce.vive = 0;
+        voci.push_back(voce);
+        idVoce.emplace(data, v);
+        if (voce.valida) {
+            aggiornato = false;
+        }
+    } else {
+        v = it->second;
+    }
+
+    // una riga rimossa che torna con lo stesso valore è ancora nella lista della voce
+    if (voceRiga[id] != -2 - v) {
+        voci[v].righe.push_back(id);
+    }
+    ++voci[v].vive;
+    if (!voci[v].valida) {
+        ++senzaData;
+    }
+    voceRiga[id] = v;
+}
+
+
+// Rimuove una riga dall'indice
+void DateIndex::removeRow(int id) {
+    if (id < 0 || static_cast<size_t>(id) >= voceRiga.size() || voceRiga[id] < 0) {
+        return;
+    }
+    Voce& voce = voci[voceRiga[id]];
+    --voce.vive;
+    if (!voce.valida) {
+        --senzaData;
+    }
+    // la riga resta nella lista della voce ma non vi appartiene più; la voce viene
+    // ricordata come -2 - v, per riattivare la riga senza duplicarla nella lista
+    voceRiga[id] = -2 - voceRiga[id];
+}
+
+
+// Svuota l'indice
+void DateIndex::clear() {
+    idVoce.clear();
+    voci.clear();
+    voceRiga.clear();
+    senzaData = 0;
+    perInizio.clear();
+    maxFine.clear();
+    foglie = 0;
+    aggiornato = true;
+}
+
+
+// Ordina le voci valide per anno iniziale e ricostruisce l'albero dei massimi
+void DateIndex::aggiorna() const {
+    if (aggiornato) {
+        return;
+    }
+    perInizio.clear();
+    for (int v = 0; v < static_cast<int>(voci.size()); ++v) {
+        if (voci[v].valida) {
+            perInizio.push_back(v);
+        }
+    }
+    std::sort(perInizio.begin(), perInizio.end(), [this](int x, int y) {
+        return voci[x].intervallo.da < voci[y].intervallo.da;
+    });
+
+    foglie = 1;
+    while (foglie < perInizio.size()) foglie *= 2;
+    maxFine.assign(2 * foglie, INT_MIN);
+    for (size_t k = 0; k < perInizio.size(); ++k) {
+        maxFine[foglie + k] = voci[perInizio[k]].intervallo.a;
+    }
+    for (size_t n = foglie; n-- > 1;) {
+        maxFine[n] = std::max(maxFine[2 * n], maxFine[2 * n + 1]);
+    }
+    aggiornato = true;
+}
+
+
+// Visita le voci il cui intervallo si sovrappone a [da, a]: si considerano solo le voci
+// che iniziano entro 'a' e si scende solo nei rami il cui anno finale massimo è almeno 'da'
+template <typename Visita>
+void DateIndex::visita(int da, int a, Visita f) const {
+    aggiorna();
+    size_t limite = std::upper_bound(perInizio.begin(), perInizio.end(), a, [this](int anno, int v) {
+        return anno < voci[v].intervallo.da;
+    }) - perInizio.begin();
+    if (limite == 0) {
+        return;
+    }
+
+    // nodo, primo e ultimo indice (escluso) coperti dal nodo
+    std::vector<std::pair<size_t, std::pair<size_t, size_t>>> pila;
+    pila.push_back(std::make_pair(size_t(1), std::make_pair(size_t(0), foglie)));
+    while (!pila.empty()) {
+        size_t nodo = pila.back().first;
+        size_t inizio = pila.back().second.first;
+        size_t fine = pila.back().second.second;
+        pila.pop_back();
+        if (inizio >= limite || maxFine[nodo] < da) {
+            continue;
+        }
+        if (nodo >= foglie) {
+            f(perInizio[inizio]);
+            continue;
+        }
+        size_t meta = (inizio + fine) / 2;
+        pila.push_back(std::make_pair(2 * nodo + 1, std::make_pair(meta, fine)));
+        pila.push_back(std::make_pair(2 * nodo, std::make_pair(inizio, meta)));
+    }
+}
+
+
+// Ritorna le righe la cui data si sovrappone a un periodo
+std::vector<int> DateIndex::rowsOverlapping(int da, int a) const {
+    std::vector<int> result;
+    if (da > a) {
+        std::swap(da, a);
+    }
+    visita(da, a, [this, &result](int v) {
+        for (int riga : voci[v].righe) {
+            if (voceRiga[riga] == v) {
+                result.push_back(riga);
+            }
+        }
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+
+// Conta le righe la cui data si sovrappone a un periodo
+size_t DateIndex::estimate(int da, int a) const {
+    size_t result = 0;
+    if (da > a) {
+        std::swap(da, a);
+    }
+    visita(da, a, [this, &result](int v) { result += voci[v].vive; });
+    return result;
+}
+
+
+// Calcola l'istogramma delle righe per periodi di ampiezza fissa
+std::vector<std::pair<int, int>> DateIndex::histogram(int ampiezza) const {
+    std::map<int, int> periodi;
+    if (ampiezza <= 0) {
+        return std::vector<std::pair<int, int>>();
+    }
+    // si lavora sui valori distinti, ognuno pesato con il numero di righe presenti
+    for (const Voce& voce : voci) {
+        if (voce.valida && voce.vive > 0) {
+            int centro = (voce.intervallo.da + voce.intervallo.a) / 2;
+            periodi[centro / ampiezza * ampiezza] += voce.vive;
+        }
+    }
+    return std::vector<std::pair<int, int>>(periodi.begin(), periodi.end());
+}
+
+
+// Ritorna il numero di righe la cui data non è interpretabile
+int DateIndex::undatedCount() const {
+    return senzaData;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file dateindex.h
+ *
+ * @brief File header della classe DateIndex
+ *
+ * File di dichiarazioni della classe DateIndex, che interpreta i valori testuali della
+ * colonna Data come intervalli di anni e li indicizza per le interrogazioni per periodo
+ * e per gli istogrammi per decennio o per secolo.
+ */
+
+#ifndef DATEINDEX_H
+#define DATEINDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Indice degli intervalli di anni della colonna Data.
+ *
+ * Ogni valore distinto della colonna (ad esempio "1600-1630 circa" o "1634 circa")
+ * viene interpretato una sola volta come intervallo [da, a] con un indicatore di
+ * precisione. Gli intervalli distinti sono ordinati per anno iniziale e sopra di essi
+ * è costruito un albero dei massimi degli anni finali: un'interrogazione per periodo
+ * visita solo i rami che possono contenere intervalli sovrapposti.
+ *
+ * L'indice si costruisce in una sola passata sulle righe caricate; l'ordinamento
+ * viene fatto alla prima interrogazione e ripetuto solo quando compare un nuovo
+ * valore distinto.
+ */
+class DateIndex {
+public:
+    /**
+     * @brief Precisione di una data interpretata.
+     */
+    enum Precisione {
+        ESATTA,  ///< anno o intervallo certo ("1603", "1420-1422")
+        CIRCA,   ///< data approssimata ("1634 circa", "XV secolo")
+        ANTE,    ///< termine ante quem ("1338 (ante)")
+        POST,    ///< termine post quem ("1520 (post)", "post 1304")
+        INCERTA  ///< intervallo ricostruito da un valore malformato ("1522-153 circa")
+    };
+
+    /**
+     * @brief Intervallo di anni interpretato da un valore della colonna Data.
+     */
+    struct Intervallo {
+        int da;                 ///< primo anno
+        int a;                  ///< ultimo anno
+        Precisione precisione;  ///< precisione della data
+    };
+
+    /**
+     * @brief Numero di anni usato per gli intervalli aperti (ante e post).
+     */
+    static const int MARGINE_ANTE_POST = 25;
+
+    /**
+     * @brief Interpreta un valore della colonna Data.
+     *
+     * Riconosce anni singoli, intervalli con trattino o trattino lungo, le indicazioni
+     * "circa", "ante" e "post" e i secoli in numeri romani ("XV secolo").
+     *
+     * @param testo il valore da interpretare
+     * @param risultato l'intervallo interpretato
+     *
+     * @return true se il valore contiene una data riconoscibile, false altrimenti
+     */
+    static bool parse(const std::string& testo, Intervallo& risultato);
+
+    /**
+     * @brief Aggiunge una riga all'indice.
+     *
+     * @param id l'id stabile della riga (non negativo)
+     * @param data il valore della colonna Data
+     */
+    void addRow(int id, const std::string& data);
+
+    /**
+     * @brief Rimuove una riga dall'indice.
+     *
+     * Se la riga viene poi aggiunta di nuovo con la stessa data, non viene duplicata
+     * nella lista della sua voce.
+     *
+     * @param id l'id della riga
+     */
+    void removeRow(int id);
+
+    /**
+     * @brief Svuota l'indice.
+     */
+    void clear();
+
+    /**
+     * @brief Ritorna le righe la cui data si sovrappone a un periodo.
+     *
+     * @param da primo anno del periodo
+     * @param a ultimo anno del periodo
+     *
+     * @return gli id delle righe presenti, in ordine crescente
+     */
+    std::vector<int> rowsOverlapping(int da, int a) const;
+
+    /**
+     * @brief Conta le righe la cui data si sovrappone a un periodo, senza costruirne la lista.
+     *
+     * @param da primo anno del periodo
+     * @param a ultimo anno del periodo
+     *
+     * @return il numero di righe
+     */
+    size_t estimate(int da, int a) const;
+
+    /**
+     * @brief Calcola l'istogramma delle righe per periodi di ampiezza fissa.
+     *
+     * Ogni riga viene contata nel periodo che contiene l'anno centrale del suo
+     * intervallo, così la somma dei conteggi è il numero di righe datate.
+     *
+     * @param ampiezza l'ampiezza dei periodi in anni (10 = decenni, 100 = secoli)
+     *
+     * @return le coppie (primo anno del periodo, numero di righe) in ordine di anno
+     */
+    std::vector<std::pair<int, int>> histogram(int ampiezza) const;
+
+    /**
+     * @brief Ritorna il numero di righe la cui data non è interpretabile.
+     *
+     * @return il numero di righe senza data
+     */
+    int undatedCount() const;
+
+private:
+    /**
+     * @brief Valore distinto della colonna Data.
+     */
+    struct Voce {
+        Intervallo intervallo;  ///< intervallo interpretato
+        bool valida;            ///< true se il valore è stato interpretato
+        std::vector<int> righe; ///< righe con questo valore (comprese quelle eliminate)
+        int vive;               ///< numero di righe presenti con questo valore
+    };
+
+    void aggiorna() const;
+    template <typename Visita> void visita(int da, int a, Visita f) const;
+
+    std::unordered_map<std::string, int> idVoce; ///< valore -> id della voce
+    std::vector<Voce> voci;                      ///< valori distinti
+    std::vector<int> voceRiga;                   ///< id della riga -> id della voce (-1 = nessuna, -2 - v = rimossa dalla voce v)
+    int senzaData = 0;                           ///< righe presenti con data non interpretabile
+    mutable std::vector<int> perInizio;          ///< voci valide ordinate per anno iniziale
+    mutable std::vector<int> maxFine;            ///< albero dei massimi degli anni finali su perInizio
+    mutable size_t foglie = 0;                   ///< numero di foglie dell'albero
+    mutable bool aggiornato = true;              ///< true se perInizio e maxFine sono aggiornati
+};
+
+#endif // DATEINDEX_H
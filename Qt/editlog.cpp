@@ -0,0 +1,232 @@
+#include "editlog.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = {'C', 'A', 'T', 'W', 'A', 'L', '0', '1'};
+
+// Dimensione massima di un record: protegge la rilettura da lunghezze danneggiate
+const uint32_t MAX_RECORD = 64u << 20;
+
+void scrivi32(std::string& out, uint32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+bool leggi32(const std::string& s, size_t& pos, uint32_t& v) {
+    if (pos + sizeof(v) > s.size()) {
+        return false;
+    }
+    std::memcpy(&v, s.data() + pos, sizeof(v));
+    pos += sizeof(v);
+    return true;
+}
+
+// Scrive i valori di una riga: numero di valori, poi lunghezza e byte di ognuno
+void scriviValori(std::string& out, const std::vector<std::string>& valori) {
+    scrivi32(out, static_cast<uint32_t>(valori.size()));
+    for (const std::string& valore : valori) {
+        scrivi32(out, static_cast<uint32_t>(valore.size()));
+        out += valore;
+    }
+}
+
+// Legge i valori di una riga scritti da scriviValori
+bool leggiValori(const std::string& s, size_t& pos, std::vector<std::string>& valori) {
+    uint32_t n = 0;
+    bool valido = leggi32(s, pos, n);
+    for (uint32_t k = 0; valido && k < n; ++k) {
+        uint32_t lunghezza;
+        valido = leggi32(s, pos, lunghezza) && lunghezza <= s.size() - pos;
+        if (valido) {
+            valori.push_back(s.substr(pos, lunghezza));
+            pos += lunghezza;
+        }
+    }
+    return valido;
+}
+
+} // namespace
+
+
+// Calcola il CRC-32 (polinomio 0xEDB88320) di una sequenza di byte
+uint32_t EditLog::crc32(const char* dati, size_t n) {
+    // la tabella viene calcolata una volta sola, anche con più thread
+    static const std::array<uint32_t, 256> tabella = [] {
+        std::array<uint32_t, 256> t;
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; ++i) {
+        crc = tabella[(crc ^ static_cast<unsigned char>(dati[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+
+// Costruttore che apre (o crea) un registro in scrittura
+EditLog::EditLog(const std::string& percorso) : file(nullptr), nAttesa(0), scritti(0) {
+    file = std::fopen(percorso.c_str(), "ab");
+    if (file == nullptr) {
+        throw std::runtime_error("Impossibile aprire il registro delle modifiche");
+    }
+    std::fseek(file, 0, SEEK_END);
+    long dimensione = std::ftell(file);
+    if (dimensione == 0) {
+        attesa.append(MAGIC, sizeof(MAGIC));
+    } else {
+        scritti = static_cast<uint64_t>(dimensione);
+    }
+}
+
+
+// Distruttore: scrive i record in attesa e chiude il file
+EditLog::~EditLog() {
+    commit();
+    std::fclose(file);
+}
+
+
+// Aggiunge un record (lunghezza, CRC-32, contenuto) a quelli in attesa
+void EditLog::aggiungiRecord(const std::string& contenuto) {
+    scrivi32(attesa, static_cast<uint32_t>(contenuto.size()));
+    scrivi32(attesa, crc32(contenuto.data(), contenuto.size()));
+    attesa += contenuto;
+    ++nAttesa;
+}
+
+
+// Registra l'aggiunta di una riga
+void EditLog::add(const std::vector<std::string>& valori) {
+    std::string contenuto(1, static_cast<char>(AGGIUNTA));
+    scriviValori(contenuto, valori);
+    aggiungiRecord(contenuto);
+}
+
+
+// Registra l'eliminazione di una riga
+void EditLog::remove(uint64_t posizione) {
+    std::string contenuto(1, static_cast<char>(ELIMINAZIONE));
+    contenuto.append(reinterpret_cast<const char*>(&posizione), sizeof(posizione));
+    aggiungiRecord(contenuto);
+}
+
+
+// Registra l'inserimento di una riga in una posizione: la posizione precede i valori
+void EditLog::insert(uint64_t posizione, const std::vector<std::string>& valori) {
+    std::string contenuto(1, static_cast<char>(INSERIMENTO));
+    contenuto.append(reinterpret_cast<const char*>(&posizione), sizeof(posizione));
+    scriviValori(contenuto, valori);
+    aggiungiRecord(contenuto);
+}
+
+
+// Registra il ripristino della tabella iniziale
+void EditLog::reset() {
+    aggiungiRecord(std::string(1, static_cast<char>(RIPRISTINO)));
+}
+
+
+// Scrive tutti i record in attesa con una sola scrittura
+bool EditLog::commit(bool sincronizza) {
+    if (attesa.empty()) {
+        return true;
+    }
+    bool ok = std::fwrite(attesa.data(), 1, attesa.size(), file) == attesa.size() && std::fflush(file) == 0;
+#ifdef _WIN32
+    ok = ok && (!sincronizza || _commit(_fileno(file)) == 0);
+#else
+    ok = ok && (!sincronizza || fsync(fileno(file)) == 0);
+#endif
+    if (ok) {
+        scritti += attesa.size();
+        attesa.clear();
+        nAttesa = 0;
+    }
+    return ok;
+}
+
+
+// Ritorna il numero di record in attesa di commit
+size_t EditLog::pending() const {
+    return nAttesa;
+}
+
+
+// Ritorna la dimensione del registro, compresi i record in attesa
+uint64_t EditLog::size() const {
+    return scritti + attesa.size();
+}
+
+
+// Rilegge un registro fermandosi al primo record incompleto o danneggiato
+size_t EditLog::replay(const std::string& percorso, const std::function<void(const Operazione&)>& f) {
+    std::FILE* in = std::fopen(percorso.c_str(), "rb");
+    if (in == nullptr) {
+        return 0;
+    }
+    char magic[sizeof(MAGIC)];
+    if (std::fread(magic, 1, sizeof(magic), in) != sizeof(magic) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        std::fclose(in);
+        return 0;
+    }
+
+    size_t letti = 0;
+    std::string contenuto;
+    while (true) {
+        uint32_t testa[2];
+        if (std::fread(testa, sizeof(uint32_t), 2, in) != 2 || testa[0] == 0 || testa[0] > MAX_RECORD) {
+            break;
+        }
+        contenuto.resize(testa[0]);
+        if (std::fread(&contenuto[0], 1, contenuto.size(), in) != contenuto.size()
+            || crc32(contenuto.data(), contenuto.size()) != testa[1]) {
+            break;
+        }
+
+        Operazione op;
+        op.tipo = static_cast<Tipo>(static_cast<unsigned char>(contenuto[0]));
+        op.posizione = 0;
+        size_t pos = 1;
+        bool valido = true;
+        if (op.tipo == AGGIUNTA) {
+            valido = leggiValori(contenuto, pos, op.valori);
+        } else if (op.tipo == INSERIMENTO) {
+            valido = contenuto.size() >= 1 + sizeof(op.posizione);
+            if (valido) {
+                std::memcpy(&op.posizione, contenuto.data() + 1, sizeof(op.posizione));
+                pos += sizeof(op.posizione);
+                valido = leggiValori(contenuto, pos, op.valori);
+            }
+        } else if (op.tipo == ELIMINAZIONE) {
+            valido = contenuto.size() == 1 + sizeof(op.posizione);
+            if (valido) {
+                std::memcpy(&op.posizione, contenuto.data() + 1, sizeof(op.posizione));
+            }
+        } else if (op.tipo != RIPRISTINO) {
+            valido = false;
+        }
+        if (!valido) {
+            break;
+        }
+        f(op);
+        ++letti;
+    }
+    std::fclose(in);
+    return letti;
+}
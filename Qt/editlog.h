@@ -0,0 +1,147 @@
+/**
+ * @file editlog.h
+ *
+ * @brief File header della classe EditLog
+ *
+ * File di dichiarazioni della classe EditLog, un registro delle modifiche al catalogo
+ * scritto solo in coda, con un checksum per ogni operazione.
+ */
+
+#ifndef EDITLOG_H
+#define EDITLOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Registro delle modifiche al catalogo (write-ahead log).
+ *
+ * Ogni modifica (aggiunta di una riga, eliminazione di una riga, inserimento di una
+ * riga in una posizione, ripristino della tabella iniziale) diventa un record aggiunto in coda al file: lunghezza, CRC-32 e
+ * contenuto. I record vengono raccolti in memoria e scritti insieme da commit con una
+ * sola scrittura e una sola sincronizzazione su disco (group commit).
+ *
+ * La rilettura si ferma al primo record incompleto o con checksum errato, che può
+ * trovarsi solo in fondo al file dopo un'interruzione durante la scrittura.
+ */
+class EditLog {
+public:
+    /**
+     * @brief Tipi di operazione registrati.
+     */
+    enum Tipo {
+        AGGIUNTA = 1,     ///< riga aggiunta in fondo alla tabella
+        ELIMINAZIONE = 2, ///< riga eliminata in una certa posizione
+        RIPRISTINO = 3,   ///< tabella riportata ai dati iniziali
+        INSERIMENTO = 4   ///< riga inserita in una certa posizione (ad esempio annullando un'eliminazione)
+    };
+
+    /**
+     * @brief Operazione letta dal registro.
+     */
+    struct Operazione {
+        Tipo tipo;                       ///< tipo di operazione
+        std::vector<std::string> valori; ///< valori della riga aggiunta (AGGIUNTA, INSERIMENTO)
+        uint64_t posizione;              ///< posizione della riga eliminata o inserita (ELIMINAZIONE, INSERIMENTO)
+    };
+
+    /**
+     * @brief Costruttore che apre (o crea) un registro in scrittura.
+     *
+     * @param percorso il nome del file
+     *
+     * @throw std::runtime_error se il file non si può aprire o non è un registro
+     */
+    explicit EditLog(const std::string& percorso);
+
+    EditLog(const EditLog&) = delete;
+    EditLog& operator=(const EditLog&) = delete;
+
+    /**
+     * @brief Distruttore: scrive i record in attesa e chiude il file.
+     */
+    ~EditLog();
+
+    /**
+     * @brief Registra l'aggiunta di una riga.
+     *
+     * @param valori i valori della riga, uno per colonna
+     */
+    void add(const std::vector<std::string>& valori);
+
+    /**
+     * @brief Registra l'eliminazione di una riga.
+     *
+     * @param posizione la posizione della riga nella tabella
+     */
+    void remove(uint64_t posizione);
+
+    /**
+     * @brief Registra l'inserimento di una riga in una posizione.
+     *
+     * @param posizione la posizione della riga nella tabella dopo l'inserimento
+     * @param valori i valori della riga, uno per colonna
+     */
+    void insert(uint64_t posizione, const std::vector<std::string>& valori);
+
+    /**
+     * @brief Registra il ripristino della tabella iniziale.
+     */
+    void reset();
+
+    /**
+     * @brief Scrive tutti i record in attesa con una sola scrittura.
+     *
+     * @param sincronizza se true il file viene forzato su disco (fsync)
+     *
+     * @return true se la scrittura è andata a buon fine
+     */
+    bool commit(bool sincronizza = true);
+
+    /**
+     * @brief Ritorna il numero di record in attesa di commit.
+     *
+     * @return il numero di record
+     */
+    size_t pending() const;
+
+    /**
+     * @brief Ritorna la dimensione del registro, compresi i record in attesa.
+     *
+     * @return la dimensione in byte
+     */
+    uint64_t size() const;
+
+    /**
+     * @brief Rilegge un registro.
+     *
+     * @param percorso il nome del file
+     * @param f la funzione chiamata per ogni operazione, nell'ordine in cui è stata registrata
+     *
+     * @return il numero di operazioni lette (0 se il file non esiste)
+     */
+    static size_t replay(const std::string& percorso, const std::function<void(const Operazione&)>& f);
+
+    /**
+     * @brief Calcola il CRC-32 di una sequenza di byte.
+     *
+     * @param dati puntatore ai byte
+     * @param n il numero di byte
+     *
+     * @return il CRC-32
+     */
+    static uint32_t crc32(const char* dati, size_t n);
+
+private:
+    void aggiungiRecord(const std::string& contenuto);
+
+    std::FILE* file;     ///< il registro aperto in coda
+    std::string attesa;  ///< record in attesa di commit
+    size_t nAttesa;      ///< numero di record in attesa
+    uint64_t scritti;    ///< byte già scritti nel file
+};
+
+#endif // EDITLOG_H
@@ -1,11 +1,13 @@
 #include "CustomChartView.h"
-#include "set.h"
+#include "catalogresultsmodel.h"
+#include "catalogsnapshot.h"
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
 #include <QFile>
 #include <QByteArray>
 #include <QList>
+#include <QTableView>
 #include <QTableWidgetItem>
 #include <QtCharts>
 #include <QMap>
@@ -15,19 +17,47 @@
 #include <QtCharts/QBarSeries>
 #include <QtCharts/QBarCategoryAxis>
 #include <QDialog>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QTimer>
+#include <QHash>
+#include <QLabel>
+#include <QHeaderView>
+#include <QShortcut>
 #include <Qt>
 
+#include <stdexcept>
+
 using namespace QtCharts;
 
-QList<QByteArray> parseCSVLine(const QByteArray& line); //Dichiarazione della funzione per l'analisi delle righe di un file CSV
+// Snapshot compresso del catalogo, aperto all'avvio al posto del file CSV se presente
+const QString FILE_SNAPSHOT = "dipinti_uffizi.snap";
+// Prefisso dei file del registro delle modifiche e dei suoi checkpoint
+const char *const PREFISSO_REGISTRO = "dipinti_uffizi";
+// Righe mostrate dalla ricerca durante la digitazione: le altre si vedono premendo "cerca"
+const size_t RISULTATI_DIGITAZIONE = 1000;
+// Attesa prima di scrivere su disco le modifiche registrate, per raccoglierne più di una
+const int INTERVALLO_COMMIT_MS = 200;
+// Variabile d'ambiente con il file in cui scrivere la durata delle operazioni (trace JSON di Chrome)
+const char *const VARIABILE_TRACCIA = "UFFIZI_TRACE";
 
 // Costruttore per la classe MainWindow.
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , traccia(qEnvironmentVariable(VARIABILE_TRACCIA).toStdString())
+    , catalogo(&traccia)
+    , registro(PREFISSO_REGISTRO)
+    , ripristinoNelRegistro(true)
+    , risultati(nullptr)
+    , vistaRisultati(nullptr)
+    , tabellaFiltrata(false)
 {
+    Tracer::Scope misura(traccia, "avvio", "avvio");
+
     // si configura l'interfaccia utente
     ui->setupUi(this);
+    testiColonne.resize(COLONNE_CATALOGO);
 
     QWidget *widget = new QWidget();
     widget->setLayout(ui->verticalLayout);
@@ -48,94 +78,84 @@ MainWindow::MainWindow(QWidget *parent)
 
 
 
-    // si crea un oggetto QFile per leggere il file CSV
-    QFile f("dipinti_uffizi.csv");
-    // si apre il file in modalità di sola lettura
-    f.open(QIODevice::ReadOnly);
-
-    // vengono letti e memorizzati tutti i dati dal file
-    QByteArray data = f.readAll();
-
-    // si chiude il file
-    f.close();
-
-    // si imposta il numero di righe nella tabella in base al numero di linee nel file
-    ui->tableWidget->setRowCount(data.count('\n'));
-
-    // vengono divisi i dati in righe usando il carattere di nuova linea
-    QList<QByteArray> lines = data.split('\n');
-
-    // si itera su ogni riga del file CSV
-    for (int i = 0; i < lines.size(); ++i) {
-        QByteArray line = lines.at(i);
+    // se esiste uno snapshot del catalogo lo si apre al posto del file CSV, più lento da analizzare
+    if (!QFile::exists(FILE_SNAPSHOT) || !caricaSnapshot(FILE_SNAPSHOT)) {
+        caricaCSV();
+    }
+    // si riapplicano le modifiche fatte nelle sessioni precedenti
+    recuperaModifiche();
 
-        // si ignora la prima riga del file .csv (quella dove ci sono i titoli delle colonne)
-        if (i == 0) {
-            continue;
-        }
+    // le modifiche registrate vengono scritte su disco insieme, poco dopo l'ultima (group commit)
+    timerCommit.setSingleShot(true);
+    timerCommit.setInterval(INTERVALLO_COMMIT_MS);
+    connect(&timerCommit, &QTimer::timeout, this, &MainWindow::scriviModifiche);
 
-        // si analizza ogni riga del file CSV
-        QList<QByteArray> values = parseCSVLine(line);
-
-        // si crea un insieme di set di stringhe
-        Set<QString> setDipinti;
-        // si conta il numero di valori (colonne) nella riga corrente e lo memorizza in x
-        int x = values.count();
-        // se il numero di valori nella riga corrente è maggiore del numero di colonne nella tabella
-        // si aggiorna il numero di colonne della tabella per adattarsi
-        if (x > ui->tableWidget->columnCount())
-            ui->tableWidget->setColumnCount(x);
-
-        // si inizia un ciclo che itera su ogni valore (cella) nella riga corrente
-        for (int j = 0; j < values.count(); ++j) {
-            QByteArray cell = values.at(j);
-            // vengono rimossi le virgolette dalle celle
-            cell = cell.replace("\"", "");
-            // vengono aggiunti elementi al set
-            setDipinti.add(QString(cell));
-            // si crea il nuovo elemento nella tabella per ogni cella
-            QTableWidgetItem *item = new QTableWidgetItem(QString(cell));        
-            // cosi gli elementi della tabella saranno non modificabili
-            item->setFlags(item->flags() & ~Qt::ItemIsEditable);
-            // l'aggiunta dell'elemento nella tabella
-            ui->tableWidget->setItem(i - 1, j, item); // i - 1 perché abbiamo saltato la prima riga
-        }
-        setsData.append(setDipinti); // viene aggiunto il set di stringhe alla lista
-        originalData.append(setDipinti); // vengono conservati i dati originali
-    }
+    // le scorciatoie standard (Ctrl+Z, Ctrl+Y) annullano e ripristinano le modifiche alla tabella
+    connect(new QShortcut(QKeySequence::Undo, this), &QShortcut::activated, this, &MainWindow::annulla);
+    connect(new QShortcut(QKeySequence::Redo, this), &QShortcut::activated, this, &MainWindow::ripeti);
 
     // per alcuni label viene implementata opzione di andare a capo
     ui->label->setWordWrap(true);
     ui->label_2->setWordWrap(true);
     ui->label_3->setWordWrap(true);
 
+    // il campo di ricerca accetta anche interrogazioni con più predicati
+    ui->lineEdit_scelta->setPlaceholderText("Testo da cercare, oppure: Scuola = fiorentina AND Sala ~ Tribuna AND Data in 1500-1550");
+    ui->lineEdit_scelta->setToolTip("Operatori: = (uguale), ^= (inizia con), ~ (contiene), in (intervallo di anni sulla Data).\n"
+                                    "I predicati si combinano con AND.");
+
     // viene impostata la modalità di ridimensionamento dell'intestazione orizzontale e verticale.
     ui->tableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     ui->tableWidget->verticalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-}
 
+    // durante la digitazione i risultati vanno in una vista a parte, con un modello che contiene
+    // solo le righe trovate: ogni tasto costa quanto i risultati e non quanto la tabella completa
+    QStringList intestazioni;
+    for (int j = 0; j < COLONNE_CATALOGO; ++j) {
+        intestazioni << ui->tableWidget->horizontalHeaderItem(j)->text();
+    }
+    risultati = new CatalogResultsModel(catalogo, [this](int colonna, int id) { return testoCella(colonna, id); },
+                                        intestazioni, this);
+    vistaRisultati = new QTableView(this);
+    vistaRisultati->setModel(risultati);
+    vistaRisultati->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    vistaRisultati->setSelectionBehavior(QAbstractItemView::SelectRows);
+    vistaRisultati->setSelectionMode(QAbstractItemView::SingleSelection);
+    vistaRisultati->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    vistaRisultati->hide();
+    ui->verticalLayout_3->insertWidget(ui->verticalLayout_3->indexOf(ui->tableWidget) + 1, vistaRisultati);
+}
 
-// Funzione per analizzare una riga CSV
-QList<QByteArray> parseCSVLine(const QByteArray& line) {
-    QList<QByteArray> result;
-    bool inQuotes = false;
-    QByteArray current;
 
-    for (int i = 0; i < line.size(); ++i) {
-        if (line[i] == '\"') {
-            inQuotes = !inQuotes;
-        } else if (line[i] == ',' && !inQuotes) {
-            result.append(current.trimmed());
-            current.clear();
-        } else {
-            current.append(line[i]);
-        }
-    }
-    if (!current.isEmpty()) {
-        result.append(current.trimmed());
+// Legge il catalogo dal file CSV e popola la tabella
+void MainWindow::caricaCSV()
+{
+    // il catalogo legge e analizza il file, costruisce le tuple di id e gli indici
+    try {
+        catalogo.loadCsv("dipinti_uffizi.csv");
+    } catch (const std::runtime_error &e) {
+        QMessageBox::warning(this, "Attenzione", QString::fromUtf8(e.what()));
     }
+    ricaricaTabella();
+}
+
 
-    return result;
+// Apre uno snapshot del catalogo: le sue righe diventano la tabella iniziale.
+// Ritorna false (lasciando la tabella invariata) se il file non è uno snapshot valido.
+bool MainWindow::caricaSnapshot(const QString &percorso)
+{
+    std::vector<RigaCatalogo> righe;
+    try {
+        Tracer::Scope misura(traccia, "lettura snapshot", "avvio");
+        CatalogSnapshot snapshot(percorso.toStdString());
+        snapshot.readAll(catalogo.dictionary(), righe);
+    } catch (const std::runtime_error &e) {
+        QMessageBox::warning(this, "Attenzione", "Impossibile aprire lo snapshot " + percorso + ": " + QString::fromUtf8(e.what()));
+        return false;
+    }
+    catalogo.loadRows(righe);
+    ricaricaTabella();
+    return true;
 }
 
 
@@ -160,25 +180,26 @@ void MainWindow::on_pushButton_aggiungi_clicked()
         return;
     }
 
-    // si crea un nuovo set per il dipinto e si aggiungono i dati
-    Set<QString> nuovoDipinto;
-    nuovoDipinto.add(ui->lineEdit_scuola_aggiungi->text());
-    nuovoDipinto.add(ui->lineEdit_autore_aggiungi->text());
-    nuovoDipinto.add(ui->lineEdit_titolo_aggiungi->text());
-    nuovoDipinto.add(ui->lineEdit_data_aggiungi->text());
-    nuovoDipinto.add(ui->lineEdit_sala_aggiungi->text());
-
-    // si aggiunge il nuovo set alla lista di set
-    setsData.append(nuovoDipinto);
-
-    // aggiunge una nuova riga alla tabella per visualizzare il nuovo dipinto e popola le celle
-    int row = ui->tableWidget->rowCount();
+    // i dati del nuovo dipinto vengono convertiti negli id dei dizionari di colonna
+    std::vector<std::string> valori = {
+        ui->lineEdit_scuola_aggiungi->text().toStdString(),
+        ui->lineEdit_autore_aggiungi->text().toStdString(),
+        ui->lineEdit_titolo_aggiungi->text().toStdString(),
+        ui->lineEdit_data_aggiungi->text().toStdString(),
+        ui->lineEdit_sala_aggiungi->text().toStdString()
+    };
+    Tracer::Scope misura(traccia, "aggiunta", "modifiche");
+    // il dipinto riceve un id stabile e viene indicizzato per la ricerca e contato
+    int row = catalogo.add(valori);
+    // l'aggiunta viene registrata per ritrovarla al prossimo avvio
+    registro.add(valori);
+    pianificaCommit();
+
+    // aggiunge una nuova riga alla tabella per visualizzare il nuovo dipinto
     ui->tableWidget->insertRow(row);
-    ui->tableWidget->setItem(row, 0, new QTableWidgetItem(ui->lineEdit_scuola_aggiungi->text()));
-    ui->tableWidget->setItem(row, 1, new QTableWidgetItem(ui->lineEdit_autore_aggiungi->text()));
-    ui->tableWidget->setItem(row, 2, new QTableWidgetItem(ui->lineEdit_titolo_aggiungi->text()));
-    ui->tableWidget->setItem(row, 3, new QTableWidgetItem(ui->lineEdit_data_aggiungi->text()));
-    ui->tableWidget->setItem(row, 4, new QTableWidgetItem(ui->lineEdit_sala_aggiungi->text()));
+    inserisciRiga(row, catalogo.row(row), catalogo.rowId(row));
+    // il nuovo dipinto può essere tra i risultati della digitazione
+    aggiornaRisultati();
 
     // svuota i campi di input dopo l'inserimento
     ui->lineEdit_scuola_aggiungi->clear();
@@ -192,8 +213,12 @@ void MainWindow::on_pushButton_aggiungi_clicked()
 // Slot per gestire il click sul pulsante "elimina"
 void MainWindow::on_pushButton_elimina_clicked()
 {
-    // si ottiene la riga selezionata
+    // si ottiene la riga selezionata, nella tabella completa o tra i risultati della digitazione
     int row = ui->tableWidget->currentRow();
+    if (!vistaRisultati->isHidden()) {
+        int id = risultati->rowId(vistaRisultati->currentIndex().row());
+        row = id < 0 ? -1 : catalogo.position(id);
+    }
 
     // si controlla se una riga è selezionata
     if (row < 0) {
@@ -201,14 +226,17 @@ void MainWindow::on_pushButton_elimina_clicked()
         return;
     }
 
-    // si rimuove il set corrispondente e la riga dalla tabella
-    setsData.removeAt(row);
+    Tracer::Scope misura(traccia, "eliminazione", "modifiche");
+    // si rimuove la tupla corrispondente e la riga dalla tabella
+    catalogo.remove(row);
+    registro.remove(row);
+    pianificaCommit();
     ui->tableWidget->removeRow(row);
     // deseleziona qualsiasi riga dopo l'eliminazione
     ui->tableWidget->clearSelection();
     // viene impostata la riga corrente su un indice non valido
     ui->tableWidget->setCurrentCell(-1, -1);
-
+    aggiornaRisultati();
 }
 
 
@@ -225,18 +253,21 @@ void MainWindow::on_pushButton_cerca_clicked()
         return;
     }
 
-    // si cerca attraverso le righe della tabella
-    bool trovato = false;
-    for (int i = 0; i < ui->tableWidget->rowCount(); ++i) {
-           // Assumendo che il testo cercato si trovi nella colonna selezionata
-           QTableWidgetItem *item = ui->tableWidget->item(i, colonnaRicerca);
-           if (item && item->text() == ricercaTesto) {
-               ui->tableWidget->showRow(i);
-               trovato = true;
-           } else {
-               ui->tableWidget->hideRow(i);
-           }
-       }
+    // si cerca nella colonna selezionata oppure si esegue l'interrogazione con più predicati
+    std::vector<int> righe;
+    try {
+        Tracer::Scope misura(traccia, "ricerca", "ricerca");
+        righe = catalogo.search(ricercaTesto.toStdString(), colonnaRicerca);
+    } catch (const std::invalid_argument &e) {
+        QMessageBox::warning(this, "Attenzione", QString::fromUtf8(e.what()));
+        return;
+    }
+    bool trovato = !righe.empty();
+    {
+        Tracer::Scope misura(traccia, "visualizzazione risultati", "ricerca");
+        mostraTabella();
+        mostraRisultati(righe);
+    }
 
     if (!trovato) {
        QMessageBox::information(this, "Ricerca", "Nessun dipinto trovato con il titolo/soggetto specificato.");
@@ -250,22 +281,319 @@ void MainWindow::on_pushButton_cerca_clicked()
 // Slot per gestire il click sul pulsante "tabella iniziale"
 void MainWindow::on_pushButton_iniziale_clicked()
 {
+    // le righe iniziali sono la prima versione del catalogo: cambiano solo le righe modificate da allora
+    size_t prima = catalogo.version();
+    catalogo.reset();
+    // se il registro riporta ad altre righe iniziali si registrano le singole modifiche
+    if (ripristinoNelRegistro) {
+        registro.reset();
+        pianificaCommit();
+    }
+    aggiornaTabella(prima, !ripristinoNelRegistro);
+}
+
+
+// Slot per annullare l'ultima modifica tornando alla versione precedente del catalogo
+void MainWindow::annulla()
+{
+    Tracer::Scope misura(traccia, "annulla", "modifiche");
+    size_t prima = catalogo.version();
+    if (catalogo.undo()) {
+        aggiornaTabella(prima, true);
+    }
+}
+
+
+// Slot per ripristinare la modifica annullata
+void MainWindow::ripeti()
+{
+    Tracer::Scope misura(traccia, "ripeti", "modifiche");
+    size_t prima = catalogo.version();
+    if (catalogo.redo()) {
+        aggiornaTabella(prima, true);
+    }
+}
+
+
+// Porta la tabella dalla versione 'prima' del catalogo a quella corrente cambiando solo
+// le righe della differenza; se registra è true le stesse modifiche vanno nel registro
+void MainWindow::aggiornaTabella(size_t prima, bool registra)
+{
+    Catalog::Differenza modifica = catalogo.diff(prima, catalogo.version());
+    const PersistentRows &vecchie = catalogo.versionRows(prima);
+    // con molte righe cambiate conviene ricreare la tabella
+    bool ricrea = modifica.aggiunte.size() + modifica.rimosse.size() > static_cast<size_t>(catalogo.size()) / 2;
+
+    // le righe eliminate, dall'ultima alla prima, così le posizioni di quelle da eliminare non cambiano
+    for (std::vector<int>::const_reverse_iterator it = modifica.rimosse.crbegin(); it != modifica.rimosse.crend(); ++it) {
+        int row = vecchie.position(*it);
+        if (registra)
+            registro.remove(row);
+        if (!ricrea)
+            ui->tableWidget->removeRow(row);
+    }
+    // le righe nuove, in ordine di posizione: le righe che le precedono sono già al loro posto
+    for (int id : modifica.aggiunte) {
+        int row = catalogo.position(id);
+        if (registra)
+            registro.insert(row, catalogo.dictionary().values(catalogo.row(row)));
+        if (!ricrea) {
+            ui->tableWidget->insertRow(row);
+            inserisciRiga(row, catalogo.row(row), id);
+        }
+    }
+    if (registra)
+        pianificaCommit();
+    if (ricrea)
+        ricaricaTabella();
+    ui->tableWidget->clearSelection();
+    aggiornaRisultati();
+}
+
+
+// Ricrea la tabella a partire dalle righe correnti del catalogo
+void MainWindow::ricaricaTabella()
+{
+    Tracer::Scope misura(traccia, "popolamento tabella", "avvio");
     // si cancella la tabella corrente
     ui->tableWidget->setRowCount(0);
+    // le righe ricreate sono tutte visibili e nel loro ordine
+    tabellaFiltrata = false;
+
+    // si ricrea la tabella utilizzando le righe
+    ui->tableWidget->setRowCount(catalogo.size());
+    int newRow = 0;
+    catalogo.versionRows(catalogo.version()).forEach([this, &newRow](const RigaStabile &r) {
+        inserisciRiga(newRow++, r.riga, r.id);
+    });
+}
+
+
+// Ricostruisce le righe correnti dall'ultimo checkpoint e dal registro delle modifiche
+void MainWindow::recuperaModifiche()
+{
+    std::vector<RigaCatalogo> righe;
+    try {
+        Tracer::Scope misura(traccia, "recupero modifiche", "avvio");
+        if (!registro.recover(catalogo.dictionary(), catalogo.originalRows(), righe)) {
+            return;
+        }
+    } catch (const std::runtime_error &e) {
+        QMessageBox::warning(this, "Attenzione", "Impossibile recuperare le modifiche salvate: " + QString::fromUtf8(e.what()));
+        return;
+    }
+    catalogo.setRows(righe);
+    ricaricaTabella();
+}
+
+
+// Fa partire il timer del group commit, se non è già in attesa: le modifiche fatte
+// prima della scadenza vengono scritte su disco tutte insieme
+void MainWindow::pianificaCommit()
+{
+    if (!timerCommit.isActive()) {
+        timerCommit.start();
+    }
+}
+
+
+// Scrive su disco le modifiche registrate e, se il registro è cresciuto troppo,
+// salva le righe correnti in un checkpoint in un thread separato
+void MainWindow::scriviModifiche()
+{
+    Tracer::Scope misura(traccia, "commit del registro", "modifiche");
+    if (!registro.commit()) {
+        QMessageBox::warning(this, "Attenzione", "Impossibile salvare le ultime modifiche sul disco.");
+        return;
+    }
+    if (registro.needsCompaction()) {
+        registro.compact(catalogo.rows(), catalogo.dictionary());
+    }
+}
+
+
+// Slot per salvare le righe correnti in uno snapshot compresso del catalogo
+void MainWindow::on_actionSalva_snapshot_triggered()
+{
+    QString percorso = QFileDialog::getSaveFileName(this, "Salva snapshot del catalogo", FILE_SNAPSHOT,
+                                                    "Snapshot del catalogo (*.snap)");
+    if (percorso.isEmpty()) {
+        return;
+    }
+    try {
+        CatalogSnapshot::write(percorso.toStdString(), catalogo.rows(), catalogo.dictionary());
+        // lo snapshot letto all'avvio diventa la base del registro: le modifiche già
+        // registrate sono comprese nello snapshot e al prossimo avvio non vanno riapplicate
+        if (QFileInfo(percorso).absoluteFilePath() == QFileInfo(FILE_SNAPSHOT).absoluteFilePath()) {
+            registro.rebase(catalogo.rows(), catalogo.dictionary());
+            ripristinoNelRegistro = false;
+        }
+    } catch (const std::runtime_error &e) {
+        QMessageBox::warning(this, "Attenzione", QString::fromUtf8(e.what()));
+        return;
+    }
+    QMessageBox::information(this, "Snapshot", QString("Salvati %1 dipinti in %2.").arg(catalogo.size()).arg(percorso));
+}
+
+
+// Slot per aprire uno snapshot del catalogo al posto della tabella corrente
+void MainWindow::on_actionApri_snapshot_triggered()
+{
+    QString percorso = QFileDialog::getOpenFileName(this, "Apri snapshot del catalogo", QString(),
+                                                    "Snapshot del catalogo (*.snap)");
+    // le righe aperte diventano lo stato corrente anche per i prossimi avvii: si salvano in un checkpoint,
+    // aspettando l'eventuale compattazione in corso. Il registro riporta ancora alle righe lette
+    // all'avvio, quindi un ripristino verso quelle aperte va registrato modifica per modifica
+    if (!percorso.isEmpty() && caricaSnapshot(percorso)) {
+        registro.compact(catalogo.rows(), catalogo.dictionary());
+        ripristinoNelRegistro = false;
+    }
+}
+
+
+// Slot per la ricerca mentre l'utente scrive nel campo di ricerca: la misura comprende
+// l'aggiornamento della vista, non solo la ricerca nel catalogo
+void MainWindow::on_lineEdit_scelta_textEdited(const QString &testo)
+{
+    Tracer::Scope misura(traccia, "ricerca durante la digitazione", "ricerca");
+    QString ricercaTesto = testo.trimmed();
+    if (ricercaTesto.isEmpty()) {
+        mostraTabella();
+        mostraTutteLeRighe();
+        return;
+    }
+    try {
+        risultati->setResults(catalogo.search(ricercaTesto.toStdString(), ui->comboBox_scelta->currentIndex(),
+                                              RISULTATI_DIGITAZIONE));
+    } catch (const std::invalid_argument &) {
+        // l'interrogazione è ancora incompleta mentre l'utente scrive: la vista resta invariata
+        return;
+    }
+    // la tabella completa resta invariata e nascosta finché si mostrano i risultati
+    if (vistaRisultati->isHidden()) {
+        ui->tableWidget->hide();
+        vistaRisultati->show();
+    }
+    vistaRisultati->scrollToTop();
+}
+
+
+// Torna alla tabella completa al posto dei risultati della digitazione
+void MainWindow::mostraTabella()
+{
+    if (vistaRisultati->isHidden())
+        return;
+    vistaRisultati->hide();
+    risultati->setResults(std::vector<int>());
+    ui->tableWidget->show();
+}
+
+
+// Ripete la ricerca durante la digitazione dopo una modifica al catalogo, se i risultati sono mostrati
+void MainWindow::aggiornaRisultati()
+{
+    if (!vistaRisultati->isHidden())
+        on_lineEdit_scelta_textEdited(ui->lineEdit_scelta->text());
+}
+
+
+// Popola le celle di una riga della tabella a partire dalla sua tupla di id;
+// la prima cella conserva l'id stabile della riga nel catalogo
+void MainWindow::inserisciRiga(int row, const RigaCatalogo &riga, int id)
+{
+    for (int j = 0; j < COLONNE_CATALOGO; ++j) {
+        // il testo della cella condivide la stringa canonica del valore (implicit sharing)
+        QTableWidgetItem *item = new QTableWidgetItem(testoCella(j, riga[j]));
+        // cosi gli elementi della tabella saranno non modificabili
+        item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+        // la prima cella conserva l'id stabile della riga, usato dall'indice di ricerca
+        if (j == 0)
+            item->setData(Qt::UserRole, id);
+        ui->tableWidget->setItem(row, j, item);
+    }
+}
+
+
+// Ritorna la QString canonica di un valore di una colonna, creandola alla prima richiesta
+const QString &MainWindow::testoCella(int colonna, int id)
+{
+    QVector<QString> &testi = testiColonne[colonna];
+    while (testi.size() <= id) {
+        testi.append(QString::fromStdString(catalogo.dictionary().value(colonna, testi.size())));
+    }
+    return testi[id];
+}
+
+
+// Ritorna l'id stabile di una riga della tabella (conservato nella prima cella)
+int MainWindow::idRiga(int row) const
+{
+    QTableWidgetItem *item = ui->tableWidget->item(row, 0);
+    if (item == nullptr || !item->data(Qt::UserRole).isValid())
+        return -1;
+    return item->data(Qt::UserRole).toInt();
+}
 
-    // si ricrea la tabella utilizzando i dati originali
-    for (const Set<QString> &row : qAsConst(originalData)) {
-        int newRow = ui->tableWidget->rowCount();
-        ui->tableWidget->insertRow(newRow);
-
-        int j = 0;
-        for (const QString &value : row) {
-            QTableWidgetItem *item = new QTableWidgetItem(value);
-            item->setFlags(item->flags() & ~Qt::ItemIsEditable);
-            ui->tableWidget->setItem(newRow, j, item);
-            ++j;
+
+// Mostra solo le righe trovate, spostandole in cima alla tabella in ordine di rilevanza
+void MainWindow::mostraRisultati(const std::vector<int> &righe)
+{
+    tabellaFiltrata = true;
+    // si associa ad ogni id trovato la sua posizione nella classifica
+    QHash<int, int> posizione;
+    for (int k = 0; k < static_cast<int>(righe.size()); ++k) {
+        posizione.insert(righe[k], k);
+    }
+
+    ripristinaOrdine();
+
+    // righe della tabella in ordine di rilevanza
+    QVector<int> ordinate(static_cast<int>(righe.size()), -1);
+    for (int i = 0; i < ui->tableWidget->rowCount(); ++i) {
+        QHash<int, int>::const_iterator it = posizione.constFind(idRiga(i));
+        if (it != posizione.constEnd()) {
+            ui->tableWidget->showRow(i);
+            ordinate[it.value()] = i;
+        } else {
+            ui->tableWidget->hideRow(i);
+        }
+    }
+
+    // si spostano solo le sezioni dell'intestazione verticale, i dati della tabella restano invariati
+    QHeaderView *header = ui->tableWidget->verticalHeader();
+    int visuale = 0;
+    for (int row : qAsConst(ordinate)) {
+        if (row >= 0) {
+            header->moveSection(header->visualIndex(row), visuale++);
         }
     }
+    ui->tableWidget->scrollToTop();
+}
+
+
+// Mostra di nuovo tutte le righe della tabella nel loro ordine, se "cerca" ne ha nascoste
+void MainWindow::mostraTutteLeRighe()
+{
+    if (!tabellaFiltrata)
+        return;
+    tabellaFiltrata = false;
+    ripristinaOrdine();
+    for (int i = 0; i < ui->tableWidget->rowCount(); ++i) {
+        ui->tableWidget->showRow(i);
+    }
+}
+
+
+// Riporta le righe della tabella nel loro ordine originale dopo una ricerca
+void MainWindow::ripristinaOrdine()
+{
+    QHeaderView *header = ui->tableWidget->verticalHeader();
+    if (!header->sectionsMoved())
+        return;
+    for (int i = 0; i < ui->tableWidget->rowCount(); ++i) {
+        if (header->visualIndex(i) != i)
+            header->moveSection(header->visualIndex(i), i);
+    }
 }
 
 
@@ -274,18 +602,12 @@ void MainWindow::on_actionPercentuale_dipinti_per_Scuola_triggered()
 {
     // si crea un nuovo dialog
     QDialog *dialog = new QDialog(this);
+    // si misura la costruzione del grafico, senza il tempo in cui resta aperto
+    Tracer::Orologio::time_point inizio = Tracer::Orologio::now();
     dialog->setWindowTitle("Percentuale dipinti per Scuola");
 
-    // si crea una mappa per tenere traccia del conteggio degli elementi (dipinti per scuola)
-    QMap<QString, int> itemCount;
-    int totalItems = 0;
-
-    // Contaggio di ogni elemento per ogni Scuola
-    for (int i = 0; i < ui->tableWidget->rowCount(); ++i) {
-        QString itemText = ui->tableWidget->item(i, 0)->text();
-        itemCount[itemText]++;
-        totalItems++;
-    }
+    // si leggono le percentuali dei dipinti per scuola, calcolate dai conteggi già aggiornati ad ogni aggiunta ed eliminazione
+    std::vector<std::pair<std::string, double>> itemCount = catalogo.percentages(0);
 
     // si crea una serie di dati per il grafico a barre
     QBarSeries *series = new QBarSeries();
@@ -295,13 +617,11 @@ void MainWindow::on_actionPercentuale_dipinti_per_Scuola_triggered()
     QBarSet *set = new QBarSet("");
 
     // Controlla la percentuale di ogni elemento
-    for (auto it = itemCount.constBegin(); it != itemCount.constEnd(); ++it) {
-        // si calcola la percentuale di ogni categoria
-        double percent = (totalItems > 0) ? (static_cast<double>(it.value()) / totalItems * 100.0) : 0;
+    for (const std::pair<std::string, double> &it : itemCount) {
         // si aggiunge la percentuale al set di barre
-        *set << percent;
+        *set << it.second;
         // si aggiunge la categoria (scuola) alla lista delle categorie
-        categories << it.key();
+        categories << QString::fromStdString(it.first);
     }
     // si aggiunge il set di barre alla serie
     series->append(set);
@@ -349,6 +669,7 @@ void MainWindow::on_actionPercentuale_dipinti_per_Scuola_triggered()
     dialog->setLayout(layout);
     // si impostano le dimensioni del dialogo
     dialog->resize(1200, 1000);
+    traccia.record("grafico per scuola", "grafici", inizio, Tracer::Orologio::now());
     // si esegue il dialogo
     dialog->exec();
 }
@@ -359,27 +680,32 @@ void MainWindow::on_actionNumero_dipinti_per_Data_triggered()
 {
     // si crea un nuovo dialog
     QDialog *dialog = new QDialog(this);
-    dialog->setWindowTitle("Numero dipinti per Data");
+    // si misura la costruzione del grafico, senza il tempo in cui resta aperto
+    Tracer::Orologio::time_point inizio = Tracer::Orologio::now();
+    dialog->setWindowTitle("Numero dipinti per Data (per decennio)");
 
-    // si conta il numero totale di ogni elemento della quarta colonna
-    QMap<QString, int> itemCount;
-    for (int i = 0; i < ui->tableWidget->rowCount(); ++i) {
-        if (ui->tableWidget->item(i, 3) != nullptr) {
-            QString itemText = ui->tableWidget->item(i, 3)->text();
-            itemCount[itemText]++;
-        }
-    }
+    // le date sono già interpretate come intervalli di anni: ogni dipinto viene contato
+    // nel decennio del suo anno centrale, qualunque sia la grafia della data
+    std::vector<std::pair<int, int>> itemCount = catalogo.histogram(10);
 
     // si crea una serie di dati per il grafico a barre
     QBarSet *set = new QBarSet("");
-    // si crea una lista di stringhe per le categorie (date)
+    // si crea una lista di stringhe per le categorie (decenni)
     QStringList categories;
-    // si itera attraverso la mappa per popolare il grafico a barre
-    for (auto it = itemCount.constBegin(); it != itemCount.constEnd(); ++it) {
+    int massimo = 0;
+    // si itera attraverso l'istogramma per popolare il grafico a barre
+    for (const std::pair<int, int> &it : itemCount) {
         // si aggiunge il conteggio (numero di dipinti) al set di barre
-        *set << it.value();
-        // si aggiunge la data alla lista delle categorie
-        categories.append(it.key());
+        *set << it.second;
+        massimo = qMax(massimo, it.second);
+        // si aggiunge il decennio alla lista delle categorie
+        categories.append(QString("%1-%2").arg(it.first).arg(it.first + 9));
+    }
+    // i dipinti con una data non interpretabile hanno una barra a parte
+    if (catalogo.undatedCount() > 0) {
+        *set << catalogo.undatedCount();
+        massimo = qMax(massimo, catalogo.undatedCount());
+        categories.append("Senza data");
     }
 
     // si crea una nuova serie di barre
@@ -406,7 +732,7 @@ void MainWindow::on_actionNumero_dipinti_per_Data_triggered()
     // si crea un nuovo asse delle categorie per l'asse Y
     QValueAxis *axisY = new QValueAxis();
     // imposta l'intervallo dell'asse Y
-    axisY->setRange(-50, 50);
+    axisY->setRange(0, qMax(50, massimo));
     // si imposta il numero di tacche sull'asse Y
     axisY->setTickCount(21);
     // si aggiunge l'asse Y al grafico, allineandolo a sinistra
@@ -428,7 +754,45 @@ void MainWindow::on_actionNumero_dipinti_per_Data_triggered()
     dialog->setLayout(layout);
     // si impostano le dimensioni del dialogo
     dialog->resize(1200, 1000);
+    traccia.record("grafico per data", "grafici", inizio, Tracer::Orologio::now());
     // si esegue il dialogo
     dialog->exec();
 }
 
+
+// Slot per visualizzare il riepilogo della durata delle operazioni misurate
+void MainWindow::on_actionTempi_di_esecuzione_triggered()
+{
+    QDialog *dialog = new QDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setWindowTitle("Tempi di esecuzione");
+
+    // una riga per operazione: numero di esecuzioni, tempo totale, medio e massimo
+    std::vector<Tracer::Riepilogo> riepilogo = traccia.summary();
+    QTableWidget *tabella = new QTableWidget(static_cast<int>(riepilogo.size()), 5, dialog);
+    tabella->setHorizontalHeaderLabels({"Operazione", "Volte", "Totale (ms)", "Medio (ms)", "Massimo (ms)"});
+    tabella->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    tabella->verticalHeader()->hide();
+    for (int i = 0; i < static_cast<int>(riepilogo.size()); ++i) {
+        const Tracer::Riepilogo &r = riepilogo[i];
+        tabella->setItem(i, 0, new QTableWidgetItem(QString::fromStdString(r.nome)));
+        tabella->setItem(i, 1, new QTableWidgetItem(QString::number(r.volte)));
+        tabella->setItem(i, 2, new QTableWidgetItem(QString::number(r.totaleMs, 'f', 2)));
+        tabella->setItem(i, 3, new QTableWidgetItem(QString::number(r.totaleMs / r.volte, 'f', 2)));
+        tabella->setItem(i, 4, new QTableWidgetItem(QString::number(r.massimoMs, 'f', 2)));
+    }
+    tabella->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    // si indica dove vengono scritti gli eventi, oppure come chiederlo
+    QLabel *nota = new QLabel(traccia.writing()
+        ? "Eventi scritti in " + QString::fromStdString(traccia.path()) + " (apribile con chrome://tracing o Perfetto)."
+        : QString("Per salvare gli eventi avviare l'applicazione con la variabile d'ambiente %1=file.json.").arg(VARIABILE_TRACCIA),
+        dialog);
+    nota->setWordWrap(true);
+
+    QVBoxLayout *layout = new QVBoxLayout(dialog);
+    layout->addWidget(tabella);
+    layout->addWidget(nota);
+    dialog->resize(700, 400);
+    dialog->exec();
+}
@@ -10,7 +10,13 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include "set.h"
+#include <QVector>
+#include <QTimer>
+#include <QTableView>
+#include "catalog.h"
+#include "catalogresultsmodel.h"
+#include "catalogjournal.h"
+#include "tracer.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -39,10 +45,45 @@ private slots:
 
     void on_actionNumero_dipinti_per_Data_triggered();
 
+    void on_lineEdit_scelta_textEdited(const QString &testo);
+
+    void on_actionSalva_snapshot_triggered();
+
+    void on_actionApri_snapshot_triggered();
+
+    void on_actionTempi_di_esecuzione_triggered();
+
+    void annulla();
+
+    void ripeti();
+
 private:
+    void caricaCSV();
+    bool caricaSnapshot(const QString &percorso);
+    void ricaricaTabella();
+    void aggiornaTabella(size_t prima, bool registra);
+    void recuperaModifiche();
+    void pianificaCommit();
+    void scriviModifiche();
+    int idRiga(int row) const;
+    void inserisciRiga(int row, const RigaCatalogo &riga, int id);
+    const QString &testoCella(int colonna, int id);
+    void mostraRisultati(const std::vector<int> &righe);
+    void mostraTutteLeRighe();
+    void ripristinaOrdine();
+    void mostraTabella();
+    void aggiornaRisultati();
+
     Ui::MainWindow *ui;
-    QList<Set<QString>> originalData; // Lista di set per conservare ogni riga come un set distinto (tabella iniziale di copia)
-    QList<Set<QString>> setsData; // Lista di set per conservare ogni riga come un set distinto
+    Tracer traccia; // Durata delle operazioni, scritta come trace JSON se è impostata UFFIZI_TRACE
+    Catalog catalogo; // Versioni delle righe del catalogo (tuple di id dei valori), dizionari e indici
+    QVector<QVector<QString>> testiColonne; // Per ogni colonna: id del valore -> QString canonica condivisa dalle celle
+    CatalogJournal registro; // Registro delle aggiunte ed eliminazioni, rilette al prossimo avvio
+    bool ripristinoNelRegistro; // true se un ripristino riletto dal registro riporta alle righe iniziali del catalogo
+    QTimer timerCommit; // Scrive su disco insieme le modifiche registrate a breve distanza
+    CatalogResultsModel *risultati; // Righe trovate dalla ricerca durante la digitazione (al massimo RISULTATI_DIGITAZIONE)
+    QTableView *vistaRisultati; // Mostra i risultati della digitazione al posto della tabella completa
+    bool tabellaFiltrata; // true se "cerca" ha nascosto o spostato righe della tabella completa
 
 };
 #endif // MAINWINDOW_H
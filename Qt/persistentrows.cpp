@@ -0,0 +1,315 @@
+#include "persistentrows.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Nodo dell'albero: una foglia con le righe oppure un nodo interno con i figli.
+ *
+ * I nodi non vengono mai modificati dopo la creazione, quindi possono appartenere
+ * a più versioni contemporaneamente.
+ */
+struct PersistentRows::Nodo {
+    int totale;                     ///< righe nel sottoalbero
+    int idMassimo;                  ///< id più grande del sottoalbero
+    std::vector<RigaStabile> righe; ///< righe della foglia (vuoto nei nodi interni)
+    std::vector<PNodo> figli;       ///< figli del nodo interno (vuoto nelle foglie)
+};
+
+namespace {
+
+// Confronta una riga con un id, per le ricerche binarie nelle foglie
+bool primaDi(const RigaStabile& riga, int id) {
+    return riga.id < id;
+}
+
+} // namespace
+
+
+// Costruttore di default
+PersistentRows::PersistentRows() {
+}
+
+
+// Costruttore da una radice già costruita
+PersistentRows::PersistentRows(PNodo radice) : radice(std::move(radice)) {
+}
+
+
+// Dispone le righe in foglie piene e costruisce i livelli superiori
+PersistentRows::PersistentRows(const std::vector<RigaStabile>& righe) {
+    std::vector<PNodo> livello;
+    for (size_t i = 0; i < righe.size(); i += FOGLIA) {
+        size_t fine = std::min(righe.size(), i + FOGLIA);
+        livello.push_back(foglia(std::vector<RigaStabile>(righe.begin() + i, righe.begin() + fine)));
+    }
+    while (livello.size() > 1) {
+        std::vector<PNodo> superiore;
+        for (size_t i = 0; i < livello.size(); i += RAMI) {
+            size_t fine = std::min(livello.size(), i + RAMI);
+            superiore.push_back(interno(std::vector<PNodo>(livello.begin() + i, livello.begin() + fine)));
+        }
+        livello.swap(superiore);
+    }
+    if (!livello.empty()) {
+        radice = livello[0];
+    }
+}
+
+
+// Crea una foglia con le righe indicate (almeno una)
+PersistentRows::PNodo PersistentRows::foglia(std::vector<RigaStabile> righe) {
+    std::shared_ptr<Nodo> nodo = std::make_shared<Nodo>();
+    nodo->totale = static_cast<int>(righe.size());
+    nodo->idMassimo = righe.back().id;
+    nodo->righe = std::move(righe);
+    return nodo;
+}
+
+
+// Crea un nodo interno con i figli indicati (almeno uno)
+PersistentRows::PNodo PersistentRows::interno(std::vector<PNodo> figli) {
+    std::shared_ptr<Nodo> nodo = std::make_shared<Nodo>();
+    nodo->totale = 0;
+    for (const PNodo& figlio : figli) {
+        nodo->totale += figlio->totale;
+    }
+    nodo->idMassimo = figli.back()->idMassimo;
+    nodo->figli = std::move(figli);
+    return nodo;
+}
+
+
+// Inserisce una riga nel sottoalbero: il risultato è un nodo, oppure due se il nodo
+// è stato diviso (secondo != nullptr). Se la riga finisce in fondo a un nodo pieno,
+// come per le aggiunte in coda, il nodo resta pieno e la riga ne apre uno nuovo
+void PersistentRows::inserisci(const PNodo& nodo, const RigaStabile& riga, PNodo& primo, PNodo& secondo) {
+    secondo = nullptr;
+    if (nodo->figli.empty()) {
+        std::vector<RigaStabile> righe = nodo->righe;
+        std::vector<RigaStabile>::iterator it = std::lower_bound(righe.begin(), righe.end(), riga.id, primaDi);
+        bool inFondo = it == righe.end();
+        righe.insert(it, riga);
+        if (static_cast<int>(righe.size()) <= FOGLIA) {
+            primo = foglia(std::move(righe));
+            return;
+        }
+        size_t meta = inFondo ? righe.size() - 1 : righe.size() / 2;
+        secondo = foglia(std::vector<RigaStabile>(righe.begin() + meta, righe.end()));
+        righe.resize(meta);
+        primo = foglia(std::move(righe));
+        return;
+    }
+
+    // il figlio che contiene l'id, oppure l'ultimo se l'id è più grande di tutti
+    size_t i = 0;
+    while (i + 1 < nodo->figli.size() && nodo->figli[i]->idMassimo < riga.id) {
+        ++i;
+    }
+    PNodo a, b;
+    inserisci(nodo->figli[i], riga, a, b);
+    std::vector<PNodo> figli = nodo->figli;
+    figli[i] = a;
+    if (b) {
+        figli.insert(figli.begin() + i + 1, b);
+    }
+    if (static_cast<int>(figli.size()) <= RAMI) {
+        primo = interno(std::move(figli));
+        return;
+    }
+    size_t meta = (b && i + 2 == figli.size()) ? figli.size() - 1 : figli.size() / 2;
+    secondo = interno(std::vector<PNodo>(figli.begin() + meta, figli.end()));
+    figli.resize(meta);
+    primo = interno(std::move(figli));
+}
+
+
+// Elimina una riga dal sottoalbero: ritorna il nuovo nodo, nullptr se il sottoalbero
+// è rimasto vuoto, oppure il nodo stesso se la riga non c'era
+PersistentRows::PNodo PersistentRows::elimina(const PNodo& nodo, int id) {
+    if (nodo->figli.empty()) {
+        std::vector<RigaStabile>::const_iterator it = std::lower_bound(nodo->righe.begin(), nodo->righe.end(), id, primaDi);
+        if (it == nodo->righe.end() || it->id != id) {
+            return nodo;
+        }
+        if (nodo->righe.size() == 1) {
+            return nullptr;
+        }
+        std::vector<RigaStabile> righe;
+        righe.reserve(nodo->righe.size() - 1);
+        righe.insert(righe.end(), nodo->righe.begin(), it);
+        righe.insert(righe.end(), it + 1, nodo->righe.end());
+        return foglia(std::move(righe));
+    }
+
+    size_t i = 0;
+    while (i + 1 < nodo->figli.size() && nodo->figli[i]->idMassimo < id) {
+        ++i;
+    }
+    PNodo nuovo = elimina(nodo->figli[i], id);
+    if (nuovo == nodo->figli[i]) {
+        return nodo;
+    }
+    std::vector<PNodo> figli = nodo->figli;
+    if (!nuovo) {
+        figli.erase(figli.begin() + i);
+        if (figli.empty()) {
+            return nullptr;
+        }
+        return interno(std::move(figli));
+    }
+    figli[i] = nuovo;
+
+    // un figlio rimasto quasi vuoto viene unito a un fratello, se insieme stanno in un nodo
+    bool piccolo = nuovo->figli.empty() ? static_cast<int>(nuovo->righe.size()) < FOGLIA / 4
+                                        : static_cast<int>(nuovo->figli.size()) < RAMI / 4;
+    if (piccolo && figli.size() > 1) {
+        size_t j = (i + 1 < figli.size()) ? i + 1 : i - 1;
+        size_t sinistro = std::min(i, j);
+        const PNodo& a = figli[sinistro];
+        const PNodo& b = figli[sinistro + 1];
+        bool stanno = a->figli.empty() ? static_cast<int>(a->righe.size() + b->righe.size()) <= FOGLIA
+                                       : static_cast<int>(a->figli.size() + b->figli.size()) <= RAMI;
+        if (stanno) {
+            figli[sinistro] = unisci(a, b);
+            figli.erase(figli.begin() + sinistro + 1);
+        }
+    }
+    return interno(std::move(figli));
+}
+
+
+// Unisce due nodi vicini dello stesso livello in un solo nodo
+PersistentRows::PNodo PersistentRows::unisci(const PNodo& a, const PNodo& b) {
+    if (a->figli.empty()) {
+        std::vector<RigaStabile> righe = a->righe;
+        righe.insert(righe.end(), b->righe.begin(), b->righe.end());
+        return foglia(std::move(righe));
+    }
+    std::vector<PNodo> figli = a->figli;
+    figli.insert(figli.end(), b->figli.begin(), b->figli.end());
+    return interno(std::move(figli));
+}
+
+
+// Visita le righe del sottoalbero in ordine
+void PersistentRows::visita(const PNodo& nodo, const std::function<void(const RigaStabile&)>& f) {
+    for (const RigaStabile& riga : nodo->righe) {
+        f(riga);
+    }
+    for (const PNodo& figlio : nodo->figli) {
+        visita(figlio, f);
+    }
+}
+
+
+// Ritorna il numero di righe
+int PersistentRows::size() const {
+    return radice ? radice->totale : 0;
+}
+
+
+// Ritorna la riga in una posizione
+const RigaStabile& PersistentRows::at(int posizione) const {
+    if (posizione < 0 || posizione >= size()) {
+        throw std::out_of_range("Posizione della riga non valida");
+    }
+    const Nodo* nodo = radice.get();
+    while (!nodo->figli.empty()) {
+        size_t i = 0;
+        while (posizione >= nodo->figli[i]->totale) {
+            posizione -= nodo->figli[i]->totale;
+            ++i;
+        }
+        nodo = nodo->figli[i].get();
+    }
+    return nodo->righe[posizione];
+}
+
+
+// Cerca la riga con un id stabile
+const RigaStabile* PersistentRows::find(int id) const {
+    if (!radice || id > radice->idMassimo) {
+        return nullptr;
+    }
+    const Nodo* nodo = radice.get();
+    while (!nodo->figli.empty()) {
+        size_t i = 0;
+        while (nodo->figli[i]->idMassimo < id) {
+            ++i;
+        }
+        nodo = nodo->figli[i].get();
+    }
+    std::vector<RigaStabile>::const_iterator it = std::lower_bound(nodo->righe.begin(), nodo->righe.end(), id, primaDi);
+    return (it != nodo->righe.end() && it->id == id) ? &*it : nullptr;
+}
+
+
+// Ritorna la posizione della riga con un id stabile: le righe dei sottoalberi
+// con id più piccoli la precedono
+int PersistentRows::position(int id) const {
+    if (!radice || id > radice->idMassimo) {
+        return -1;
+    }
+    int posizione = 0;
+    const Nodo* nodo = radice.get();
+    while (!nodo->figli.empty()) {
+        size_t i = 0;
+        while (nodo->figli[i]->idMassimo < id) {
+            posizione += nodo->figli[i]->totale;
+            ++i;
+        }
+        nodo = nodo->figli[i].get();
+    }
+    std::vector<RigaStabile>::const_iterator it = std::lower_bound(nodo->righe.begin(), nodo->righe.end(), id, primaDi);
+    if (it == nodo->righe.end() || it->id != id) {
+        return -1;
+    }
+    return posizione + static_cast<int>(it - nodo->righe.begin());
+}
+
+
+// Ritorna una nuova versione con una riga in più
+PersistentRows PersistentRows::insert(const RigaStabile& riga) const {
+    if (!radice) {
+        return PersistentRows(foglia(std::vector<RigaStabile>(1, riga)));
+    }
+    PNodo primo, secondo;
+    inserisci(radice, riga, primo, secondo);
+    if (secondo) {
+        // la radice è stata divisa: l'albero cresce di un livello
+        return PersistentRows(interno(std::vector<PNodo>{primo, secondo}));
+    }
+    return PersistentRows(primo);
+}
+
+
+// Ritorna una nuova versione senza una riga
+PersistentRows PersistentRows::erase(int id) const {
+    if (!radice) {
+        return *this;
+    }
+    PNodo nuova = elimina(radice, id);
+    // una radice con un solo figlio viene sostituita dal figlio
+    while (nuova && !nuova->figli.empty() && nuova->figli.size() == 1) {
+        nuova = nuova->figli[0];
+    }
+    return PersistentRows(nuova);
+}
+
+
+// Chiama una funzione per ogni riga, in ordine di posizione
+void PersistentRows::forEach(const std::function<void(const RigaStabile&)>& f) const {
+    if (radice) {
+        visita(radice, f);
+    }
+}
+
+
+// Ritorna le righe in un vettore
+std::vector<RigaCatalogo> PersistentRows::rows() const {
+    std::vector<RigaCatalogo> result;
+    result.reserve(size());
+    forEach([&result](const RigaStabile& r) { result.push_back(r.riga); });
+    return result;
+}
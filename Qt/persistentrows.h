@@ -0,0 +1,144 @@
+/**
+ * @file persistentrows.h
+ *
+ * @brief File header della classe PersistentRows
+ *
+ * File di dichiarazioni della classe PersistentRows, le righe del catalogo in una
+ * struttura dati persistente: ogni modifica crea una nuova versione che condivide
+ * con la precedente tutti i nodi non toccati.
+ */
+
+#ifndef PERSISTENTROWS_H
+#define PERSISTENTROWS_H
+
+#include "stringpool.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Riga del catalogo con il suo id stabile.
+ */
+struct RigaStabile {
+    int id;            ///< id stabile della riga
+    RigaCatalogo riga; ///< id dei valori nei dizionari di colonna
+};
+
+/**
+ * @brief Righe del catalogo in un B-tree immutabile con nodi condivisi tra le versioni.
+ *
+ * Le righe sono in ordine di id stabile, che nel catalogo coincide con l'ordine di
+ * posizione: le righe nuove ricevono un id più grande di tutti e vanno in fondo, e
+ * un'eliminazione non cambia l'ordine delle altre. Le foglie contengono fino a FOGLIA
+ * righe; ogni nodo conosce il numero di righe e l'id più grande del suo sottoalbero,
+ * quindi sia l'accesso per posizione sia la ricerca per id scendono l'albero in O(log n).
+ *
+ * Un oggetto non cambia mai: insert ed erase restituiscono una nuova versione copiando
+ * solo i nodi sul percorso dalla radice alla foglia modificata, mentre tutti gli altri
+ * nodi sono condivisi (shared_ptr) con la versione di partenza. Copiare un
+ * PersistentRows costa O(1), e tenere in memoria molte versioni del catalogo costa
+ * solo le differenze tra l'una e l'altra.
+ */
+class PersistentRows {
+public:
+    /**
+     * @brief Costruttore di default, crea una sequenza vuota.
+     */
+    PersistentRows();
+
+    /**
+     * @brief Costruttore che dispone delle righe nelle foglie, in O(n).
+     *
+     * @param righe le righe, in ordine crescente di id
+     */
+    explicit PersistentRows(const std::vector<RigaStabile>& righe);
+
+    /**
+     * @brief Ritorna il numero di righe.
+     *
+     * @return il numero di righe
+     */
+    int size() const;
+
+    /**
+     * @brief Ritorna la riga in una posizione.
+     *
+     * @param posizione la posizione della riga
+     *
+     * @return la riga
+     *
+     * @throw std::out_of_range se la posizione non è valida
+     */
+    const RigaStabile& at(int posizione) const;
+
+    /**
+     * @brief Cerca la riga con un id stabile.
+     *
+     * @param id l'id stabile
+     *
+     * @return la riga, oppure nullptr se non è presente
+     */
+    const RigaStabile* find(int id) const;
+
+    /**
+     * @brief Ritorna la posizione della riga con un id stabile.
+     *
+     * @param id l'id stabile
+     *
+     * @return la posizione, oppure -1 se la riga non è presente
+     */
+    int position(int id) const;
+
+    /**
+     * @brief Ritorna una nuova versione con una riga in più, al posto indicato dal suo id.
+     *
+     * @param riga la riga da inserire, con un id non presente
+     *
+     * @return la nuova versione
+     */
+    PersistentRows insert(const RigaStabile& riga) const;
+
+    /**
+     * @brief Ritorna una nuova versione senza la riga con un id stabile.
+     *
+     * @param id l'id della riga da eliminare
+     *
+     * @return la nuova versione (questa stessa se la riga non è presente)
+     */
+    PersistentRows erase(int id) const;
+
+    /**
+     * @brief Chiama una funzione per ogni riga, in ordine di posizione.
+     *
+     * @param f la funzione
+     */
+    void forEach(const std::function<void(const RigaStabile&)>& f) const;
+
+    /**
+     * @brief Ritorna le righe in un vettore, in ordine di posizione.
+     *
+     * @return le righe
+     */
+    std::vector<RigaCatalogo> rows() const;
+
+private:
+    struct Nodo;
+    typedef std::shared_ptr<const Nodo> PNodo;
+
+    static const int FOGLIA = 32; ///< righe al massimo in una foglia
+    static const int RAMI = 32;   ///< figli al massimo in un nodo interno
+
+    static PNodo foglia(std::vector<RigaStabile> righe);
+    static PNodo interno(std::vector<PNodo> figli);
+    static void inserisci(const PNodo& nodo, const RigaStabile& riga, PNodo& primo, PNodo& secondo);
+    static PNodo elimina(const PNodo& nodo, int id);
+    static PNodo unisci(const PNodo& a, const PNodo& b);
+    static void visita(const PNodo& nodo, const std::function<void(const RigaStabile&)>& f);
+
+    explicit PersistentRows(PNodo radice);
+
+    PNodo radice; ///< radice dell'albero (nullptr se non ci sono righe)
+};
+
+#endif // PERSISTENTROWS_H
@@ -2,7 +2,7 @@ QT       += core gui
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets charts
 
-CONFIG += c++11
+CONFIG += c++17
 
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
@@ -10,13 +10,39 @@ CONFIG += c++11
 
 SOURCES += \
     CustomChartView.cpp \
+    blockcompress.cpp \
+    catalog.cpp \
+    catalogjournal.cpp \
+    catalogquery.cpp \
+    catalogresultsmodel.cpp \
+    catalogsnapshot.cpp \
+    columncounts.cpp \
+    dateindex.cpp \
+    editlog.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    persistentrows.cpp \
+    searchindex.cpp \
+    stringpool.cpp \
+    tracer.cpp
 
 HEADERS += \
     set.h \
     CustomChartView.h \
-    mainwindow.h
+    blockcompress.h \
+    catalog.h \
+    catalogjournal.h \
+    catalogquery.h \
+    catalogresultsmodel.h \
+    catalogsnapshot.h \
+    columncounts.h \
+    dateindex.h \
+    editlog.h \
+    mainwindow.h \
+    persistentrows.h \
+    searchindex.h \
+    stringpool.h \
+    tracer.h
 
 FORMS += \
     mainwindow.ui
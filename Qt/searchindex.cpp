@@ -0,0 +1,651 @@
+#include "searchindex.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Punteggi di base per ogni tipo di corrispondenza
+const int PUNTEGGIO[] = { 1000, 800, 600, 400, 200 };
+
+// Un carattere fa parte di una parola se è alfanumerico ASCII o un byte UTF-8 non ASCII
+bool carattereParola(unsigned char ch) {
+    return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch >= 0x80;
+}
+
+// Codifica tre byte in un intero a 32 bit
+uint32_t trigramma(const std::string& s, size_t i) {
+    return (uint32_t(static_cast<unsigned char>(s[i])) << 16)
+         | (uint32_t(static_cast<unsigned char>(s[i + 1])) << 8)
+         |  uint32_t(static_cast<unsigned char>(s[i + 2]));
+}
+
+// Ritorna i trigrammi distinti di una stringa
+std::vector<uint32_t> trigrammi(const std::string& s) {
+    std::vector<uint32_t> result;
+    for (size_t i = 0; i + 3 <= s.size(); ++i) {
+        result.push_back(trigramma(s, i));
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+// Divide un valore normalizzato nelle sue parole
+std::vector<std::string> parole(const std::string& s) {
+    std::vector<std::string> result;
+    size_t i = 0;
+    while (i < s.size()) {
+        while (i < s.size() && !carattereParola(s[i])) ++i;
+        size_t inizio = i;
+        while (i < s.size() && carattereParola(s[i])) ++i;
+        if (i > inizio) {
+            result.push_back(s.substr(inizio, i - inizio));
+        }
+    }
+    return result;
+}
+
+// Distanza di edit massima tollerata per una parola cercata
+int tolleranza(size_t lunghezza) {
+    if (lunghezza >= 8) return 2;
+    if (lunghezza >= 4) return 1;
+    return 0;
+}
+
+// Aggiunge un id in coda a una lista ordinata, evitando i doppioni consecutivi
+void aggiungiId(std::vector<int>& lista, int id) {
+    if (lista.empty() || lista.back() != id) {
+        lista.push_back(id);
+    }
+}
+
+} // namespace
+
+
+// Costruttore della classe SearchIndex
+SearchIndex::SearchIndex(int numColonne) : colonne(numColonne) {}
+
+
+// Aggiunge una riga all'indice
+void SearchIndex::addRow(int id, const std::vector<std::string>& valori) {
+    if (id < 0) {
+        return;
+    }
+    if (static_cast<size_t>(id) >= vive.size()) {
+        vive.resize(id + 1, 0);
+    }
+    vive[id] = 1;
+
+    // una riga rimossa e aggiunta di nuovo ha ancora le sue liste: basta riattivarla
+    for (const IndiceColonna& c : colonne) {
+        if (static_cast<size_t>(id) < c.terminiRiga.size() && c.terminiRiga[id] >= 0) {
+            return;
+        }
+    }
+
+    size_t n = std::min(valori.size(), colonne.size());
+    for (size_t j = 0; j < n; ++j) {
+        std::string valore = normalize(valori[j]);
+        if (valore.empty()) {
+            continue;
+        }
+        IndiceColonna& c = colonne[j];
+        std::unordered_map<std::string, int>::iterator it = c.idTermine.find(valore);
+        int termine;
+        if (it == c.idTermine.end()) {
+            // nuovo valore distinto: lo si memorizza e lo si indicizza una sola volta
+            termine = static_cast<int>(c.termini.size());
+            c.termini.push_back(valore);
+            c.idTermine.emplace(valore, termine);
+            c.righe.emplace_back();
+            indicizzaTermine(c, termine);
+        } else {
+            termine = it->second;
+        }
+        c.righe[termine].push_back(id);
+        if (static_cast<size_t>(id) >= c.terminiRiga.size()) {
+            c.terminiRiga.resize(id + 1, -1);
+        }
+        c.terminiRiga[id] = termine;
+    }
+}
+
+
+// Rimuove una riga dall'indice marcandola come eliminata
+void SearchIndex::removeRow(int id) {
+    if (id >= 0 && static_cast<size_t>(id) < vive.size()) {
+        vive[id] = 0;
+    }
+}
+
+
+// Svuota l'indice
+void SearchIndex::clear() {
+    size_t n = colonne.size();
+    colonne.clear();
+    colonne.resize(n);
+    vive.clear();
+}
+
+
+// Ordina i termini e le parole di tutte le colonne
+void SearchIndex::prepare() {
+    for (const IndiceColonna& c : colonne) {
+        ordina(c);
+    }
+}
+
+
+// Aggiorna i trigrammi, le parole e gli array ordinati per un nuovo termine
+void SearchIndex::indicizzaTermine(IndiceColonna& c, int termine) {
+    const std::string& valore = c.termini[termine];
+
+    for (uint32_t t : trigrammi(valore)) {
+        aggiungiId(c.trigrammiTermini[t], termine);
+    }
+
+    for (const std::string& p : parole(valore)) {
+        std::unordered_map<std::string, int>::iterator it = c.idParola.find(p);
+        int parola;
+        if (it == c.idParola.end()) {
+            parola = static_cast<int>(c.parole.size());
+            c.parole.push_back(p);
+            c.idParola.emplace(p, parola);
+            c.terminiParola.emplace_back();
+            // i trigrammi delle parole hanno i bordi, così anche le parole corte ne hanno almeno uno
+            for (uint32_t t : trigrammi("$" + p + "$")) {
+                aggiungiId(c.trigrammiParole[t], parola);
+            }
+            if (c.ordinato) {
+                std::vector<int>::iterator pos = std::lower_bound(c.paroleOrdinate.begin(), c.paroleOrdinate.end(), p,
+                    [&c](int a, const std::string& b) { return c.parole[a] < b; });
+                c.paroleOrdinate.insert(pos, parola);
+            }
+        } else {
+            parola = it->second;
+        }
+        aggiungiId(c.terminiParola[parola], termine);
+    }
+
+    // dopo il primo ordinamento gli array vengono mantenuti ordinati con inserimenti puntuali
+    if (c.ordinato) {
+        std::vector<int>::iterator pos = std::lower_bound(c.terminiOrdinati.begin(), c.terminiOrdinati.end(), valore,
+            [&c](int a, const std::string& b) { return c.termini[a] < b; });
+        c.terminiOrdinati.insert(pos, termine);
+    }
+}
+
+
+// Ordina i termini e le parole di una colonna, se necessario
+void SearchIndex::ordina(const IndiceColonna& c) const {
+    if (c.ordinato) {
+        return;
+    }
+    c.terminiOrdinati.resize(c.termini.size());
+    std::iota(c.terminiOrdinati.begin(), c.terminiOrdinati.end(), 0);
+    std::sort(c.terminiOrdinati.begin(), c.terminiOrdinati.end(),
+        [&c](int a, int b) { return c.termini[a] < c.termini[b]; });
+
+    c.paroleOrdinate.resize(c.parole.size());
+    std::iota(c.paroleOrdinate.begin(), c.paroleOrdinate.end(), 0);
+    std::sort(c.paroleOrdinate.begin(), c.paroleOrdinate.end(),
+        [&c](int a, int b) { return c.parole[a] < c.parole[b]; });
+
+    c.ordinato = true;
+}
+
+
+// Ritorna i termini che contengono il testo normalizzato: si intersecano le liste
+// dei trigrammi partendo dalla più corta e si verificano i candidati rimasti
+std::vector<int> SearchIndex::terminiSottostringa(const IndiceColonna& c, const std::string& q) const {
+    std::vector<int> result;
+    if (q.size() < 3) {
+        // senza trigrammi si verificano tutti i termini distinti
+        for (int termine = 0; termine < static_cast<int>(c.termini.size()); ++termine) {
+            if (c.termini[termine].find(q) != std::string::npos) {
+                result.push_back(termine);
+            }
+        }
+        return result;
+    }
+
+    std::vector<const std::vector<int>*> liste;
+    for (uint32_t t : trigrammi(q)) {
+        std::unordered_map<uint32_t, std::vector<int>>::const_iterator l = c.trigrammiTermini.find(t);
+        if (l == c.trigrammiTermini.end()) {
+            return result;
+        }
+        liste.push_back(&l->second);
+    }
+    std::sort(liste.begin(), liste.end(),
+        [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+    std::vector<int> candidati = *liste[0];
+    // con pochi candidati conviene verificarli direttamente invece di intersecare ancora
+    for (size_t i = 1; i < liste.size() && candidati.size() > 64; ++i) {
+        std::vector<int> intersezione;
+        std::set_intersection(candidati.begin(), candidati.end(), liste[i]->begin(), liste[i]->end(),
+                              std::back_inserter(intersezione));
+        candidati.swap(intersezione);
+    }
+    for (int termine : candidati) {
+        if (c.termini[termine].find(q) != std::string::npos) {
+            result.push_back(termine);
+        }
+    }
+    return result;
+}
+
+
+// Ritorna i termini di una colonna che corrispondono al testo normalizzato con il tipo indicato
+std::vector<int> SearchIndex::terminiCorrispondenti(const IndiceColonna& c, const std::string& q, Corrispondenza tipo) const {
+    std::vector<int> result;
+    switch (tipo) {
+    case ESATTA: {
+        std::unordered_map<std::string, int>::const_iterator esatto = c.idTermine.find(q);
+        if (esatto != c.idTermine.end()) {
+            result.push_back(esatto->second);
+        }
+        break;
+    }
+    case PREFISSO: {
+        ordina(c);
+        std::vector<int>::const_iterator it = std::lower_bound(c.terminiOrdinati.begin(), c.terminiOrdinati.end(), q,
+            [&c](int a, const std::string& b) { return c.termini[a] < b; });
+        for (; it != c.terminiOrdinati.end() && c.termini[*it].compare(0, q.size(), q) == 0; ++it) {
+            result.push_back(*it);
+        }
+        break;
+    }
+    case PREFISSO_PAROLA: {
+        ordina(c);
+        std::vector<int>::const_iterator it = std::lower_bound(c.paroleOrdinate.begin(), c.paroleOrdinate.end(), q,
+            [&c](int a, const std::string& b) { return c.parole[a] < b; });
+        for (; it != c.paroleOrdinate.end() && c.parole[*it].compare(0, q.size(), q) == 0; ++it) {
+            result.insert(result.end(), c.terminiParola[*it].begin(), c.terminiParola[*it].end());
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        break;
+    }
+    case SOTTOSTRINGA:
+        result = terminiSottostringa(c, q);
+        break;
+    case APPROSSIMATA:
+        for (const Trovato& t : cercaColonna(c, q, 0)) {
+            result.push_back(t.termine);
+        }
+        break;
+    }
+    return result;
+}
+
+
+// Ritorna le righe vive, ordinate per id, il cui valore corrisponde al testo
+std::vector<int> SearchIndex::rows(int colonna, const std::string& testo, Corrispondenza tipo) const {
+    std::vector<int> result;
+    if (colonna < 0 || colonna >= static_cast<int>(colonne.size())) {
+        return result;
+    }
+    const IndiceColonna& c = colonne[colonna];
+    for (int termine : terminiCorrispondenti(c, normalize(testo), tipo)) {
+        for (int riga : c.righe[termine]) {
+            if (vive[riga]) {
+                result.push_back(riga);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+
+// Ritorna le righe vive, ordinate per id, il cui valore soddisfa il predicato
+std::vector<int> SearchIndex::rowsWhere(int colonna, const std::function<bool(const std::string&)>& predicato) const {
+    std::vector<int> result;
+    if (colonna < 0 || colonna >= static_cast<int>(colonne.size())) {
+        return result;
+    }
+    // il predicato viene valutato una sola volta per ogni valore distinto
+    const IndiceColonna& c = colonne[colonna];
+    for (size_t termine = 0; termine < c.termini.size(); ++termine) {
+        if (predicato(c.termini[termine])) {
+            for (int riga : c.righe[termine]) {
+                if (vive[riga]) {
+                    result.push_back(riga);
+                }
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+
+// Stima il numero di righe che corrispondono al testo, senza materializzarle
+size_t SearchIndex::estimate(int colonna, const std::string& testo, Corrispondenza tipo) const {
+    if (colonna < 0 || colonna >= static_cast<int>(colonne.size())) {
+        return 0;
+    }
+    const IndiceColonna& c = colonne[colonna];
+    size_t result = 0;
+    for (int termine : terminiCorrispondenti(c, normalize(testo), tipo)) {
+        result += c.righe[termine].size();
+    }
+    return result;
+}
+
+
+// Ritorna il valore normalizzato di una riga in una colonna, oppure nullptr
+const std::string* SearchIndex::value(int riga, int colonna) const {
+    if (colonna < 0 || colonna >= static_cast<int>(colonne.size()) || riga < 0 || !contains(riga)) {
+        return nullptr;
+    }
+    const IndiceColonna& c = colonne[colonna];
+    if (static_cast<size_t>(riga) >= c.terminiRiga.size() || c.terminiRiga[riga] < 0) {
+        return nullptr;
+    }
+    return &c.termini[c.terminiRiga[riga]];
+}
+
+
+// Controlla se una riga è presente nell'indice
+bool SearchIndex::contains(int riga) const {
+    return riga >= 0 && static_cast<size_t>(riga) < vive.size() && vive[riga];
+}
+
+
+// Ritorna il numero di id di riga assegnati (comprese le righe eliminate)
+size_t SearchIndex::rowCount() const {
+    return vive.size();
+}
+
+
+// Cerca il testo normalizzato nei termini di una colonna.
+// Le fasi vengono eseguite in ordine di rilevanza; quando le fasi già eseguite
+// coprono almeno 'bastano' righe vive, le fasi meno rilevanti vengono saltate.
+std::vector<SearchIndex::Trovato> SearchIndex::cercaColonna(const IndiceColonna& c, const std::string& q, size_t bastano) const {
+    ordina(c);
+    // il vettore dei termini già trovati si riusa tra le ricerche e si azzera solo dove è cambiato
+    c.trovati.resize(c.termini.size(), 0);
+    std::vector<Trovato> result;
+    cercaFasi(c, q, bastano, result);
+    for (const Trovato& t : result) {
+        c.trovati[t.termine] = 0;
+    }
+    return result;
+}
+
+
+// Esegue le fasi della ricerca in una colonna, aggiungendo a result i termini trovati
+void SearchIndex::cercaFasi(const IndiceColonna& c, const std::string& q, size_t bastano, std::vector<Trovato>& result) const {
+    const unsigned char NESSUNA = 255;
+    size_t righeTrovate = 0;
+    auto segna = [&](int termine, Corrispondenza tipo, int distanza) {
+        if (!c.trovati[termine]) {
+            c.trovati[termine] = 1;
+            result.push_back(Trovato{termine, tipo, distanza});
+            if (bastano > 0 && righeTrovate < bastano) {
+                for (int riga : c.righe[termine]) {
+                    if (vive[riga] && ++righeTrovate >= bastano) break;
+                }
+            }
+        }
+    };
+    auto abbastanza = [&]() { return bastano > 0 && righeTrovate >= bastano; };
+
+    // ricerca esatta
+    std::unordered_map<std::string, int>::const_iterator esatto = c.idTermine.find(q);
+    if (esatto != c.idTermine.end()) {
+        segna(esatto->second, ESATTA, 0);
+    }
+
+    // ricerca per prefisso del valore, sull'array ordinato dei termini
+    std::vector<int>::const_iterator it = std::lower_bound(c.terminiOrdinati.begin(), c.terminiOrdinati.end(), q,
+        [&c](int a, const std::string& b) { return c.termini[a] < b; });
+    for (; it != c.terminiOrdinati.end() && c.termini[*it].compare(0, q.size(), q) == 0; ++it) {
+        segna(*it, PREFISSO, 0);
+    }
+    if (abbastanza()) return;
+
+    // ricerca per prefisso di una parola, sull'array ordinato delle parole
+    it = std::lower_bound(c.paroleOrdinate.begin(), c.paroleOrdinate.end(), q,
+        [&c](int a, const std::string& b) { return c.parole[a] < b; });
+    for (; it != c.paroleOrdinate.end() && c.parole[*it].compare(0, q.size(), q) == 0; ++it) {
+        for (int termine : c.terminiParola[*it]) {
+            segna(termine, PREFISSO_PAROLA, 0);
+        }
+    }
+    if (abbastanza()) return;
+
+    // ricerca per sottostringa (le parole cercate di uno o due caratteri sono già coperte dai prefissi)
+    if (q.size() >= 3) {
+        for (int termine : terminiSottostringa(c, q)) {
+            segna(termine, SOTTOSTRINGA, 0);
+        }
+    }
+    if (abbastanza()) return;
+
+    // ricerca approssimata: ogni parola cercata deve corrispondere a una parola del termine.
+    // Per ogni parola cercata si trovano prima le parole dell'indice a distanza limitata.
+    std::vector<std::string> token = parole(q);
+    std::vector<std::vector<std::pair<int, int>>> trovate(token.size()); // parola -> distanza
+    std::vector<size_t> stime(token.size(), 0);
+    for (size_t k = 0; k < token.size(); ++k) {
+        const std::string& tok = token[k];
+        bool ultimo = (k + 1 == token.size());
+        int limite = tolleranza(tok.size());
+        std::unordered_map<int, int> distanzaParole;
+
+        // l'ultima parola cercata può essere ancora incompleta: vale come prefisso
+        std::vector<int>::const_iterator p = std::lower_bound(c.paroleOrdinate.begin(), c.paroleOrdinate.end(), tok,
+            [&c](int a, const std::string& b) { return c.parole[a] < b; });
+        for (; p != c.paroleOrdinate.end() && c.parole[*p].compare(0, tok.size(), tok) == 0; ++p) {
+            if (ultimo || c.parole[*p].size() == tok.size()) {
+                distanzaParole[*p] = 0;
+            }
+        }
+
+        if (limite > 0) {
+            // filtro sui trigrammi: ogni modifica distrugge al più tre trigrammi con bordi
+            int soglia = static_cast<int>(tok.size()) - 3 * limite;
+            std::unordered_map<int, int> conteggi;
+            for (uint32_t t : trigrammi("$" + tok + "$")) {
+                std::unordered_map<uint32_t, std::vector<int>>::const_iterator l = c.trigrammiParole.find(t);
+                if (l != c.trigrammiParole.end()) {
+                    for (int parola : l->second) {
+                        ++conteggi[parola];
+                    }
+                }
+            }
+            for (const std::pair<const int, int>& conteggio : conteggi) {
+                const std::string& parola = c.parole[conteggio.first];
+                if (conteggio.second < soglia || distanzaParole.count(conteggio.first)) {
+                    continue;
+                }
+                if (parola.size() + limite < tok.size() || parola.size() > tok.size() + limite) {
+                    continue;
+                }
+                int d = boundedDistance(tok, parola, limite);
+                if (d <= limite) {
+                    distanzaParole[conteggio.first] = d;
+                }
+            }
+        }
+
+        for (const std::pair<const int, int>& trovata : distanzaParole) {
+            trovate[k].push_back(trovata);
+            stime[k] += c.terminiParola[trovata.first].size();
+        }
+        if (trovate[k].empty()) {
+            return;
+        }
+    }
+
+    // si parte dalla parola cercata più selettiva e si filtrano i candidati con le altre
+    std::vector<size_t> ordine(token.size());
+    std::iota(ordine.begin(), ordine.end(), 0);
+    std::sort(ordine.begin(), ordine.end(), [&stime](size_t a, size_t b) { return stime[a] < stime[b]; });
+
+    std::vector<int> candidati;
+    std::vector<unsigned char> distanze(c.termini.size(), NESSUNA);
+    for (size_t k = 0; k < ordine.size() && (k == 0 || !candidati.empty()); ++k) {
+        std::vector<unsigned char> distanzeToken(k == 0 ? 0 : c.termini.size(), NESSUNA);
+        std::vector<unsigned char>& dest = (k == 0) ? distanze : distanzeToken;
+        for (const std::pair<int, int>& trovata : trovate[ordine[k]]) {
+            for (int termine : c.terminiParola[trovata.first]) {
+                if (dest[termine] == NESSUNA) {
+                    if (k == 0) candidati.push_back(termine);
+                    dest[termine] = static_cast<unsigned char>(trovata.second);
+                } else if (trovata.second < dest[termine]) {
+                    dest[termine] = static_cast<unsigned char>(trovata.second);
+                }
+            }
+        }
+        if (k > 0) {
+            std::vector<int> rimasti;
+            for (int termine : candidati) {
+                if (distanzeToken[termine] != NESSUNA) {
+                    distanze[termine] = static_cast<unsigned char>(distanze[termine] + distanzeToken[termine]);
+                    rimasti.push_back(termine);
+                }
+            }
+            candidati.swap(rimasti);
+        }
+    }
+    // con un limite di righe basta ordinare i candidati migliori (ogni termine ha almeno una riga);
+    // se le loro righe sono state eliminate si ordinano anche gli altri prima di proseguire
+    auto migliore = [&c, &distanze](int a, int b) {
+        if (distanze[a] != distanze[b]) return distanze[a] < distanze[b];
+        if (c.termini[a].size() != c.termini[b].size()) return c.termini[a].size() < c.termini[b].size();
+        return a < b; // come nell'ordinamento dei risultati, così il limite non cambia quali termini restano
+    };
+    size_t ordinati = candidati.size();
+    if (bastano > 0) {
+        ordinati = std::min(bastano, candidati.size());
+        std::partial_sort(candidati.begin(), candidati.begin() + ordinati, candidati.end(), migliore);
+    }
+    for (size_t k = 0; k < candidati.size() && !abbastanza(); ++k) {
+        if (k == ordinati) {
+            std::sort(candidati.begin() + ordinati, candidati.end(), migliore);
+            ordinati = candidati.size();
+        }
+        segna(candidati[k], APPROSSIMATA, distanze[candidati[k]]);
+    }
+}
+
+
+// Esegue una ricerca su una o tutte le colonne
+std::vector<SearchIndex::Risultato> SearchIndex::search(const std::string& testo, int colonna, size_t limite) const {
+    std::vector<Risultato> result;
+    std::string q = normalize(testo);
+    if (q.empty()) {
+        return result;
+    }
+
+    struct Candidato {
+        int punteggio;
+        size_t lunghezza;
+        int colonna;
+        int termine;
+        Corrispondenza tipo;
+    };
+    std::vector<Candidato> candidati;
+
+    int prima = (colonna < 0) ? 0 : colonna;
+    int ultima = (colonna < 0) ? static_cast<int>(colonne.size()) - 1 : colonna;
+    for (int j = prima; j <= ultima && j < static_cast<int>(colonne.size()); ++j) {
+        const IndiceColonna& c = colonne[j];
+        for (const Trovato& t : cercaColonna(c, q, limite)) {
+            int punteggio = PUNTEGGIO[t.tipo] - 20 * t.distanza;
+            candidati.push_back(Candidato{punteggio, c.termini[t.termine].size(), j, t.termine, t.tipo});
+        }
+    }
+
+    auto migliore = [](const Candidato& a, const Candidato& b) {
+        if (a.punteggio != b.punteggio) return a.punteggio > b.punteggio;
+        if (a.lunghezza != b.lunghezza) return a.lunghezza < b.lunghezza;
+        if (a.colonna != b.colonna) return a.colonna < b.colonna;
+        return a.termine < b.termine;
+    };
+    // con un limite si ordinano prima solo i candidati migliori (ogni termine ha almeno una riga);
+    // gli altri si ordinano solo se le righe eliminate non bastano a raggiungere il limite
+    size_t ordinati = candidati.size();
+    if (limite > 0 && candidati.size() > limite) {
+        std::partial_sort(candidati.begin(), candidati.begin() + limite, candidati.end(), migliore);
+        ordinati = limite;
+    } else {
+        std::sort(candidati.begin(), candidati.end(), migliore);
+    }
+
+    // si espandono i termini nelle righe, tenendo per ogni riga la corrispondenza migliore;
+    // il vettore delle righe inserite si riusa tra le ricerche e si azzera solo dove è cambiato
+    inserita.resize(vive.size(), 0);
+    for (size_t k = 0; k < candidati.size() && (limite == 0 || result.size() < limite); ++k) {
+        if (k == ordinati) {
+            std::sort(candidati.begin() + ordinati, candidati.end(), migliore);
+            ordinati = candidati.size();
+        }
+        const Candidato& cand = candidati[k];
+        for (int riga : colonne[cand.colonna].righe[cand.termine]) {
+            if (!vive[riga] || inserita[riga]) {
+                continue;
+            }
+            inserita[riga] = 1;
+            result.push_back(Risultato{riga, cand.colonna, cand.punteggio, cand.tipo});
+            if (limite > 0 && result.size() >= limite) {
+                break;
+            }
+        }
+    }
+    for (const Risultato& r : result) {
+        inserita[r.riga] = 0;
+    }
+    return result;
+}
+
+
+// Normalizza un valore: minuscolo ASCII e spazi compattati
+std::string SearchIndex::normalize(const std::string& s) {
+    std::string result;
+    result.reserve(s.size());
+    bool spazio = false;
+    for (unsigned char ch : s) {
+        if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n') {
+            spazio = !result.empty();
+            continue;
+        }
+        if (spazio) {
+            result += ' ';
+            spazio = false;
+        }
+        result += (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : static_cast<char>(ch);
+    }
+    return result;
+}
+
+
+// Distanza di Levenshtein con uscita anticipata oltre il limite
+int SearchIndex::boundedDistance(const std::string& a, const std::string& b, int limite) {
+    int n = static_cast<int>(a.size());
+    int m = static_cast<int>(b.size());
+    if (n - m > limite || m - n > limite) {
+        return limite + 1;
+    }
+    std::vector<int> precedente(m + 1), corrente(m + 1);
+    std::iota(precedente.begin(), precedente.end(), 0);
+    for (int i = 1; i <= n; ++i) {
+        corrente[0] = i;
+        int minimo = corrente[0];
+        for (int j = 1; j <= m; ++j) {
+            int costo = (a[i - 1] == b[j - 1]) ? 0 : 1;
+            corrente[j] = std::min({precedente[j] + 1, corrente[j - 1] + 1, precedente[j - 1] + costo});
+            minimo = std::min(minimo, corrente[j]);
+        }
+        if (minimo > limite) {
+            return limite + 1;
+        }
+        precedente.swap(corrente);
+    }
+    return std::min(precedente[m], limite + 1);
+}
@@ -0,0 +1,238 @@
+/**
+ * @file searchindex.h
+ *
+ * @brief File header della classe SearchIndex
+ *
+ * File di dichiarazioni della classe SearchIndex, un indice di ricerca sulle colonne
+ * del catalogo che supporta la ricerca esatta, per prefisso, per sottostringa e
+ * la ricerca tollerante agli errori di battitura.
+ */
+
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+/**
+ * @brief Indice di ricerca sulle colonne del catalogo dei dipinti.
+ *
+ * Ogni colonna viene indicizzata separatamente. I valori distinti di una colonna
+ * (i "termini") vengono normalizzati (minuscolo, spazi compattati) e memorizzati una
+ * sola volta, con la lista delle righe che li contengono. Sopra i termini vengono
+ * costruiti:
+ * - un array ordinato dei termini e delle parole, per la ricerca per prefisso;
+ * - un indice di trigrammi dei termini, per la ricerca per sottostringa;
+ * - un indice di trigrammi delle parole, che filtra i candidati della ricerca
+ *   approssimata prima di calcolare la distanza di edit.
+ *
+ * Le righe sono identificate da un id stabile scelto dal chiamante; la rimozione
+ * di una riga la marca come eliminata senza toccare gli indici.
+ */
+class SearchIndex {
+public:
+    /**
+     * @brief Tipo di corrispondenza trovata, in ordine decrescente di rilevanza.
+     */
+    enum Corrispondenza {
+        ESATTA,          ///< il valore coincide con il testo cercato
+        PREFISSO,        ///< il valore inizia con il testo cercato
+        PREFISSO_PAROLA, ///< una parola del valore inizia con il testo cercato
+        SOTTOSTRINGA,    ///< il testo cercato compare all'interno del valore
+        APPROSSIMATA     ///< ogni parola cercata è a distanza di edit limitata da una parola del valore
+    };
+
+    /**
+     * @brief Singolo risultato della ricerca.
+     */
+    struct Risultato {
+        int riga;                 ///< id della riga trovata
+        int colonna;              ///< colonna in cui è stata trovata la corrispondenza
+        int punteggio;            ///< rilevanza del risultato (più alto è migliore)
+        Corrispondenza tipo;      ///< tipo di corrispondenza
+    };
+
+    /**
+     * @brief Costruttore.
+     *
+     * @param numColonne il numero di colonne da indicizzare
+     */
+    explicit SearchIndex(int numColonne = 5);
+
+    /**
+     * @brief Aggiunge una riga all'indice.
+     *
+     * Una riga rimossa in precedenza con lo stesso id e gli stessi valori (ad esempio
+     * annullando un'eliminazione) viene solo riattivata, in O(1).
+     *
+     * @param id l'id stabile della riga (non negativo)
+     * @param valori i valori della riga, uno per colonna
+     */
+    void addRow(int id, const std::vector<std::string>& valori);
+
+    /**
+     * @brief Rimuove una riga dall'indice.
+     *
+     * La riga viene marcata come eliminata e non comparirà più nei risultati.
+     *
+     * @param id l'id della riga da rimuovere
+     */
+    void removeRow(int id);
+
+    /**
+     * @brief Svuota l'indice.
+     */
+    void clear();
+
+    /**
+     * @brief Ordina i termini e le parole di tutte le colonne.
+     *
+     * Da chiamare dopo aver aggiunto molte righe: da qui in avanti i nuovi termini
+     * vengono inseriti al loro posto, quindi nessuna ricerca paga l'ordinamento.
+     * Senza questa chiamata gli array vengono ordinati alla prima ricerca.
+     */
+    void prepare();
+
+    /**
+     * @brief Esegue una ricerca.
+     *
+     * I risultati sono ordinati per punteggio decrescente; a parità di punteggio
+     * vengono prima i valori più corti. Ogni riga compare al più una volta,
+     * con la sua corrispondenza migliore.
+     *
+     * @param testo il testo cercato
+     * @param colonna la colonna in cui cercare, oppure -1 per cercare in tutte
+     * @param limite il numero massimo di risultati (0 = nessun limite)
+     *
+     * @return i risultati ordinati per rilevanza
+     */
+    std::vector<Risultato> search(const std::string& testo, int colonna = -1, size_t limite = 0) const;
+
+    /**
+     * @brief Ritorna le righe il cui valore in una colonna corrisponde al testo.
+     *
+     * @param colonna la colonna da interrogare
+     * @param testo il testo da confrontare (viene normalizzato)
+     * @param tipo il tipo di corrispondenza richiesta
+     *
+     * @return gli id delle righe presenti, in ordine crescente
+     */
+    std::vector<int> rows(int colonna, const std::string& testo, Corrispondenza tipo) const;
+
+    /**
+     * @brief Ritorna le righe il cui valore normalizzato in una colonna soddisfa un predicato.
+     *
+     * Il predicato viene valutato una volta per ogni valore distinto della colonna,
+     * non per ogni riga.
+     *
+     * @param colonna la colonna da interrogare
+     * @param predicato il predicato sul valore normalizzato
+     *
+     * @return gli id delle righe presenti, in ordine crescente
+     */
+    std::vector<int> rowsWhere(int colonna, const std::function<bool(const std::string&)>& predicato) const;
+
+    /**
+     * @brief Stima quante righe corrispondono al testo, senza costruirne la lista.
+     *
+     * La stima conta anche le righe eliminate, quindi è un limite superiore.
+     *
+     * @param colonna la colonna da interrogare
+     * @param testo il testo da confrontare (viene normalizzato)
+     * @param tipo il tipo di corrispondenza richiesta
+     *
+     * @return il numero stimato di righe
+     */
+    size_t estimate(int colonna, const std::string& testo, Corrispondenza tipo) const;
+
+    /**
+     * @brief Ritorna il valore normalizzato di una riga in una colonna.
+     *
+     * @param riga l'id della riga
+     * @param colonna la colonna
+     *
+     * @return puntatore al valore, oppure nullptr se la riga non è presente o la cella è vuota
+     */
+    const std::string* value(int riga, int colonna) const;
+
+    /**
+     * @brief Controlla se una riga è presente nell'indice.
+     *
+     * @param riga l'id della riga
+     *
+     * @return true o false
+     */
+    bool contains(int riga) const;
+
+    /**
+     * @brief Ritorna il numero di id di riga assegnati, comprese le righe eliminate.
+     *
+     * @return il numero di id di riga
+     */
+    size_t rowCount() const;
+
+    /**
+     * @brief Normalizza un valore: minuscolo ASCII e spazi compattati.
+     *
+     * @param s la stringa da normalizzare
+     *
+     * @return la stringa normalizzata
+     */
+    static std::string normalize(const std::string& s);
+
+    /**
+     * @brief Calcola la distanza di edit tra due stringhe, fermandosi oltre un limite.
+     *
+     * @param a prima stringa
+     * @param b seconda stringa
+     * @param limite la distanza massima di interesse
+     *
+     * @return la distanza di Levenshtein, oppure limite + 1 se la supera
+     */
+    static int boundedDistance(const std::string& a, const std::string& b, int limite);
+
+private:
+    /**
+     * @brief Indice di una singola colonna.
+     */
+    struct IndiceColonna {
+        std::vector<std::string> termini;                    ///< valori distinti normalizzati
+        std::unordered_map<std::string, int> idTermine;      ///< valore normalizzato -> id del termine
+        std::vector<std::vector<int>> righe;                 ///< id del termine -> righe che lo contengono
+        std::vector<int> terminiRiga;                        ///< id della riga -> id del termine (-1 = cella vuota)
+        std::vector<std::string> parole;                     ///< parole distinte dei termini
+        std::unordered_map<std::string, int> idParola;       ///< parola -> id della parola
+        std::vector<std::vector<int>> terminiParola;         ///< id della parola -> termini che la contengono
+        std::unordered_map<uint32_t, std::vector<int>> trigrammiTermini; ///< trigramma -> termini
+        std::unordered_map<uint32_t, std::vector<int>> trigrammiParole;  ///< trigramma (con bordi) -> parole
+        mutable std::vector<int> terminiOrdinati;            ///< id dei termini in ordine lessicografico
+        mutable std::vector<int> paroleOrdinate;             ///< id delle parole in ordine lessicografico
+        mutable bool ordinato = false;                       ///< true se gli array ordinati sono aggiornati
+        mutable std::vector<char> trovati;                   ///< id del termine -> 1 se la ricerca in corso l'ha già trovato
+    };
+
+    /**
+     * @brief Termine di una colonna che corrisponde al testo cercato.
+     */
+    struct Trovato {
+        int termine;              ///< id del termine
+        Corrispondenza tipo;      ///< tipo di corrispondenza
+        int distanza;             ///< distanza di edit totale (solo per APPROSSIMATA)
+    };
+
+    void indicizzaTermine(IndiceColonna& c, int termine);
+    void ordina(const IndiceColonna& c) const;
+    std::vector<int> terminiSottostringa(const IndiceColonna& c, const std::string& q) const;
+    std::vector<int> terminiCorrispondenti(const IndiceColonna& c, const std::string& q, Corrispondenza tipo) const;
+    std::vector<Trovato> cercaColonna(const IndiceColonna& c, const std::string& q, size_t bastano) const;
+    void cercaFasi(const IndiceColonna& c, const std::string& q, size_t bastano, std::vector<Trovato>& result) const;
+
+    std::vector<IndiceColonna> colonne; ///< un indice per ogni colonna
+    std::vector<char> vive;             ///< id della riga -> 1 se la riga è presente
+    mutable std::vector<char> inserita; ///< id della riga -> 1 se è già nei risultati (azzerato dopo ogni ricerca)
+};
+
+#endif // SEARCHINDEX_H
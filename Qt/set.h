@@ -15,6 +15,42 @@
 #include <fstream>
 #include <string>
 #include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <system_error>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <cstdio>
+#include <cerrno>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// con Qt anche le QString hanno l'impronta (vedi set_fingerprint)
+#ifdef QT_CORE_LIB
+#include <QHash>
+#include <QString>
+#endif
 
 using namespace std;
 
@@ -58,16 +94,457 @@ public:
 
 
 
+/**
+ * @brief Contatori raccolti da un set strumentato.
+ *
+ * I byte copiati sono contati come sizeof(T) per ogni elemento spostato in un
+ * nuovo array: per i tipi con memoria propria (ad esempio string) la copia
+ * reale è maggiore.
+ */
+struct set_stats {
+    unsigned long long comparisons = 0;   ///< confronti tra elementi fatti da contains e remove
+    unsigned long long reallocations = 0; ///< riallocazioni dell'array degli elementi
+    unsigned long long bytes_copied = 0;  ///< byte copiati durante le riallocazioni
+    unsigned long long shifts = 0;        ///< elementi spostati da remove
+    unsigned long long exceptions = 0;    ///< eccezioni sollevate dal set
+};
+
+
+/**
+ * @brief Politica di strumentazione vuota (default).
+ *
+ * Tutti i metodi sono vuoti e la classe non ha dati: il compilatore elimina
+ * le chiamate e il set non occupa memoria in più.
+ */
+struct set_no_stats {
+    void on_compare(unsigned long long) const {}
+    void on_reallocate(unsigned long long) const {}
+    void on_shift(unsigned long long) const {}
+    void on_exception() const {}
+    set_stats values() const { return set_stats(); }
+    void reset() {}
+};
+
+
+/**
+ * @brief Politica di strumentazione che conta le operazioni del set.
+ *
+ * I contatori sono mutable perché anche i metodi const (contains, operator[])
+ * li aggiornano.
+ */
+struct set_counting_stats {
+    mutable set_stats contatori; ///< i contatori del set
+
+    void on_compare(unsigned long long n) const { contatori.comparisons += n; }
+    void on_reallocate(unsigned long long byte) const { ++contatori.reallocations; contatori.bytes_copied += byte; }
+    void on_shift(unsigned long long n) const { contatori.shifts += n; }
+    void on_exception() const { ++contatori.exceptions; }
+    set_stats values() const { return contatori; }
+    void reset() { contatori = set_stats(); }
+};
+
+
+/**
+ * @brief Sceglie a tempo di compilazione la politica di strumentazione di Set<T>.
+ *
+ * Di default i set non sono strumentati. Compilando con -DSET_STATS vengono
+ * strumentati tutti i set; per strumentarne solo alcuni si specializza il
+ * template per il tipo degli elementi:
+ * @code
+ * template <> struct set_instrumentation<string> { typedef set_counting_stats type; };
+ * @endcode
+ */
+template <typename T>
+struct set_instrumentation {
+#ifdef SET_STATS
+    typedef set_counting_stats type;
+#else
+    typedef set_no_stats type;
+#endif
+};
+
+
+/**
+ * @brief Impronta (hash a 32 bit) degli elementi di un set.
+ *
+ * Per i tipi in cui confrontare due elementi costa molto, come le stringhe con
+ * lunghi prefissi comuni, il set conserva l'impronta di ogni elemento in un array
+ * parallelo: contains e remove confrontano prima le impronte, contigue in memoria,
+ * e confrontano gli elementi solo quando le impronte coincidono.
+ * Di default le impronte sono disabilitate; si abilitano specializzando il template.
+ */
+template <typename T>
+struct set_fingerprint {
+    static constexpr bool enabled = false; ///< true se il set conserva le impronte
+};
+
+/**
+ * @brief Impronte delle std::string.
+ */
+template <>
+struct set_fingerprint<std::string> {
+    static constexpr bool enabled = true;
+
+    static uint32_t of(const std::string& value) {
+        uint64_t h = std::hash<std::string>()(value);
+        return static_cast<uint32_t>(h ^ (h >> 32));
+    }
+};
+
+#ifdef QT_CORE_LIB
+/**
+ * @brief Impronte delle QString, calcolate con qHash.
+ */
+template <>
+struct set_fingerprint<QString> {
+    static constexpr bool enabled = true;
+
+    static uint32_t of(const QString& value) {
+        return static_cast<uint32_t>(qHash(value));
+    }
+};
+#endif
+
+
+/**
+ * @brief Array delle impronte di un set (vuoto se le impronte sono disabilitate).
+ *
+ * La classe base di Set<T> alloca, copia e sposta le impronte insieme agli
+ * elementi: l'impronta in posizione i è quella dell'elemento arr[i].
+ */
+template <typename T, bool attivo = set_fingerprint<T>::enabled>
+class set_fingerprint_array {
+protected:
+    void fingerprints_allocate(int) {}
+    void fingerprints_grow(int, int) {}
+    void fingerprints_free() {}
+    void fingerprints_copy(const set_fingerprint_array&, int) {}
+    void fingerprints_swap(set_fingerprint_array&) {}
+    void fingerprints_set(int, const T&) {}
+    void fingerprints_erase(int, int) {}
+};
+
+template <typename T>
+class set_fingerprint_array<T, true> {
+protected:
+    uint32_t* impronte; ///< impronta di ogni elemento, nello stesso ordine degli elementi
+
+    set_fingerprint_array() : impronte(nullptr) {}
+    ~set_fingerprint_array() { delete[] impronte; }
+    set_fingerprint_array(const set_fingerprint_array&) = delete;
+    set_fingerprint_array& operator=(const set_fingerprint_array&) = delete;
+
+    void fingerprints_allocate(int n) {
+        impronte = new uint32_t[n > 0 ? n : 1];
+    }
+
+    // Porta l'array a n impronte, conservando le prime presenti
+    void fingerprints_grow(int n, int presenti) {
+        uint32_t* temp = new uint32_t[n > 0 ? n : 1];
+        if (presenti > 0) {
+            std::memcpy(temp, impronte, sizeof(uint32_t) * static_cast<size_t>(presenti));
+        }
+        delete[] impronte;
+        impronte = temp;
+    }
+
+    void fingerprints_free() {
+        delete[] impronte;
+        impronte = nullptr;
+    }
+
+    void fingerprints_copy(const set_fingerprint_array& other, int n) {
+        if (n > 0) {
+            std::memcpy(impronte, other.impronte, sizeof(uint32_t) * static_cast<size_t>(n));
+        }
+    }
+
+    void fingerprints_swap(set_fingerprint_array& other) {
+        std::swap(impronte, other.impronte);
+    }
+
+    void fingerprints_set(int i, const T& value) {
+        impronte[i] = set_fingerprint<T>::of(value);
+    }
+
+    // Toglie l'impronta in posizione i da un array di n impronte
+    void fingerprints_erase(int i, int n) {
+        std::memmove(impronte + i, impronte + i + 1, sizeof(uint32_t) * static_cast<size_t>(n - 1 - i));
+    }
+};
+
+
+/**
+ * @brief true se std::hash è definito per T (serve a Set::contains_many).
+ */
+template <typename T>
+struct set_hashable : std::is_default_constructible<std::hash<T>> {};
+
+
+/**
+ * @brief Hash a 64 bit di un elemento, con i bit mescolati.
+ *
+ * std::hash degli interi è l'identità: il finalizzatore di splitmix64 distribuisce
+ * i bit su tutta la parola, come serve alle tabelle hash e alla somma di set_content_hash.
+ */
+template <typename T>
+inline uint64_t set_element_hash(const T& value) {
+    uint64_t h = static_cast<uint64_t>(std::hash<T>()(value));
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+
+/**
+ * @brief Tabella hash temporanea sugli elementi di un set, usata da Set::contains_many.
+ *
+ * Ogni cella contiene 32 bit dell'hash e la posizione di un elemento nell'array
+ * del set; le collisioni si risolvono con sondaggio lineare e la tabella è piena
+ * al più per metà. Gli elementi vengono confrontati solo se i 32 bit coincidono.
+ */
+template <typename T>
+class set_hash_index {
+    struct Cella {
+        uint32_t hash;  ///< 32 bit alti dell'hash dell'elemento
+        int32_t indice; ///< posizione dell'elemento nell'array del set (-1 per le celle vuote)
+    };
+
+    static const size_t ANTICIPO = 16; ///< quante chiavi prima si chiede la cella alla cache
+
+    const T* elementi;        ///< l'array degli elementi del set
+    std::vector<Cella> celle; ///< la tabella
+    size_t maschera;          ///< numero di celle meno uno
+
+    void anticipa(uint64_t h) const {
+#if defined(__GNUC__)
+        __builtin_prefetch(&celle[h & maschera]);
+#else
+        (void)h;
+#endif
+    }
+
+public:
+    set_hash_index(const T* arr, int n) : elementi(arr), maschera(0) {
+        size_t dim = 16;
+        while (dim < 2 * static_cast<size_t>(n)) {
+            dim *= 2;
+        }
+        celle.assign(dim, Cella{0, -1});
+        maschera = dim - 1;
+        for (int i = 0; i < n; ++i) {
+            uint64_t h = set_element_hash(arr[i]);
+            size_t p = h & maschera;
+            while (celle[p].indice >= 0) {
+                p = (p + 1) & maschera;
+            }
+            celle[p] = Cella{static_cast<uint32_t>(h >> 32), i};
+        }
+    }
+
+    /**
+     * @brief Cerca n chiavi e chiama esito(i, trovata) per ognuna, nell'ordine.
+     *
+     * Gli hash vengono calcolati ANTICIPO chiavi prima di usarli e la loro cella
+     * viene chiesta subito alla cache, così le letture delle chiavi successive
+     * sono in corso mentre si confronta quella corrente.
+     *
+     * @return il numero di confronti tra elementi
+     */
+    template <typename Esito>
+    unsigned long long probe(const T* keys, size_t n, Esito esito) const {
+        uint64_t hash[ANTICIPO];
+        for (size_t i = 0; i < n && i < ANTICIPO; ++i) {
+            hash[i] = set_element_hash(keys[i]);
+            anticipa(hash[i]);
+        }
+        unsigned long long confronti = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t h = hash[i % ANTICIPO];
+            if (i + ANTICIPO < n) {
+                hash[i % ANTICIPO] = set_element_hash(keys[i + ANTICIPO]);
+                anticipa(hash[i % ANTICIPO]);
+            }
+            const uint32_t alto = static_cast<uint32_t>(h >> 32);
+            bool trovata = false;
+            for (size_t p = h & maschera; celle[p].indice >= 0; p = (p + 1) & maschera) {
+                if (celle[p].hash == alto) {
+                    ++confronti;
+                    if (elementi[celle[p].indice] == keys[i]) {
+                        trovata = true;
+                        break;
+                    }
+                }
+            }
+            esito(i, trovata);
+        }
+        return confronti;
+    }
+};
+
+
+/**
+ * @brief Impronta del contenuto di un set (vuota se std::hash non è definito per T).
+ *
+ * È la somma degli hash (set_element_hash) di tutti gli elementi: non dipende
+ * dall'ordine, e add e remove la aggiornano sommando o sottraendo l'hash
+ * dell'elemento. Due set con impronte diverse sono sicuramente diversi.
+ */
+template <typename T, bool attivo = set_hashable<T>::value>
+class set_content_hash {
+protected:
+    void content_hash_add(const T&) {}
+    void content_hash_remove(const T&) {}
+    void content_hash_copy(const set_content_hash&) {}
+    void content_hash_swap(set_content_hash&) {}
+    void content_hash_reset() {}
+    bool content_hash_differs(const set_content_hash&) const { return false; }
+};
+
+template <typename T>
+class set_content_hash<T, true> {
+protected:
+    uint64_t somma; ///< somma (modulo 2^64) degli hash degli elementi
+
+    set_content_hash() : somma(0) {}
+    set_content_hash(const set_content_hash&) = delete;
+    set_content_hash& operator=(const set_content_hash&) = delete;
+
+    void content_hash_add(const T& value) { somma += set_element_hash(value); }
+    void content_hash_remove(const T& value) { somma -= set_element_hash(value); }
+    void content_hash_copy(const set_content_hash& other) { somma = other.somma; }
+    void content_hash_swap(set_content_hash& other) { std::swap(somma, other.somma); }
+    void content_hash_reset() { somma = 0; }
+    bool content_hash_differs(const set_content_hash& other) const { return somma != other.somma; }
+};
+
+
+/**
+ * @brief Formati disponibili per write_set.
+ */
+enum class set_format {
+    legacy, ///< il formato dell'operatore di stream: "n (a) (b)"
+    json,   ///< array JSON: [a,b]; i valori non numerici diventano stringhe JSON
+    csv     ///< un elemento per riga, tra virgolette quando contiene virgole, virgolette o a capo
+};
+
+
+
+template <typename T> class FrozenSet;
+
+
 /**
   @brief classe Set
 
   La classe implementa un set di elementi generici T.
+  La politica di strumentazione (set_instrumentation) è una classe base
+  vuota quando è disabilitata, quindi non aumenta la dimensione del set.
+  Lo stesso vale per l'array delle impronte (set_fingerprint_array), usato
+  solo dai tipi per cui set_fingerprint è abilitato, come std::string, e per
+  l'impronta del contenuto (set_content_hash), usata dai tipi con std::hash.
 */
-template <typename T> class Set {
+template <typename T> class Set : private set_instrumentation<T>::type, private set_fingerprint_array<T>,
+                                  private set_content_hash<T> {
     T* arr; ///< puntatore al primo elemento di un array
     int capacity; ///< il numero totale di elementi che l'array può attualmente contenere
     int currentSize; ///< il numero di elementi attualmente inseriti nel set
 
+    /// true se gli elementi si possono creare senza costruttore e copiare byte per byte:
+    /// l'array viene allora allocato con malloc, copiato con memcpy e spostato con memmove
+    static constexpr bool elementi_banali =
+        std::is_trivially_copyable<T>::value && std::is_trivially_default_constructible<T>::value;
+
+    /**
+     * @brief Alloca un array di n elementi (almeno uno).
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    static T* alloca_elementi(int n) {
+        if constexpr (elementi_banali) {
+            void* p = std::malloc(sizeof(T) * static_cast<size_t>(n > 0 ? n : 1));
+            if (p == nullptr) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(p);
+        } else {
+            return new T[n];
+        }
+    }
+
+    /**
+     * @brief Dealloca un array creato da alloca_elementi.
+     */
+    static void libera_elementi(T* p) {
+        if constexpr (elementi_banali) {
+            std::free(p);
+        } else {
+            delete[] p;
+        }
+    }
+
+    /**
+     * @brief Copia n elementi in un array già allocato.
+     */
+    static void copia_elementi(T* destinazione, const T* sorgente, int n) {
+        if constexpr (elementi_banali) {
+            if (n > 0) {
+                std::memcpy(destinazione, sorgente, sizeof(T) * static_cast<size_t>(n));
+            }
+        } else {
+            for (int i = 0; i < n; i++) {
+                destinazione[i] = sorgente[i];
+            }
+        }
+    }
+
+    /**
+     * @brief Porta la capacità a n elementi conservando quelli presenti.
+     *
+     * Per gli elementi banali usa realloc, che quando può estende il blocco
+     * senza copiarlo. Se viene lanciata un'eccezione il set resta invariato.
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    void rialloca(int n) {
+        this->on_reallocate(static_cast<unsigned long long>(currentSize) * sizeof(T));
+        // le impronte crescono per prime: se poi fallisce l'allocazione degli elementi
+        // restano solo più grandi del necessario
+        this->fingerprints_grow(n, currentSize);
+        if constexpr (elementi_banali) {
+            void* p = std::realloc(arr, sizeof(T) * static_cast<size_t>(n > 0 ? n : 1));
+            if (p == nullptr) {
+                throw std::bad_alloc();
+            }
+            arr = static_cast<T*>(p);
+        } else {
+            T* temp = new T[n];
+            try {
+                copia_elementi(temp, arr, currentSize);
+            } catch(...) {
+                delete[] temp;
+                throw;
+            }
+            delete[] arr;
+            arr = temp;
+        }
+        capacity = n;
+    }
+
+    // Cerca le chiavi con la tabella hash quando conviene, altrimenti con contains
+    template <typename Esito>
+    void contains_many_impl(const T* keys, size_t n, Esito esito) const {
+        if constexpr (set_hashable<T>::value) {
+            if (currentSize >= batch_threshold && n > 1) {
+                set_hash_index<T> indice(arr, currentSize);
+                this->on_compare(indice.probe(keys, n, esito));
+                return;
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            esito(i, contains(keys[i]));
+        }
+    }
+
 public:
     /**
      * @brief Costruttore di default.
@@ -83,7 +560,8 @@ public:
      * che il distruttore non tenti di deallocare un puntatore non inizializzato.
      */
     Set() : arr(nullptr), capacity(1), currentSize(0) {
-        arr = new T[capacity];
+        arr = alloca_elementi(capacity);
+        this->fingerprints_allocate(capacity);
     }
 
     /**
@@ -99,9 +577,12 @@ public:
      * @throw duplicateElementException()
      */
     Set(const T* array, size_t size) : arr(nullptr), capacity(size), currentSize(0) {
-        arr = new T[capacity];
+        arr = alloca_elementi(capacity);
+        this->fingerprints_allocate(capacity);
         for (size_t i = 0; i < size; ++i) {
             if (!contains(array[i])) {
+                this->fingerprints_set(currentSize, array[i]);
+                this->content_hash_add(array[i]);
                 arr[currentSize++] = array[i];
             } /*else {
                 throw duplicateElementException();
@@ -123,15 +604,17 @@ public:
      * ai valori di `other`. Successivamente, alloca memoria per l'array `arr` e copia ogni elemento
      * dall'array `other.arr`. Questo assicura che il nuovo Set sia una copia indipendente di `other`,
      * con i propri dati e risorse.
+     * Per gli elementi banali (ad esempio int o double) la copia è un solo memcpy.
      * 
      * @throw std::bad_alloc possibile eccezione di allocazione
      */
     Set(const Set<T>& other) : arr(nullptr), capacity(other.capacity), currentSize(other.currentSize) {
-        arr = new T[capacity];
+        arr = alloca_elementi(capacity);
+        this->fingerprints_allocate(capacity);
         try {
-            for (int i = 0; i < currentSize; i++) {
-                arr[i] = other.arr[i];
-            }
+            copia_elementi(arr, other.arr, currentSize);
+            this->fingerprints_copy(other, currentSize);
+            this->content_hash_copy(other);
         }catch(...){
             clear(); 
             throw;
@@ -169,7 +652,8 @@ public:
     Set(Iterator begin, Iterator end) {
         capacity = 1;
         currentSize = 0;
-        arr = new T[capacity];
+        arr = alloca_elementi(capacity);
+        this->fingerprints_allocate(capacity);
         try {
             for (Iterator it = begin; it != end; ++it) {
                 add(static_cast<T>(*it));
@@ -221,6 +705,8 @@ public:
         std::swap(arr, other.arr); // Usa std::swap per scambiare i puntatori
         std::swap(capacity, other.capacity);
         std::swap(currentSize, other.currentSize);
+        this->fingerprints_swap(other);
+        this->content_hash_swap(other);
     }
 
 
@@ -238,7 +724,9 @@ public:
      * il Set non conterrà alcun elemento e non avrà memoria allocata.
      */
     void clear() {
-        delete[] arr;  
+        libera_elementi(arr);
+        this->fingerprints_free();
+        this->content_hash_reset();
         arr = nullptr; 
         currentSize = 0; 
         capacity = 0;    
@@ -254,6 +742,43 @@ public:
     }
 
 
+    /**
+     * @brief Ritorna i contatori della strumentazione del set.
+     *
+     * Se il set non è strumentato (vedi set_instrumentation) i contatori sono tutti a zero.
+     *
+     * @return i contatori raccolti dalla creazione del set o dall'ultimo reset_stats
+    */
+    set_stats stats() const {
+        return this->values();
+    }
+
+
+    /**
+     * @brief Azzera i contatori della strumentazione del set.
+    */
+    void reset_stats() {
+        this->reset();
+    }
+
+
+    /**
+     * @brief Crea una copia immutabile del set ottimizzata per le ricerche.
+     *
+     * Da usare per i set costruiti una volta e interrogati molte volte (ad esempio
+     * l'elenco delle scuole o delle sale ammesse): FrozenSet::contains esegue una
+     * ricerca binaria senza salti condizionati invece della scansione lineare.
+     * Gli elementi devono essere confrontabili con operator<.
+     *
+     * @return il set immutabile con gli stessi elementi
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+    */
+    FrozenSet<T> freeze() const {
+        return FrozenSet<T>(*this);
+    }
+
+
     /**
      * @brief Controlla se un dato elemento è già presente nel set.
      *
@@ -262,12 +787,97 @@ public:
      * @return true o false
     */
     bool contains(const T& value) const {
+        if constexpr (set_fingerprint<T>::enabled) {
+            // si confrontano solo gli elementi con la stessa impronta
+            uint32_t impronta = set_fingerprint<T>::of(value);
+            unsigned long long confronti = 0;
+            for (int i = 0; i < currentSize; ++i) {
+                if (this->impronte[i] == impronta) {
+                    ++confronti;
+                    if (arr[i] == value) {
+                        this->on_compare(confronti);
+                        return true;
+                    }
+                }
+            }
+            this->on_compare(confronti);
+            return false;
+        }
         for (int i = 0; i < currentSize; ++i) {
             if (arr[i] == value) {
-                return true; 
+                this->on_compare(i + 1);
+                return true;
             }
         }
-        return false; 
+        this->on_compare(currentSize);
+        return false;
+    }
+
+
+    /**
+     * @brief Numero minimo di elementi del set oltre il quale contains_many usa una tabella hash.
+     */
+    static constexpr int batch_threshold = 32;
+
+
+    /**
+     * @brief Conta quante chiavi di un array sono presenti nel set.
+     *
+     * Pensata per i join, dove molte chiavi vengono cercate nello stesso set:
+     * invece di scandire il set per ogni chiave costruisce una tabella hash
+     * temporanea sugli elementi (set_hash_index) e vi cerca le chiavi chiedendo
+     * alla cache le celle con qualche chiave di anticipo. Se il set ha meno di
+     * batch_threshold elementi, o std::hash non è definito per T, usa contains.
+     *
+     * @param keys le chiavi da cercare
+     * @param n il numero di chiavi
+     *
+     * @return il numero di chiavi presenti nel set
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+    */
+    size_t contains_many(const T* keys, size_t n) const {
+        size_t trovate = 0;
+        contains_many_impl(keys, n, [&trovate](size_t, bool trovata) { trovate += trovata; });
+        return trovate;
+    }
+
+
+    /**
+     * @brief Controlla quali chiavi di un array sono presenti nel set.
+     *
+     * Come contains_many(keys, n), ma riporta anche l'esito di ogni chiave.
+     *
+     * @param keys le chiavi da cercare
+     * @param n il numero di chiavi
+     * @param presenti riceve n valori: presenti[i] è true se keys[i] è nel set
+     *
+     * @return il numero di chiavi presenti nel set
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+    */
+    size_t contains_many(const T* keys, size_t n, vector<bool>& presenti) const {
+        presenti.assign(n, false);
+        size_t trovate = 0;
+        contains_many_impl(keys, n, [&](size_t i, bool trovata) {
+            presenti[i] = trovata;
+            trovate += trovata;
+        });
+        return trovate;
+    }
+
+    /**
+     * @brief Ritorna l'impronta del contenuto del set.
+     *
+     * È la somma degli hash degli elementi, aggiornata da add e remove: non dipende
+     * dall'ordine di inserimento e si calcola in O(1). Set uguali hanno la stessa
+     * impronta; è il valore restituito da std::hash<Set<T>>.
+     *
+     * @return l'impronta del contenuto
+    */
+    uint64_t content_hash() const {
+        static_assert(set_hashable<T>::value, "content_hash richiede std::hash per il tipo degli elementi");
+        return this->somma;
     }
 
 
@@ -282,15 +892,11 @@ public:
             // Assicurati che ci sia spazio per aggiungere un nuovo elemento
             if (currentSize == capacity) {
                 // Raddoppia la capacità se necessario
-                capacity *= 2;
-                T* temp = new T[capacity];
-                for (int i = 0; i < currentSize; i++) {
-                    temp[i] = arr[i];
-                }
-                delete[] arr;
-                arr = temp;
+                rialloca(capacity > 0 ? capacity * 2 : 1);
             }
             // Aggiungi l'elemento e incrementa la dimensione
+            this->fingerprints_set(currentSize, value);
+            this->content_hash_add(value);
             arr[currentSize++] = value;
         }/*else{
             throw duplicateElementException();
@@ -298,23 +904,78 @@ public:
     }
 
 
+    /**
+     * @brief Riserva spazio per almeno n elementi.
+     *
+     * Se la capacità attuale è già sufficiente non fa nulla; altrimenti rialloca
+     * l'array una sola volta, evitando i raddoppi successivi durante un caricamento.
+     *
+     * @param n il numero di elementi da poter contenere senza riallocare
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+    */
+    void reserve(int n) {
+        if (n <= capacity) {
+            return;
+        }
+        rialloca(n);
+    }
+
+
+    /**
+     * @brief Aggiunge un elemento senza controllare se è già presente.
+     *
+     * Da usare solo quando l'unicità è già garantita, ad esempio caricando
+     * un file scritto da save: evita la scansione lineare di contains.
+     *
+     * @param value il valore da aggiungere, che non deve essere già nel set
+    */
+    void add_unchecked(const T& value) {
+        if (currentSize == capacity) {
+            reserve(capacity > 0 ? capacity * 2 : 1);
+        }
+        this->fingerprints_set(currentSize, value);
+        this->content_hash_add(value);
+        arr[currentSize++] = value;
+    }
+
+
     /**
      * @brief Elimina un certo elemento dal set.
      *
      * @param value il valore da rimuovere
     */
     void remove(const T& value) {
+        uint32_t impronta = 0;
+        if constexpr (set_fingerprint<T>::enabled) {
+            impronta = set_fingerprint<T>::of(value);
+        }
         for (int i = 0; i < currentSize; ++i) {
+            if constexpr (set_fingerprint<T>::enabled) {
+                if (this->impronte[i] != impronta) {
+                    continue;
+                }
+            }
             if (arr[i] == value) {
                 // Trovato l'elemento da rimuovere
-                for (int j = i; j < currentSize - 1; ++j) {
-                    arr[j] = arr[j + 1]; // Sposta tutti gli elementi successivi indietro di una posizione
+                this->on_compare(i + 1);
+                this->on_shift(currentSize - 1 - i);
+                this->fingerprints_erase(i, currentSize);
+                this->content_hash_remove(value);
+                // Sposta tutti gli elementi successivi indietro di una posizione
+                if constexpr (elementi_banali) {
+                    std::memmove(arr + i, arr + i + 1, sizeof(T) * static_cast<size_t>(currentSize - 1 - i));
+                } else {
+                    for (int j = i; j < currentSize - 1; ++j) {
+                        arr[j] = arr[j + 1];
+                    }
                 }
                 currentSize--; // Decrementa la dimensione del Set
                 return; // Termina il metodo dopo la rimozione
             } 
         } 
         // Se l'elemento non è stato trovato, lancia un'eccezione
+        this->on_compare(currentSize);
         //throw elementNotFoundException();
     }
 
@@ -329,6 +990,7 @@ public:
     const T& operator[](int index) const {
         // Controlla se l'indice è nel range valido
         if (index < 0 || index >= currentSize) {
+            this->on_exception();
             throw out_of_range("Indice è fuori dai limiti");
         }
         return arr[index];
@@ -350,6 +1012,13 @@ public:
      * @return lo stream di output
     */
     friend ostream& operator<<(ostream& os, const Set<T>& s) {
+        // con le impostazioni di default dello stream il testo viene preparato in un buffer
+        // e scritto con una sola operazione; altrimenti si rispettano base, precisione, ecc.
+        if (os.flags() == (ios::dec | ios::skipws) && os.precision() == 6 && os.width() == 0) {
+            string buffer;
+            write_set(buffer, s, set_format::legacy);
+            return os.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+        }
         os << s.currentSize;
         if (s.currentSize > 0) {
             os << " (";
@@ -372,6 +1041,8 @@ public:
      * friend perché accediamo ai dati privati di set.
      * La funzione verifica l'uguaglianza tra due set 
      * confrontando le loro dimensioni e i loro elementi.
+     * Se le impronte del contenuto (content_hash) sono diverse risponde
+     * false in O(1); i set grandi vengono confrontati con contains_many.
      * 
      * @param a reference al primo set
      * @param b reference al secondo set
@@ -380,6 +1051,11 @@ public:
     */
     friend bool operator==(const Set<T>& a, const Set<T>& b) {
         if (a.currentSize != b.currentSize) return false;
+        // impronte del contenuto diverse: i set sono diversi senza guardare gli elementi
+        if (a.content_hash_differs(b)) return false;
+        if (a.currentSize >= batch_threshold) {
+            return b.contains_many(a.arr, static_cast<size_t>(a.currentSize)) == static_cast<size_t>(a.currentSize);
+        }
         for (int i = 0; i < a.currentSize; i++) {
             if (!b.contains(a.arr[i])) return false;
         }
@@ -535,51 +1211,760 @@ public:
         }
 };
 
-   /**
-     * @brief Funzione GLOBALE che crea un nuovo set in base ai requisiti del predicato.
-     * 
-     * Accetta un set e un dato predicato, restituendo il nuovo set, 
-     * contenente gli elementi che soddisfano il predicato.
-     * 
-     * @param s reference al set
-     * @param p il predicato da usare
-     * 
-     * @return result il nuovo set che soddisfa il predicato
-    */
-    template <typename T, typename Predicate>
-    Set<T> filter_out(const Set<T>& s, Predicate p) {
-        Set<T> result;
-        for (int i = 0; i < s.size(); ++i) {
-            if (p(s[i])) {
-                result.add(s[i]);
-            }
+
+/**
+ * @brief Funtore di hash per Set<T>, disponibile solo se std::hash è definito per T.
+ *
+ * Senza std::hash per T il funtore non è costruibile, come gli std::hash disabilitati.
+ */
+template <typename T, bool attivo = set_hashable<T>::value>
+struct set_hash {
+    set_hash() = delete;
+    set_hash(const set_hash&) = delete;
+    set_hash& operator=(const set_hash&) = delete;
+};
+
+template <typename T>
+struct set_hash<T, true> {
+    size_t operator()(const Set<T>& s) const {
+        return static_cast<size_t>(s.content_hash());
+    }
+};
+
+namespace std {
+    /**
+     * @brief Hash di un Set<T>: permette di usare i set come chiavi di unordered_set e unordered_map.
+     */
+    template <typename T>
+    struct hash<Set<T>> : set_hash<T> {};
+}
+
+
+/**
+  @brief classe FrozenSet
+
+  Set immutabile creato da Set::freeze. Gli elementi sono ordinati e disposti
+  nell'ordine di una visita in ampiezza dell'albero binario di ricerca (layout di
+  Eytzinger): la radice in posizione 1 e i figli del nodo k nelle posizioni 2k e 2k+1.
+  I primi livelli dell'albero, visitati da ogni ricerca, restano così vicini in memoria
+  e nella cache; la ricerca scende di un livello per iterazione con un'espressione
+  aritmetica invece di un salto condizionato e chiede in anticipo (prefetch) la linea
+  di cache dei discendenti di quattro livelli più in basso.
+
+  L'interfaccia è quella in sola lettura di Set (contains, size, operator[], begin
+  ed end); l'ordine degli elementi è quello del layout, non quello di inserimento.
+*/
+template <typename T>
+class FrozenSet {
+    T* albero; ///< gli elementi nel layout di Eytzinger, a partire dalla posizione 1
+    int currentSize; ///< il numero di elementi
+
+    /**
+     * @brief Dispone gli elementi ordinati nel sottoalbero con radice k (visita simmetrica).
+     *
+     * @param ordinati gli elementi in ordine crescente
+     * @param i la posizione del prossimo elemento ordinato da collocare
+     * @param k la radice del sottoalbero
+     */
+    void disponi(const T* ordinati, int& i, int k) {
+        if (k <= currentSize) {
+            disponi(ordinati, i, 2 * k);
+            albero[k] = ordinati[i++];
+            disponi(ordinati, i, 2 * k + 1);
+        }
+    }
+
+public:
+    typedef const T* const_iterator; ///< Iteratore costante sugli elementi, nell'ordine del layout
+
+    /**
+     * @brief Costruttore di default, crea un set immutabile vuoto.
+     */
+    FrozenSet() : albero(new T[1]), currentSize(0) {}
+
+
+    /**
+     * @brief Costruttore che dispone gli elementi di un Set.
+     *
+     * @param s il set da copiare
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    explicit FrozenSet(const Set<T>& s) : albero(nullptr), currentSize(s.size()) {
+        vector<T> ordinati(s.begin(), s.end());
+        sort(ordinati.begin(), ordinati.end());
+        albero = new T[currentSize + 1];
+        int i = 0;
+        disponi(ordinati.data(), i, 1);
+    }
+
+
+    /**
+     * @brief Costruttore di copia.
+     *
+     * @param other il set da copiare
+     */
+    FrozenSet(const FrozenSet& other) : albero(new T[other.currentSize + 1]), currentSize(other.currentSize) {
+        try {
+            for (int k = 1; k <= currentSize; ++k) {
+                albero[k] = other.albero[k];
+            }
+        } catch(...) {
+            delete[] albero;
+            throw;
+        }
+    }
+
+
+    /**
+     * @brief Operatore di assegnamento (copia e scambio).
+     *
+     * @param other il set da copiare
+     *
+     * @return reference a questo set
+     */
+    FrozenSet& operator=(const FrozenSet& other) {
+        if (this != &other) {
+            FrozenSet temp(other);
+            std::swap(albero, temp.albero);
+            std::swap(currentSize, temp.currentSize);
+        }
+        return *this;
+    }
+
+
+    /**
+     * @brief Distruttore.
+     */
+    ~FrozenSet() {
+        delete[] albero;
+    }
+
+
+    /**
+     * @brief Ritorna il numero di elementi presenti nel set.
+     *
+     * @return il numero di elementi
+     */
+    int size() const {
+        return currentSize;
+    }
+
+
+    /**
+     * @brief Controlla se un dato elemento è presente nel set.
+     *
+     * Ad ogni livello k diventa 2k oppure 2k+1 a seconda del confronto, senza salti
+     * condizionati; alla fine si tolgono i passi a destra finali (i bit a 1 in coda
+     * a k più uno) e si ottiene il primo elemento non minore di value.
+     *
+     * @param value il valore da controllare
+     *
+     * @return true o false
+     */
+    bool contains(const T& value) const {
+        // i discendenti di k quattro livelli più in basso sono i 16 elementi
+        // consecutivi a partire da 16k: si chiede in anticipo la loro prima linea
+        const uintptr_t base = reinterpret_cast<uintptr_t>(albero);
+        size_t k = 1;
+        while (k <= static_cast<size_t>(currentSize)) {
+#if defined(__GNUC__)
+            __builtin_prefetch(reinterpret_cast<const void*>(base + 16 * k * sizeof(T)));
+#endif
+            k = 2 * k + static_cast<size_t>(albero[k] < value);
+        }
+        // si risale fino all'ultimo passo a sinistra: è il primo elemento >= value
+#if defined(__GNUC__)
+        k >>= __builtin_ffsll(static_cast<long long>(~k));
+#else
+        while (k & 1) {
+            k >>= 1;
+        }
+        k >>= 1;
+#endif
+        return k != 0 && !(value < albero[k]);
+    }
+
+
+    /**
+     * @brief Operatore di accesso in sola lettura.
+     *
+     * @param index l'indice dell'elemento, nell'ordine del layout
+     *
+     * @return reference all'elemento
+     *
+     * @throw invoca std::out_of_range
+     */
+    const T& operator[](int index) const {
+        if (index < 0 || index >= currentSize) {
+            throw out_of_range("Indice fuori dai limiti");
+        }
+        return albero[index + 1];
+    }
+
+
+    /**
+     * @brief Ritorna un iteratore costante al primo elemento del set.
+     */
+    const_iterator begin() const {
+        return albero + 1;
+    }
+
+
+    /**
+     * @brief Ritorna un iteratore costante che punta appena oltre l'ultimo elemento del set.
+     */
+    const_iterator end() const {
+        return albero + 1 + currentSize;
+    }
+};
+
+
+/**
+  @brief classe SharedSet
+
+  Set condiviso implicitamente (copy-on-write), come i container di Qt. Le copie
+  di un SharedSet usano lo stesso Set<T> e costano O(1): un contatore atomico
+  conta le copie che lo condividono. Il primo metodo che modifica un set
+  condiviso lo stacca (detach), creandone una copia privata; un set non
+  condiviso viene modificato direttamente. I metodi di lettura non copiano mai.
+
+  Il contatore è atomico, quindi le copie dello stesso set si possono creare,
+  leggere e distruggere da thread diversi; come per i container di Qt, uno
+  stesso oggetto SharedSet non va modificato da più thread insieme.
+*/
+template <typename T>
+class SharedSet {
+    /**
+     * @brief Blocco condiviso tra le copie: il set e il numero di copie che lo usano.
+     */
+    struct Condiviso {
+        std::atomic<int> riferimenti; ///< numero di SharedSet che usano il blocco
+        Set<T> set;                   ///< gli elementi
+
+        Condiviso() : riferimenti(1) {}
+        explicit Condiviso(const Set<T>& s) : riferimenti(1), set(s) {}
+    };
+
+    Condiviso* dati; ///< il blocco condiviso, mai nullptr
+
+    // Lascia il blocco; l'ultima copia che lo usa lo dealloca
+    void rilascia() {
+        if (dati->riferimenti.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete dati;
+        }
+    }
+
+    // Prima di una modifica: un blocco condiviso viene sostituito da una copia privata
+    void stacca() {
+        if (dati->riferimenti.load(std::memory_order_acquire) > 1) {
+            Condiviso* copia = new Condiviso(dati->set);
+            rilascia();
+            dati = copia;
+        }
+    }
+
+public:
+    typedef typename Set<T>::const_iterator const_iterator; ///< Iteratore costante sugli elementi
+
+
+    /**
+     * @brief Costruttore di default, crea un set vuoto non condiviso.
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    SharedSet() : dati(new Condiviso()) {}
+
+
+    /**
+     * @brief Costruttore che copia gli elementi di un Set.
+     *
+     * @param s il set da copiare
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    explicit SharedSet(const Set<T>& s) : dati(new Condiviso(s)) {}
+
+
+    /**
+     * @brief Costruttore di copia: condivide gli elementi di other in O(1).
+     *
+     * @param other il set da condividere
+     */
+    SharedSet(const SharedSet& other) : dati(other.dati) {
+        dati->riferimenti.fetch_add(1, std::memory_order_relaxed);
+    }
+
+
+    /**
+     * @brief Operatore di assegnamento: condivide gli elementi di other in O(1).
+     *
+     * @param other il set da condividere
+     *
+     * @return reference a questo set
+     */
+    SharedSet& operator=(const SharedSet& other) {
+        SharedSet temp(other);
+        swap(temp);
+        return *this;
+    }
+
+
+    /**
+     * @brief Distruttore: dealloca gli elementi se nessun'altra copia li usa.
+     */
+    ~SharedSet() {
+        rilascia();
+    }
+
+
+    /**
+     * @brief Scambia il contenuto di questo set con un altro set.
+     *
+     * @param other il set con cui scambiare i dati
+     */
+    void swap(SharedSet& other) {
+        std::swap(dati, other.dati);
+    }
+
+
+    /**
+     * @brief Controlla se gli elementi sono condivisi con altre copie.
+     *
+     * @return true se la prossima modifica dovrà copiare il set
+     */
+    bool is_shared() const {
+        return dati->riferimenti.load(std::memory_order_acquire) > 1;
+    }
+
+
+    /**
+     * @brief Ritorna il Set in sola lettura, senza copiarlo.
+     */
+    const Set<T>& get() const {
+        return dati->set;
+    }
+
+
+    /**
+     * @brief Ritorna il Set per modificarlo, dopo averlo staccato dalle altre copie.
+     *
+     * Il riferimento resta valido fino alla successiva copia di questo SharedSet.
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    Set<T>& edit() {
+        stacca();
+        return dati->set;
+    }
+
+
+    /**
+     * @brief Ritorna il numero di elementi presenti nel set.
+     */
+    int size() const {
+        return dati->set.size();
+    }
+
+
+    /**
+     * @brief Controlla se un dato elemento è presente nel set.
+     *
+     * @param value il valore da controllare
+     *
+     * @return true o false
+     */
+    bool contains(const T& value) const {
+        return dati->set.contains(value);
+    }
+
+
+    /**
+     * @brief Operatore di accesso in sola lettura.
+     *
+     * @param index l'indice dell'elemento
+     *
+     * @return reference all'elemento
+     *
+     * @throw invoca std::out_of_range
+     */
+    const T& operator[](int index) const {
+        return dati->set[index];
+    }
+
+
+    /**
+     * @brief Aggiunge un nuovo elemento nel set, staccandolo se è condiviso.
+     *
+     * Come Set::add, un elemento già presente viene ignorato.
+     *
+     * @param value il valore da aggiungere
+     */
+    void add(const T& value) {
+        if (is_shared() && dati->set.contains(value)) {
+            // il set non cambierebbe: non serve copiarlo
+            return;
+        }
+        edit().add(value);
+    }
+
+
+    /**
+     * @brief Elimina un certo elemento dal set, staccandolo se è condiviso.
+     *
+     * Come Set::remove, un elemento assente viene ignorato.
+     *
+     * @param value il valore da rimuovere
+     */
+    void remove(const T& value) {
+        if (is_shared() && !dati->set.contains(value)) {
+            // il set non cambierebbe: non serve copiarlo
+            return;
+        }
+        edit().remove(value);
+    }
+
+
+    /**
+     * @brief Svuota il set; se era condiviso lascia gli elementi alle altre copie senza copiarli.
+     */
+    void clear() {
+        SharedSet vuoto;
+        swap(vuoto);
+    }
+
+
+    /**
+     * @brief Ritorna un iteratore costante al primo elemento del set.
+     */
+    const_iterator begin() const {
+        return dati->set.begin();
+    }
+
+
+    /**
+     * @brief Ritorna un iteratore costante che punta appena oltre l'ultimo elemento del set.
+     */
+    const_iterator end() const {
+        return dati->set.end();
+    }
+
+
+    /**
+     * @brief Funzione GLOBALE che implementa l'operatore di uguaglianza.
+     *
+     * Due copie che condividono gli elementi sono uguali senza confrontarli.
+     */
+    friend bool operator==(const SharedSet& a, const SharedSet& b) {
+        return a.dati == b.dati || a.dati->set == b.dati->set;
+    }
+
+
+    /**
+     * @brief Funzione GLOBALE che implementa l'operatore di stream, nel formato di Set.
+     */
+    friend ostream& operator<<(ostream& os, const SharedSet& s) {
+        return os << s.dati->set;
+    }
+};
+
+
+   /**
+     * @brief Funzione GLOBALE che crea un nuovo set in base ai requisiti del predicato.
+     * 
+     * Accetta un set e un dato predicato, restituendo il nuovo set, 
+     * contenente gli elementi che soddisfano il predicato.
+     * 
+     * @param s reference al set
+     * @param p il predicato da usare
+     * 
+     * @return result il nuovo set che soddisfa il predicato
+    */
+    template <typename T, typename Predicate>
+    Set<T> filter_out(const Set<T>& s, Predicate p) {
+        Set<T> result;
+        for (int i = 0; i < s.size(); ++i) {
+            if (p(s[i])) {
+                // gli elementi di s sono già distinti
+                result.add_unchecked(s[i]);
+            }
+        }
+        return result;
+    }
+
+   /**
+     * @brief Funzione GLOBALE che filtra un set tenendo gli elementi presenti in un altro set.
+     *
+     * Un Set usato come predicato: restituisce gli elementi di s contenuti in ammessi.
+     * Quando entrambi i set sono grandi le appartenenze vengono controllate tutte
+     * insieme con contains_many.
+     *
+     * @param s reference al set da filtrare
+     * @param ammessi reference al set degli elementi da tenere
+     *
+     * @return result, il nuovo set con gli elementi di s presenti in ammessi
+    */
+    template <typename T>
+    Set<T> filter_out(const Set<T>& s, const Set<T>& ammessi) {
+        return s - ammessi;
+    }
+
+   /**
+     * @brief Funzione GLOBALE che implementa l'operatore di unione.
+     * 
+     * La funzione concatena gli elementi dei due set, controllando 
+     * se sono già presenti nel nuovo set per evitare i duplicati.
+     * 
+     * @param a reference al primo set
+     * @param b reference al secondo set
+     * 
+     * @return result, il nuovo set
+    */
+    template <typename T>
+    Set<T> operator+(const Set<T>& a, const Set<T>& b) {
+        Set<T> result;
+        // Aggiungi tutti gli elementi del primo set al set risultante
+        for (int i = 0; i < a.size(); ++i) {
+            result.add(a[i]);
+        }
+        // Aggiungi tutti gli elementi del secondo set al set risultante
+        // Controlla se sono già presenti nel set per evitare duplicati
+        for (int i = 0; i < b.size(); ++i) {
+            if (!result.contains(b[i])) {
+                result.add(b[i]);
+            }
+        }
+        return result;
+    }
+
+
+   /**
+     * @brief Funzione GLOBALE che implementa l'operatore di intersezione.
+     * 
+     * La funzione crea l'intersezione di due set, controllando 
+     * se sono già presenti nel nuovo set per evitare i duplicati.
+     * 
+     * @param a reference al primo set
+     * @param b reference al secondo set
+     * 
+     * @return result, il nuovo set
+    */
+    template <typename T>
+    Set<T> operator-(const Set<T>& a, const Set<T>& b) {
+        Set<T> result;
+        // Con due set grandi si controllano tutte le appartenenze in un colpo solo
+        if (a.size() >= Set<T>::batch_threshold && b.size() >= Set<T>::batch_threshold) {
+            vector<bool> presenti;
+            result.reserve(static_cast<int>(b.contains_many(&a[0], static_cast<size_t>(a.size()), presenti)));
+            for (int i = 0; i < a.size(); ++i) {
+                if (presenti[i]) {
+                    result.add_unchecked(a[i]);
+                }
+            }
+            return result;
+        }
+        // Itera su tutti gli elementi del primo set
+        for (int i = 0; i < a.size(); ++i) {
+            // Se un elemento del primo set è presente anche nel secondo set,
+            // lo aggiunge al set risultante
+            if (b.contains(a[i])) {
+                result.add(a[i]);
+            }
+        }
+        return result;
+    }
+
+
+/**
+ * @brief Calcola il numero di passi della ricerca binaria di StaticSet su n elementi.
+ */
+constexpr size_t static_set_steps(size_t n) {
+    size_t passi = 0;
+    for (; n > 1; n -= n / 2) {
+        ++passi;
+    }
+    return passi;
+}
+
+
+/**
+  @brief classe StaticSet
+
+  Set di N elementi noti a tempo di compilazione (ad esempio l'elenco delle scuole
+  o delle sale), costruito con make_static_set in un'espressione constexpr. Gli
+  elementi vengono ordinati durante la compilazione e i duplicati rendono la
+  costruzione un errore di compilazione. Non alloca memoria: l'array fa parte
+  dell'oggetto e, per un oggetto constexpr, si trova nei dati in sola lettura.
+
+  contains è una ricerca binaria su N fisso: il numero di passi è una costante,
+  quindi il compilatore srotola il ciclo in pochi confronti senza salti e, se
+  anche il valore è costante, calcola il risultato durante la compilazione.
+  Per le stringhe si usa string_view, confrontabile anche con string.
+
+  Un StaticSet si può passare direttamente come predicato a filter_out e si
+  combina con Set negli operatori di unione (+) e intersezione (-).
+*/
+template <typename T, size_t N>
+class StaticSet {
+    static_assert(N > 0, "StaticSet deve contenere almeno un elemento");
+
+    T elementi[N]; ///< gli elementi in ordine crescente
+    static constexpr size_t PASSI = static_set_steps(N); ///< passi della ricerca binaria
+
+public:
+    typedef const T* const_iterator; ///< Iteratore costante sugli elementi, in ordine crescente
+
+    /**
+     * @brief Costruttore: copia e ordina gli elementi (ordinamento per inserimento).
+     *
+     * @param valori gli elementi del set
+     *
+     * @throw invoca duplicateElementException() se un elemento è ripetuto
+     * (in un'espressione constexpr diventa un errore di compilazione)
+     */
+    constexpr StaticSet(const T (&valori)[N]) : elementi{} {
+        for (size_t i = 0; i < N; ++i) {
+            size_t j = i;
+            while (j > 0 && valori[i] < elementi[j - 1]) {
+                elementi[j] = elementi[j - 1];
+                --j;
+            }
+            elementi[j] = valori[i];
+        }
+        for (size_t i = 1; i < N; ++i) {
+            if (!(elementi[i - 1] < elementi[i])) {
+                throw duplicateElementException();
+            }
+        }
+    }
+
+    /**
+     * @brief Controlla se un dato elemento è presente nel set.
+     *
+     * @param value il valore da controllare (di un tipo confrontabile con T)
+     *
+     * @return true o false
+     */
+    template <typename U>
+    constexpr bool contains(const U& value) const {
+        // alla fine base punta all'ultimo elemento non maggiore di value (o al primo);
+        // il numero di passi è costante, quindi il ciclo viene srotolato
+        const T* base = elementi;
+        size_t n = N;
+#if defined(__GNUC__)
+#pragma GCC unroll 64
+#endif
+        for (size_t passo = 0; passo < PASSI; ++passo) {
+            size_t meta = n / 2;
+            base = (value < base[meta]) ? base : base + meta;
+            n -= meta;
+        }
+        return !(value < *base) && !(*base < value);
+    }
+
+    /**
+     * @brief Permette di usare il set come predicato (ad esempio con filter_out).
+     *
+     * @param value il valore da controllare
+     *
+     * @return true se il valore è nel set
+     */
+    template <typename U>
+    constexpr bool operator()(const U& value) const {
+        return contains(value);
+    }
+
+    /**
+     * @brief Ritorna il numero di elementi presenti nel set.
+     */
+    constexpr int size() const {
+        return static_cast<int>(N);
+    }
+
+    /**
+     * @brief Operatore di accesso in sola lettura, in ordine crescente.
+     *
+     * @throw invoca std::out_of_range
+     */
+    constexpr const T& operator[](int index) const {
+        if (index < 0 || index >= static_cast<int>(N)) {
+            throw out_of_range("Indice fuori dai limiti");
+        }
+        return elementi[index];
+    }
+
+    /**
+     * @brief Ritorna un iteratore costante al primo elemento del set.
+     */
+    constexpr const_iterator begin() const {
+        return elementi;
+    }
+
+    /**
+     * @brief Ritorna un iteratore costante che punta appena oltre l'ultimo elemento del set.
+     */
+    constexpr const_iterator end() const {
+        return elementi + N;
+    }
+};
+
+
+   /**
+     * @brief Funzione GLOBALE che crea un StaticSet, anche in un'espressione constexpr.
+     *
+     * Il tipo degli elementi si può indicare esplicitamente, ad esempio
+     * make_static_set<string_view>({"fiorentina", "veneta"}).
+     *
+     * @param valori gli elementi del set
+     *
+     * @return il nuovo set
+    */
+    template <typename T, size_t N>
+    constexpr StaticSet<T, N> make_static_set(const T (&valori)[N]) {
+        return StaticSet<T, N>(valori);
+    }
+
+
+   /**
+     * @brief Funzione GLOBALE che implementa l'unione tra un Set e un StaticSet.
+     *
+     * @param a reference al set
+     * @param b reference al set statico, con elementi convertibili in T
+     *
+     * @return result, il nuovo set con gli elementi di a seguiti da quelli di b non presenti in a
+    */
+    template <typename T, typename U, size_t N>
+    Set<T> operator+(const Set<T>& a, const StaticSet<U, N>& b) {
+        Set<T> result(a);
+        result.reserve(a.size() + static_cast<int>(N));
+        for (const U& u : b) {
+            T value(u);
+            if (!a.contains(value)) {
+                result.add_unchecked(value);
+            }
         }
         return result;
     }
 
+
    /**
-     * @brief Funzione GLOBALE che implementa l'operatore di unione.
-     * 
-     * La funzione concatena gli elementi dei due set, controllando 
-     * se sono già presenti nel nuovo set per evitare i duplicati.
-     * 
-     * @param a reference al primo set
-     * @param b reference al secondo set
-     * 
-     * @return result, il nuovo set
+     * @brief Funzione GLOBALE che implementa l'unione tra un StaticSet e un Set.
+     *
+     * @param a reference al set statico, con elementi convertibili in T
+     * @param b reference al set
+     *
+     * @return result, il nuovo set con gli elementi di a seguiti da quelli di b non presenti in a
     */
-    template <typename T>
-    Set<T> operator+(const Set<T>& a, const Set<T>& b) {
+    template <typename T, typename U, size_t N>
+    Set<T> operator+(const StaticSet<U, N>& a, const Set<T>& b) {
         Set<T> result;
-        // Aggiungi tutti gli elementi del primo set al set risultante
-        for (int i = 0; i < a.size(); ++i) {
-            result.add(a[i]);
+        result.reserve(static_cast<int>(N) + b.size());
+        for (const U& u : a) {
+            result.add_unchecked(T(u));
         }
-        // Aggiungi tutti gli elementi del secondo set al set risultante
-        // Controlla se sono già presenti nel set per evitare duplicati
         for (int i = 0; i < b.size(); ++i) {
-            if (!result.contains(b[i])) {
-                result.add(b[i]);
+            if (!a.contains(b[i])) {
+                result.add_unchecked(b[i]);
             }
         }
         return result;
@@ -587,47 +1972,564 @@ public:
 
 
    /**
-     * @brief Funzione GLOBALE che implementa l'operatore di intersezione.
-     * 
-     * La funzione crea l'intersezione di due set, controllando 
-     * se sono già presenti nel nuovo set per evitare i duplicati.
-     * 
-     * @param a reference al primo set
-     * @param b reference al secondo set
-     * 
-     * @return result, il nuovo set
+     * @brief Funzione GLOBALE che implementa l'intersezione tra un Set e un StaticSet.
+     *
+     * Ogni controllo di appartenenza è una ricerca nel set statico, senza scandire un Set.
+     *
+     * @param a reference al set
+     * @param b reference al set statico
+     *
+     * @return result, il nuovo set con gli elementi di a presenti anche in b
     */
-    template <typename T>
-    Set<T> operator-(const Set<T>& a, const Set<T>& b) {
+    template <typename T, typename U, size_t N>
+    Set<T> operator-(const Set<T>& a, const StaticSet<U, N>& b) {
         Set<T> result;
-        // Itera su tutti gli elementi del primo set
         for (int i = 0; i < a.size(); ++i) {
-            // Se un elemento del primo set è presente anche nel secondo set,
-            // lo aggiunge al set risultante
             if (b.contains(a[i])) {
-                result.add(a[i]);
+                result.add_unchecked(a[i]);
             }
         }
         return result;
     }
 
+
    /**
-     * @brief Funzione GLOBALE che salva il contenuto di un set di stringhe in un file.
-     * 
-     * @param s set di stringhe da salvare
+     * @brief Funzione GLOBALE che implementa l'intersezione tra un StaticSet e un Set.
+     *
+     * @param a reference al set statico
+     * @param b reference al set
+     *
+     * @return result, il nuovo set con gli elementi di a presenti anche in b, in ordine crescente
+    */
+    template <typename T, typename U, size_t N>
+    Set<T> operator-(const StaticSet<U, N>& a, const Set<T>& b) {
+        Set<T> result;
+        for (const U& u : a) {
+            T value(u);
+            if (b.contains(value)) {
+                result.add_unchecked(value);
+            }
+        }
+        return result;
+    }
+
+   /**
+     * @brief Formattatore di default usato da save e dalle funzioni write_set.
+     *
+     * Aggiunge in coda al buffer la rappresentazione testuale di un elemento:
+     * le stringhe vengono copiate così come sono, i numeri convertiti direttamente
+     * con to_chars (i numeri reali con 6 cifre significative, come l'operatore di
+     * stream), gli altri tipi passano per l'operatore di stream.
+     */
+    template <typename T>
+    struct default_formatter {
+        void operator()(string& buffer, const T& value) const {
+            if constexpr (is_same<T, string>::value) {
+                buffer += value;
+            } else if constexpr (is_same<T, char>::value) {
+                buffer += value;
+            } else if constexpr (is_integral<T>::value && !is_same<T, bool>::value) {
+                char cifre[24];
+                to_chars_result r = to_chars(cifre, cifre + sizeof(cifre), value);
+                buffer.append(cifre, r.ptr);
+            } else if constexpr (is_floating_point<T>::value) {
+                char cifre[64];
+                to_chars_result r = to_chars(cifre, cifre + sizeof(cifre), value, chars_format::general, 6);
+                buffer.append(cifre, r.ptr);
+            } else {
+                ostringstream os;
+                os << value;
+                buffer += os.str();
+            }
+        }
+    };
+
+
+   /**
+     * @brief Scrive tutto il contenuto di un buffer su un descrittore di file.
+     *
+     * Ripete la write finché il buffer non è stato scritto completamente
+     * (una write può scrivere meno byte di quelli richiesti).
+     *
+     * @param fd il descrittore del file
+     * @param dati puntatore ai byte da scrivere
+     * @param n il numero di byte da scrivere
+     *
+     * @return true se tutti i byte sono stati scritti, false altrimenti
+    */
+    inline bool write_all(int fd, const char* dati, size_t n) {
+        while (n > 0) {
+#ifdef _WIN32
+            int scritti = _write(fd, dati, static_cast<unsigned int>(n > INT_MAX ? INT_MAX : n));
+#else
+            ssize_t scritti = ::write(fd, dati, n);
+#endif
+            if (scritti < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            dati += scritti;
+            n -= static_cast<size_t>(scritti);
+        }
+        return true;
+    }
+
+
+   /**
+     * @brief Crea (o tronca) il file temporaneo in cui scrivere prima della rename.
+     *
+     * @param temp il nome del file temporaneo
+     *
+     * @return il descrittore del file aperto in scrittura
+     *
+     * @throw invoca runtime_error
+    */
+    inline int open_temp_file(const string& temp) {
+#ifdef _WIN32
+        int fd = _open(temp.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+        if (fd < 0) {
+            throw runtime_error("Impossibile aprire il file");
+        }
+        return fd;
+    }
+
+
+   /**
+     * @brief Chiude il file temporaneo e lo sposta al posto del file di destinazione.
+     *
+     * Se la scrittura non è andata a buon fine, o se la chiusura o la rename falliscono,
+     * il file temporaneo viene eliminato e il file di destinazione resta invariato.
+     *
+     * @param fd il descrittore del file temporaneo
+     * @param temp il nome del file temporaneo
+     * @param filename il nome del file di destinazione
+     * @param ok false se la scrittura è già fallita
+     * @param sincronizza se true il file viene forzato su disco (fsync) prima della rename
+     *
+     * @throw invoca runtime_error
+    */
+    inline void commit_temp_file(int fd, const string& temp, const string& filename, bool ok, bool sincronizza) {
+#ifdef _WIN32
+        ok = ok && (!sincronizza || _commit(fd) == 0);
+        ok = (_close(fd) == 0) && ok;
+        // MoveFileEx sostituisce il file di destinazione, cosa che rename non fa su Windows
+        ok = ok && MoveFileExA(temp.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+        ok = ok && (!sincronizza || ::fsync(fd) == 0);
+        ok = (::close(fd) == 0) && ok;
+        ok = ok && ::rename(temp.c_str(), filename.c_str()) == 0;
+#endif
+        if (!ok) {
+            std::remove(temp.c_str());
+            throw runtime_error("Errore durante la scrittura del file");
+        }
+    }
+
+
+   /**
+     * @brief Funzione GLOBALE che salva il contenuto di un set in un file, un elemento per riga.
+     *
+     * Gli elementi vengono formattati in un buffer di grandi dimensioni che viene
+     * scritto con una sola write ogni volta che si riempie. Il contenuto viene scritto
+     * in un file temporaneo (filename + ".tmp") che poi sostituisce il file di
+     * destinazione con una rename: chi legge il file vede il contenuto vecchio
+     * oppure quello nuovo completo, mai un file scritto a metà.
+     *
+     * @param s set da salvare
      * @param filename il nome del file in cui salvare il set
+     * @param fmt il formattatore, chiamato come fmt(buffer, elemento) per aggiungere un elemento al buffer
+     * @param sincronizza se true il file viene forzato su disco (fsync) prima della rename
+     * @param dimBuffer la dimensione del buffer di scrittura in byte
+     *
+     * @throw invoca runtime_error
+    */
+    template <typename T, typename Formatter = default_formatter<T>>
+    void save(const Set<T>& s, const string& filename, Formatter fmt = Formatter(),
+              bool sincronizza = false, size_t dimBuffer = 1 << 20) {
+        const string temp = filename + ".tmp";
+        int fd = open_temp_file(temp);
+
+        bool ok = true;
+        string buffer;
+        buffer.reserve(dimBuffer + 256);
+        for (typename Set<T>::const_iterator it = s.begin(); it != s.end() && ok; ++it) {
+            fmt(buffer, *it);
+            buffer += '\n';
+            // il buffer viene scritto solo quando è pieno: una write per blocco invece che per riga
+            if (buffer.size() >= dimBuffer) {
+                ok = write_all(fd, buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        }
+        ok = ok && write_all(fd, buffer.data(), buffer.size());
+        commit_temp_file(fd, temp, filename, ok, sincronizza);
+    }
+
+   /**
+     * @brief Aggiunge a un buffer una stringa JSON (tra virgolette, con i caratteri speciali protetti).
+     *
+     * @param buffer il buffer
+     * @param testo il testo da aggiungere
+    */
+    inline void append_json_string(string& buffer, const string& testo) {
+        static const char esadecimali[] = "0123456789abcdef";
+        buffer += '"';
+        for (char c : testo) {
+            switch (c) {
+            case '"':  buffer += "\\\""; break;
+            case '\\': buffer += "\\\\"; break;
+            case '\n': buffer += "\\n"; break;
+            case '\r': buffer += "\\r"; break;
+            case '\t': buffer += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    buffer += "\\u00";
+                    buffer += esadecimali[(c >> 4) & 0xF];
+                    buffer += esadecimali[c & 0xF];
+                } else {
+                    buffer += c;
+                }
+            }
+        }
+        buffer += '"';
+    }
+
+
+   /**
+     * @brief Aggiunge a un buffer un campo CSV, tra virgolette solo se necessario.
+     *
+     * @param buffer il buffer
+     * @param testo il testo da aggiungere
+    */
+    inline void append_csv_field(string& buffer, const string& testo) {
+        if (testo.find_first_of(",\"\r\n") == string::npos) {
+            buffer += testo;
+            return;
+        }
+        buffer += '"';
+        for (char c : testo) {
+            if (c == '"') buffer += '"';
+            buffer += c;
+        }
+        buffer += '"';
+    }
+
+
+   /**
+     * @brief Scrive un set in un buffer nel formato richiesto, chiamando svuota quando il buffer
+     * supera la soglia indicata.
+     *
+     * Funzione di supporto delle due versioni di write_set.
+    */
+    template <typename T, typename Formatter, typename Svuota>
+    void write_set_blocks(string& buffer, const Set<T>& s, set_format formato, Formatter fmt,
+                          size_t soglia, Svuota svuota) {
+        // i numeri si scrivono così come sono anche in JSON e in CSV
+        const bool numerico = is_arithmetic<T>::value && !is_same<T, bool>::value && !is_same<T, char>::value;
+        string testo;
+        if (formato == set_format::legacy) {
+            buffer += to_string(s.size());
+            if (s.size() > 0) buffer += " (";
+        } else if (formato == set_format::json) {
+            buffer += '[';
+        }
+        for (int i = 0; i < s.size(); ++i) {
+            if (formato == set_format::legacy) {
+                if (i > 0) buffer += ") (";
+                fmt(buffer, s[i]);
+            } else if (numerico) {
+                if (i > 0 && formato == set_format::json) buffer += ',';
+                bool finito = true;
+                if constexpr (is_floating_point<T>::value) {
+                    finito = isfinite(s[i]);
+                }
+                if (formato == set_format::json && !finito) {
+                    // JSON non ha un valore per NaN e per gli infiniti
+                    buffer += "null";
+                } else {
+                    fmt(buffer, s[i]);
+                }
+            } else {
+                if (i > 0 && formato == set_format::json) buffer += ',';
+                testo.clear();
+                fmt(testo, s[i]);
+                if (formato == set_format::json) {
+                    append_json_string(buffer, testo);
+                } else {
+                    append_csv_field(buffer, testo);
+                }
+            }
+            if (formato == set_format::csv) buffer += '\n';
+            if (buffer.size() >= soglia) {
+                svuota(buffer);
+            }
+        }
+        if (formato == set_format::legacy) {
+            if (s.size() > 0) buffer += ")";
+        } else if (formato == set_format::json) {
+            buffer += ']';
+        }
+    }
+
+
+   /**
+     * @brief Funzione GLOBALE che scrive un set in coda a un buffer del chiamante.
+     *
+     * Gli elementi vengono convertiti direttamente nel buffer (to_chars per i numeri,
+     * copia per le stringhe), senza passare per gli stream. In JSON i numeri non
+     * finiti (NaN, infinito) vengono scritti come null.
+     *
+     * @param buffer il buffer a cui aggiungere il testo
+     * @param s il set da scrivere
+     * @param formato il formato: legacy ("n (a) (b)"), json o csv
+     * @param fmt il formattatore degli elementi
+    */
+    template <typename T, typename Formatter = default_formatter<T>>
+    void write_set(string& buffer, const Set<T>& s, set_format formato = set_format::legacy,
+                   Formatter fmt = Formatter()) {
+        write_set_blocks(buffer, s, formato, fmt, string::npos, [](string&) {});
+    }
+
+
+   /**
+     * @brief Funzione GLOBALE che scrive un set su un descrittore di file.
+     *
+     * Il testo viene preparato in un buffer di dimBuffer byte che viene scritto
+     * con una sola write ogni volta che si riempie.
+     *
+     * @param fd il descrittore del file (ad esempio 1 per lo standard output)
+     * @param s il set da scrivere
+     * @param formato il formato: legacy ("n (a) (b)"), json o csv
+     * @param dimBuffer la dimensione del buffer in byte
+     *
+     * @throw invoca runtime_error se la scrittura fallisce
     */
-    inline void save(const Set<std::string>& s, const std::string& filename) {
-        ofstream file(filename);
-        if (file.is_open()) {
-            for (Set<string>::const_iterator it = s.begin(); it != s.end(); ++it) {
-                file << *it << endl;
+    template <typename T, typename Formatter = default_formatter<T>>
+    void write_set(int fd, const Set<T>& s, set_format formato = set_format::legacy,
+                   size_t dimBuffer = 1 << 16, Formatter fmt = Formatter()) {
+        string buffer;
+        buffer.reserve(dimBuffer + 256);
+        auto svuota = [fd](string& b) {
+            if (!write_all(fd, b.data(), b.size())) {
+                throw runtime_error("Errore durante la scrittura del file");
+            }
+            b.clear();
+        };
+        write_set_blocks(buffer, s, formato, fmt, dimBuffer, svuota);
+        svuota(buffer);
+    }
+
+
+   /**
+     * @brief Interprete di default usato da SetReader e load.
+     *
+     * Converte il testo di una riga nell'elemento: le stringhe vengono copiate
+     * così come sono, i numeri interi convertiti direttamente, gli altri tipi
+     * passano per l'operatore di stream.
+     */
+    template <typename T>
+    struct default_parser {
+        bool operator()(const char* testo, size_t n, T& value) const {
+            if constexpr (is_same<T, string>::value) {
+                value.assign(testo, n);
+                return true;
+            } else if constexpr (is_integral<T>::value && !is_same<T, bool>::value && !is_same<T, char>::value) {
+                from_chars_result r = from_chars(testo, testo + n, value);
+                return r.ec == errc() && r.ptr == testo + n;
+            } else {
+                istringstream is(string(testo, n));
+                return static_cast<bool>(is >> value);
+            }
+        }
+    };
+
+
+/**
+  @brief classe SetReader
+
+  Legge un file con un elemento per riga (il formato scritto da save) a blocchi
+  di grandi dimensioni, senza caricare tutto il file in memoria. Gli elementi
+  vengono restituiti uno alla volta con next oppure passati a una callback con
+  for_each, quindi il file può essere più grande della memoria disponibile.
+*/
+template <typename T, typename Parser = default_parser<T>>
+class SetReader {
+    FILE* file; ///< il file aperto in lettura
+    Parser parser; ///< l'interprete delle righe
+    size_t dimBlocco; ///< il numero di byte letti ad ogni accesso al file
+    uintmax_t dimFile; ///< la dimensione del file in byte
+    string blocco; ///< i byte letti e non ancora consumati
+    size_t pos; ///< la posizione della prossima riga in blocco
+    bool fineFile; ///< true quando il file è stato letto completamente
+
+    // Legge il blocco successivo, conservando la riga incompleta rimasta in fondo
+    bool riempi() {
+        if (fineFile) {
+            return false;
+        }
+        blocco.erase(0, pos);
+        pos = 0;
+        size_t vecchio = blocco.size();
+        blocco.resize(vecchio + dimBlocco);
+        size_t letti = fread(&blocco[vecchio], 1, dimBlocco, file);
+        blocco.resize(vecchio + letti);
+        if (letti < dimBlocco) {
+            if (ferror(file)) {
+                throw runtime_error("Errore durante la lettura del file");
             }
-            file.close();
+            fineFile = true;
         }
-        else {
+        return letti > 0;
+    }
+
+public:
+    /**
+     * @brief Costruttore che apre il file da leggere.
+     *
+     * @param filename il nome del file
+     * @param dimBlocco il numero di byte letti ad ogni accesso al file
+     * @param parser l'interprete delle righe, chiamato come parser(testo, lunghezza, elemento)
+     *
+     * @throw invoca runtime_error
+     */
+    explicit SetReader(const string& filename, size_t dimBlocco = 1 << 20, Parser parser = Parser())
+        : file(nullptr), parser(parser), dimBlocco(dimBlocco > 0 ? dimBlocco : 1), dimFile(0), pos(0), fineFile(false) {
+        file = fopen(filename.c_str(), "rb");
+        if (file == nullptr) {
             throw runtime_error("Impossibile aprire il file");
         }
+        error_code errore;
+        dimFile = filesystem::file_size(filename, errore);
+        if (errore) {
+            dimFile = 0;
+        }
+    }
+
+    SetReader(const SetReader&) = delete;
+    SetReader& operator=(const SetReader&) = delete;
+
+    /**
+     * @brief Distruttore, chiude il file.
+     */
+    ~SetReader() {
+        fclose(file);
+    }
+
+    /**
+     * @brief Ritorna la dimensione del file in byte.
+     *
+     * @return la dimensione del file
+     */
+    uintmax_t file_size() const {
+        return dimFile;
+    }
+
+    /**
+     * @brief Stima il numero di elementi del file.
+     *
+     * La stima divide la dimensione del file per la lunghezza media delle righe
+     * del primo blocco, che viene letto se non lo è già stato.
+     *
+     * @return il numero stimato di elementi
+     */
+    size_t estimated_count() {
+        if (blocco.empty()) {
+            riempi();
+        }
+        size_t righe = 0;
+        for (size_t i = pos; i < blocco.size(); ++i) {
+            if (blocco[i] == '\n') ++righe;
+        }
+        if (righe == 0) {
+            return blocco.empty() ? 0 : 1;
+        }
+        return static_cast<size_t>(dimFile / ((blocco.size() - pos) / righe + 1)) + 1;
+    }
+
+    /**
+     * @brief Legge l'elemento successivo.
+     *
+     * @param value l'elemento letto
+     *
+     * @return true se è stato letto un elemento, false alla fine del file
+     *
+     * @throw invoca runtime_error se una riga non è interpretabile
+     */
+    bool next(T& value) {
+        size_t fine;
+        while ((fine = blocco.find('\n', pos)) == string::npos) {
+            if (!riempi()) {
+                // l'ultima riga può non terminare con un a capo
+                if (pos >= blocco.size()) {
+                    return false;
+                }
+                fine = blocco.size();
+                break;
+            }
+        }
+        size_t n = fine - pos;
+        if (n > 0 && blocco[pos + n - 1] == '\r') {
+            --n;
+        }
+        if (!parser(blocco.data() + pos, n, value)) {
+            throw runtime_error("Riga non valida nel file");
+        }
+        pos = fine < blocco.size() ? fine + 1 : fine;
+        return true;
+    }
+
+    /**
+     * @brief Passa tutti gli elementi rimanenti a una callback.
+     *
+     * @param f la callback, chiamata come f(elemento) per ogni elemento
+     *
+     * @return il numero di elementi letti
+     */
+    template <typename Callback>
+    size_t for_each(Callback f) {
+        size_t letti = 0;
+        T value;
+        while (next(value)) {
+            f(value);
+            ++letti;
+        }
+        return letti;
+    }
+};
+
+
+   /**
+     * @brief Funzione GLOBALE che carica un set da un file scritto da save.
+     *
+     * Il contenuto precedente del set viene sostituito solo se il caricamento
+     * termina senza errori. Lo spazio viene riservato in anticipo in base alla
+     * dimensione del file. Le righe duplicate vengono ignorate, a meno che il file
+     * non sia dichiarato fidato: in quel caso il controllo viene saltato.
+     *
+     * @param s il set da caricare
+     * @param filename il nome del file
+     * @param fidato true se il file è stato scritto da save e non contiene duplicati
+     * @param parser l'interprete delle righe
+     *
+     * @throw invoca runtime_error
+    */
+    template <typename T, typename Parser = default_parser<T>>
+    void load(Set<T>& s, const string& filename, bool fidato = false, Parser parser = Parser()) {
+        SetReader<T, Parser> reader(filename, 1 << 20, parser);
+        Set<T> result;
+        size_t stima = reader.estimated_count();
+        result.reserve(static_cast<int>(stima < INT_MAX ? stima : INT_MAX));
+        reader.for_each([&result, fidato](const T& value) {
+            if (fidato) {
+                result.add_unchecked(value);
+            } else if (!result.contains(value)) {
+                result.add(value);
+            }
+        });
+        s.swap(result);
     }
 
     /**
@@ -0,0 +1,111 @@
+#include "stringpool.h"
+
+#include <stdexcept>
+
+// Costruttore di copia: le viste della tabella devono riferirsi alle nuove stringhe
+StringPool::StringPool(const StringPool& altro) : valori(altro.valori) {
+    ids.reserve(valori.size());
+    for (size_t id = 0; id < valori.size(); ++id) {
+        ids.emplace(std::string_view(valori[id]), static_cast<int>(id));
+    }
+}
+
+
+// Operatore di assegnamento
+StringPool& StringPool::operator=(const StringPool& altro) {
+    if (this != &altro) {
+        StringPool temp(altro);
+        *this = std::move(temp);
+    }
+    return *this;
+}
+
+
+// Ritorna l'id di una stringa, inserendola se non è ancora presente
+int StringPool::intern(const std::string& s) {
+    std::unordered_map<std::string_view, int>::const_iterator it = ids.find(std::string_view(s));
+    if (it != ids.end()) {
+        return it->second;
+    }
+    int id = static_cast<int>(valori.size());
+    valori.push_back(s);
+    // la chiave è una vista sulla copia canonica, che il deque non sposta più
+    ids.emplace(std::string_view(valori.back()), id);
+    return id;
+}
+
+
+// Ritorna l'id di una stringa senza inserirla
+int StringPool::find(const std::string& s) const {
+    std::unordered_map<std::string_view, int>::const_iterator it = ids.find(std::string_view(s));
+    return it == ids.end() ? -1 : it->second;
+}
+
+
+// Ritorna la stringa canonica di un id
+const std::string& StringPool::value(int id) const {
+    if (id < 0 || id >= static_cast<int>(valori.size())) {
+        throw std::out_of_range("Id della stringa fuori dai limiti");
+    }
+    return valori[id];
+}
+
+
+// Ritorna il numero di stringhe distinte
+int StringPool::size() const {
+    return static_cast<int>(valori.size());
+}
+
+
+// Svuota l'insieme
+void StringPool::clear() {
+    ids.clear();
+    valori.clear();
+}
+
+
+// Converte una riga di valori in una tupla di id
+RigaCatalogo CatalogDictionary::intern(const std::vector<std::string>& valori) {
+    RigaCatalogo riga;
+    for (int j = 0; j < COLONNE_CATALOGO; ++j) {
+        riga[j] = colonne[j].intern(j < static_cast<int>(valori.size()) ? valori[j] : std::string());
+    }
+    return riga;
+}
+
+
+// Ritorna l'id di un valore di una colonna, inserendolo se non è ancora presente
+int CatalogDictionary::intern(int colonna, const std::string& valore) {
+    return colonne.at(colonna).intern(valore);
+}
+
+
+// Converte una tupla di id nei valori della riga
+std::vector<std::string> CatalogDictionary::values(const RigaCatalogo& riga) const {
+    std::vector<std::string> valori;
+    valori.reserve(COLONNE_CATALOGO);
+    for (int j = 0; j < COLONNE_CATALOGO; ++j) {
+        valori.push_back(colonne[j].value(riga[j]));
+    }
+    return valori;
+}
+
+
+// Ritorna il valore di un id in una colonna
+const std::string& CatalogDictionary::value(int colonna, int id) const {
+    return colonne.at(colonna).value(id);
+}
+
+
+// Ritorna il dizionario di una colonna
+const StringPool& CatalogDictionary::column(int colonna) const {
+    return colonne.at(colonna);
+}
+
+
+// Svuota tutti i dizionari
+void CatalogDictionary::clear() {
+    for (StringPool& pool : colonne) {
+        pool.clear();
+    }
+}
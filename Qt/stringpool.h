@@ -0,0 +1,178 @@
+/**
+ * @file stringpool.h
+ *
+ * @brief File header delle classi StringPool e CatalogDictionary
+ *
+ * File di dichiarazioni delle classi che assegnano ad ogni valore distinto del catalogo
+ * un id intero compatto e ne conservano una sola copia (interning).
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <array>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Numero di colonne del catalogo (Scuola, Autore, Titolo, Data, Sala).
+ */
+const int COLONNE_CATALOGO = 5;
+
+/**
+ * @brief Riga del catalogo come tupla di id, uno per colonna.
+ *
+ * Ogni id si riferisce al dizionario della sua colonna: due celle della stessa
+ * colonna hanno lo stesso valore se e solo se hanno lo stesso id.
+ */
+typedef std::array<int, COLONNE_CATALOGO> RigaCatalogo;
+
+/**
+ * @brief Insieme di stringhe distinte, ognuna con un id intero compatto.
+ *
+ * Le stringhe vengono conservate una sola volta in un contenitore che non sposta
+ * gli elementi già inseriti, così la tabella di ricerca può usare delle viste
+ * sulle stringhe come chiavi senza duplicarle.
+ */
+class StringPool {
+public:
+    StringPool() = default;
+
+    /**
+     * @brief Costruttore di copia.
+     *
+     * Le chiavi della tabella di ricerca sono viste sulle stringhe della copia,
+     * quindi la tabella viene ricostruita invece di essere copiata.
+     *
+     * @param altro l'insieme da copiare
+     */
+    StringPool(const StringPool& altro);
+
+    /**
+     * @brief Operatore di assegnamento.
+     *
+     * @param altro l'insieme da copiare
+     *
+     * @return reference a questo insieme
+     */
+    StringPool& operator=(const StringPool& altro);
+
+    StringPool(StringPool&&) = default;
+    StringPool& operator=(StringPool&&) = default;
+
+    /**
+     * @brief Ritorna l'id di una stringa, inserendola se non è ancora presente.
+     *
+     * @param s la stringa
+     *
+     * @return l'id della stringa (gli id sono assegnati a partire da 0)
+     */
+    int intern(const std::string& s);
+
+    /**
+     * @brief Ritorna l'id di una stringa senza inserirla.
+     *
+     * @param s la stringa
+     *
+     * @return l'id della stringa, oppure -1 se non è presente
+     */
+    int find(const std::string& s) const;
+
+    /**
+     * @brief Ritorna la stringa canonica di un id.
+     *
+     * @param id l'id della stringa
+     *
+     * @return reference alla stringa
+     *
+     * @throw std::out_of_range se l'id non è valido
+     */
+    const std::string& value(int id) const;
+
+    /**
+     * @brief Ritorna il numero di stringhe distinte.
+     *
+     * @return il numero di stringhe
+     */
+    int size() const;
+
+    /**
+     * @brief Svuota l'insieme.
+     */
+    void clear();
+
+private:
+    std::deque<std::string> valori;                 ///< id -> stringa canonica
+    std::unordered_map<std::string_view, int> ids;  ///< vista sulla stringa canonica -> id
+};
+
+/**
+ * @brief Dizionari delle colonne del catalogo.
+ *
+ * Converte le righe di valori in tuple di id e viceversa, con un dizionario
+ * separato per ogni colonna così che gli id restino piccoli e densi.
+ */
+class CatalogDictionary {
+public:
+    /**
+     * @brief Converte una riga di valori in una tupla di id.
+     *
+     * I valori mancanti vengono trattati come stringhe vuote.
+     *
+     * @param valori i valori della riga, uno per colonna
+     *
+     * @return la tupla di id
+     */
+    RigaCatalogo intern(const std::vector<std::string>& valori);
+
+    /**
+     * @brief Ritorna l'id di un valore di una colonna, inserendolo se non è ancora presente.
+     *
+     * @param colonna la colonna
+     * @param valore il valore
+     *
+     * @return l'id del valore nel dizionario della colonna
+     */
+    int intern(int colonna, const std::string& valore);
+
+    /**
+     * @brief Converte una tupla di id nei valori della riga.
+     *
+     * @param riga la tupla di id
+     *
+     * @return i valori, uno per colonna
+     */
+    std::vector<std::string> values(const RigaCatalogo& riga) const;
+
+    /**
+     * @brief Ritorna il valore di un id in una colonna.
+     *
+     * @param colonna la colonna
+     * @param id l'id del valore
+     *
+     * @return reference al valore
+     */
+    const std::string& value(int colonna, int id) const;
+
+    /**
+     * @brief Ritorna il dizionario di una colonna.
+     *
+     * @param colonna la colonna
+     *
+     * @return reference al dizionario
+     */
+    const StringPool& column(int colonna) const;
+
+    /**
+     * @brief Svuota tutti i dizionari.
+     */
+    void clear();
+
+private:
+    std::array<StringPool, COLONNE_CATALOGO> colonne; ///< un dizionario per colonna
+};
+
+#endif // STRINGPOOL_H
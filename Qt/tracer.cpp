@@ -0,0 +1,116 @@
+#include "tracer.h"
+
+namespace {
+
+// Aggiunge un testo come stringa JSON
+void stringaJson(std::string& out, const char* testo) {
+    out += '"';
+    for (const char* c = testo; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out += '\\';
+        }
+        if (static_cast<unsigned char>(*c) >= 0x20) {
+            out += *c;
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+
+// Inizia la misura di un blocco
+Tracer::Scope::Scope(Tracer& traccia, const char* nome, const char* categoria)
+    : traccia(&traccia), nome(nome), categoria(categoria), inizio(Orologio::now()) {
+}
+
+
+// Inizia la misura di un blocco, se il tracer è presente
+Tracer::Scope::Scope(Tracer* traccia, const char* nome, const char* categoria)
+    : traccia(traccia), nome(nome), categoria(categoria), inizio(traccia ? Orologio::now() : Orologio::time_point()) {
+}
+
+
+// Termina la misura di un blocco e la consegna al tracer
+Tracer::Scope::~Scope() {
+    if (traccia != nullptr) {
+        traccia->record(nome, categoria, inizio, Orologio::now());
+    }
+}
+
+
+// Costruttore: apre il file degli eventi, se indicato
+Tracer::Tracer(const std::string& percorso)
+    : file(nullptr), primoEvento(true), origine(Orologio::now()) {
+    if (!percorso.empty()) {
+        file = std::fopen(percorso.c_str(), "wb");
+    }
+    if (file != nullptr) {
+        this->percorso = percorso;
+        std::fputs("[\n", file);
+        std::fflush(file);
+    }
+}
+
+
+// Distruttore: chiude l'array JSON e il file
+Tracer::~Tracer() {
+    if (file != nullptr) {
+        std::fputs("\n]\n", file);
+        std::fclose(file);
+    }
+}
+
+
+// Registra una misura nel riepilogo e, se richiesto, nel file
+void Tracer::record(const char* nome, const char* categoria, Orologio::time_point inizio, Orologio::time_point fine) {
+    double durataMs = std::chrono::duration<double, std::milli>(fine - inizio).count();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, size_t>::iterator it = voce.find(nome);
+    if (it == voce.end()) {
+        it = voce.emplace(nome, riepilogo.size()).first;
+        riepilogo.push_back(Riepilogo{nome, 0, 0.0, 0.0});
+    }
+    Riepilogo& r = riepilogo[it->second];
+    ++r.volte;
+    r.totaleMs += durataMs;
+    if (durataMs > r.massimoMs) {
+        r.massimoMs = durataMs;
+    }
+
+    if (file == nullptr) {
+        return;
+    }
+    // evento completo: timestamp e durata in microsecondi dall'apertura del tracer
+    char numeri[96];
+    std::snprintf(numeri, sizeof(numeri), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+                  std::chrono::duration<double, std::micro>(inizio - origine).count(), durataMs * 1000.0);
+    std::string evento(primoEvento ? "{\"name\":" : ",\n{\"name\":");
+    stringaJson(evento, nome);
+    evento += ",\"cat\":";
+    stringaJson(evento, categoria);
+    evento += numeri;
+    std::fwrite(evento.data(), 1, evento.size(), file);
+    std::fflush(file);
+    primoEvento = false;
+}
+
+
+// Ritorna il riepilogo delle misure
+std::vector<Tracer::Riepilogo> Tracer::summary() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return riepilogo;
+}
+
+
+// Controlla se le misure vengono scritte su file
+bool Tracer::writing() const {
+    return file != nullptr;
+}
+
+
+// Ritorna il file in cui vengono scritte le misure
+const std::string& Tracer::path() const {
+    return percorso;
+}
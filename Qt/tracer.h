@@ -0,0 +1,150 @@
+/**
+ * @file tracer.h
+ *
+ * @brief File header della classe Tracer
+ *
+ * File di dichiarazioni della classe Tracer, che misura la durata delle operazioni
+ * dell'applicazione e le salva nel formato dei trace event di Chrome.
+ */
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Misura della durata delle operazioni dell'applicazione.
+ *
+ * Ogni operazione misurata viene sommata nel riepilogo (numero di esecuzioni, tempo
+ * totale e massimo), che costa solo una lettura dell'orologio all'inizio e alla fine.
+ * Se è stato indicato un file, ogni misura viene anche aggiunta al file come evento
+ * completo ("ph":"X") nel formato JSON dei trace event, che si apre con
+ * chrome://tracing o con Perfetto. Il file è un array JSON scritto un evento alla volta:
+ * il formato ammette che manchi la parentesi finale, quindi resta leggibile anche se
+ * l'applicazione si interrompe.
+ *
+ * Esempio di uso:
+ * @code
+ * Tracer traccia("avvio.json");
+ * {
+ *     Tracer::Scope misura(traccia, "lettura CSV");
+ *     ...
+ * }
+ * @endcode
+ */
+class Tracer {
+public:
+    typedef std::chrono::steady_clock Orologio; ///< orologio usato per le misure
+
+    /**
+     * @brief Riepilogo delle misure di un'operazione.
+     */
+    struct Riepilogo {
+        std::string nome;   ///< nome dell'operazione
+        uint64_t volte;     ///< numero di misure
+        double totaleMs;    ///< tempo totale in millisecondi
+        double massimoMs;   ///< misura più lunga in millisecondi
+    };
+
+    /**
+     * @brief Misura la durata del blocco in cui è dichiarata.
+     */
+    class Scope {
+    public:
+        /**
+         * @brief Inizia la misura.
+         *
+         * @param traccia il tracer a cui consegnare la misura
+         * @param nome il nome dell'operazione (deve restare valido fino alla fine del blocco)
+         * @param categoria la categoria dell'evento
+         */
+        Scope(Tracer& traccia, const char* nome, const char* categoria = "app");
+
+        /**
+         * @brief Inizia la misura, se il tracer è presente.
+         *
+         * @param traccia il tracer a cui consegnare la misura, oppure nullptr per non misurare
+         * @param nome il nome dell'operazione (deve restare valido fino alla fine del blocco)
+         * @param categoria la categoria dell'evento
+         */
+        Scope(Tracer* traccia, const char* nome, const char* categoria = "app");
+
+        /**
+         * @brief Termina la misura e la consegna al tracer.
+         */
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Tracer* traccia;
+        const char* nome;
+        const char* categoria;
+        Orologio::time_point inizio;
+    };
+
+    /**
+     * @brief Costruttore.
+     *
+     * @param percorso il file in cui scrivere gli eventi; se è vuoto o non si può
+     * aprire, le misure finiscono solo nel riepilogo
+     */
+    explicit Tracer(const std::string& percorso = std::string());
+
+    /**
+     * @brief Distruttore: chiude l'array JSON e il file.
+     */
+    ~Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Registra una misura.
+     *
+     * @param nome il nome dell'operazione
+     * @param categoria la categoria dell'evento
+     * @param inizio l'istante di inizio
+     * @param fine l'istante di fine
+     */
+    void record(const char* nome, const char* categoria, Orologio::time_point inizio, Orologio::time_point fine);
+
+    /**
+     * @brief Ritorna il riepilogo delle misure.
+     *
+     * @return una voce per operazione, nell'ordine della prima misura
+     */
+    std::vector<Riepilogo> summary() const;
+
+    /**
+     * @brief Controlla se le misure vengono scritte su file.
+     *
+     * @return true o false
+     */
+    bool writing() const;
+
+    /**
+     * @brief Ritorna il file in cui vengono scritte le misure.
+     *
+     * @return il percorso del file, vuoto se le misure non vengono scritte
+     */
+    const std::string& path() const;
+
+private:
+    mutable std::mutex mutex;
+    std::FILE* file;
+    std::string percorso;
+    bool primoEvento;
+    Orologio::time_point origine;                  ///< istante zero dei timestamp degli eventi
+    std::vector<Riepilogo> riepilogo;              ///< voci del riepilogo
+    std::unordered_map<std::string, size_t> voce;  ///< nome dell'operazione -> indice in riepilogo
+};
+
+#endif // TRACER_H
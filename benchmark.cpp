@@ -0,0 +1,276 @@
+/**
+ * @file benchmark.cpp
+ * @brief Misura come crescono i tempi del motore del catalogo con il numero di dipinti
+ *
+ * Genera cataloghi sintetici (CatalogGenerator) di dimensione crescente, da 10^3 a 10^7
+ * righe, e per ognuno misura con il Tracer della classe Catalog il caricamento (analisi
+ * del CSV e costruzione delle righe), la costruzione degli indici, un gruppo di ricerche,
+ * le aggregazioni usate dai grafici e la raccolta degli autori distinti in un Set<string>.
+ * Per ogni fase stima l'esponente k della crescita (tempo ~ righe^k): 1 è lineare, 2 quadratico.
+ *
+ * Uso:
+ * @code
+ * benchmark.exe [--min N] [--max N] [--repeat N] [--seed N] [--set-limit N] [--plot]
+ * benchmark.exe --generate RIGHE FILE [--seed N]
+ * @endcode
+ *
+ * Senza --plot scrive due tabelle CSV (i tempi per dimensione e gli esponenti); con --plot
+ * disegna per ogni fase il tempo per riga su scala logaritmica. Con --generate scrive
+ * soltanto un catalogo sintetico, che si può poi caricare con catalogo.exe --csv.
+ */
+
+#include "set.h"
+#include "catalog.h"
+#include "cataloggenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+
+using namespace std;
+
+/**
+ * @brief Tempo di una fase per una dimensione del catalogo.
+ */
+struct Misura {
+    size_t righe; ///< numero di dipinti del catalogo
+    string fase;  ///< nome della fase
+    double ms;    ///< tempo migliore tra le ripetizioni, in millisecondi
+};
+
+/// Fasi misurate, nell'ordine in cui vengono eseguite
+const char* const FASI[] = {
+    "analisi CSV", "costruzione righe", "indicizzazione", "ricerca", "aggregazione", "Set<string> autori"
+};
+
+/// Ricerche eseguite a ogni misura: testo e colonna (-1 = tutte)
+const pair<const char*, int> RICERCHE[] = {
+    {"fiorentina", 0},
+    {"Vasari", 1},
+    {"Empoli, L", 1},
+    {"Madonna", -1},
+    {"Botticeli", 1},
+    {"Scuola = veneta AND Data in 1500-1550", -1},
+    {"Autore ~ Lippi AND Sala ~ Tribuna", -1}
+};
+
+
+/**
+ * @brief Esegue una volta tutte le fasi su un catalogo.
+ *
+ * @param dati il catalogo in formato CSV
+ * @param conSet true per misurare anche la raccolta degli autori in un Set<string>
+ *
+ * @return il tempo totale di ogni fase, in millisecondi
+ */
+map<string, double> esegui(const string& dati, bool conSet) {
+    Tracer traccia;
+    Catalog catalogo(&traccia);
+    catalogo.loadCsvData(dati);
+
+    size_t trovate = 0;
+    for (const pair<const char*, int>& r : RICERCHE) {
+        Tracer::Scope misura(traccia, "ricerca", "benchmark");
+        trovate += catalogo.search(r.first, r.second).size();
+    }
+    {
+        Tracer::Scope misura(traccia, "aggregazione", "benchmark");
+        for (int colonna = 0; colonna < COLONNE_CATALOGO; ++colonna) {
+            trovate += catalogo.counts(colonna).size();
+        }
+        trovate += catalogo.percentages(0).size();
+        trovate += catalogo.histogram(10).size();
+        trovate += catalogo.undatedCount();
+    }
+    if (conSet) {
+        // come una raccolta ingenua dei valori distinti: contains scandisce tutto il Set
+        Tracer::Scope misura(traccia, "Set<string> autori", "benchmark");
+        Set<string> autori;
+        for (const RigaCatalogo& riga : catalogo.rows()) {
+            const string& autore = catalogo.dictionary().value(1, riga[1]);
+            if (!autori.contains(autore)) {
+                autori.add_unchecked(autore);
+            }
+        }
+        trovate += autori.size();
+    }
+    // evita che il compilatore elimini le operazioni misurate
+    if (trovate == static_cast<size_t>(-1)) {
+        cerr << trovate << endl;
+    }
+
+    map<string, double> tempi;
+    for (const Tracer::Riepilogo& r : traccia.summary()) {
+        tempi[r.nome] = r.totaleMs;
+    }
+    return tempi;
+}
+
+
+/**
+ * @brief Stima l'esponente di crescita di una fase con i minimi quadrati su scala logaritmica.
+ *
+ * @param misure i tempi della fase per dimensione crescente
+ *
+ * @return la pendenza di log(ms) rispetto a log(righe), oppure NAN con meno di due misure utili
+ */
+double esponente(const vector<Misura>& misure) {
+    // sotto i 10 microsecondi la misura è soprattutto rumore
+    double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (const Misura& m : misure) {
+        if (m.ms < 0.01) continue;
+        double x = log10(static_cast<double>(m.righe)), y = log10(m.ms);
+        n += 1; sx += x; sy += y; sxx += x * x; sxy += x * y;
+    }
+    if (n < 2 || n * sxx - sx * sx <= 0) {
+        return NAN;
+    }
+    return (n * sxy - sx * sy) / (n * sxx - sx * sx);
+}
+
+
+/**
+ * @brief Disegna per ogni fase il tempo per riga con barre su scala logaritmica.
+ *
+ * Una fase lineare ha barre di lunghezza costante; una fase quadratica le allunga
+ * di un passo a ogni decade.
+ *
+ * @param perFase le misure di ogni fase
+ */
+void disegna(const map<string, vector<Misura>>& perFase) {
+    const int LARGHEZZA = 50;
+    double minimo = INFINITY, massimo = -INFINITY;
+    for (const auto& f : perFase) {
+        for (const Misura& m : f.second) {
+            double ns = m.ms * 1e6 / m.righe;
+            if (ns > 0) {
+                minimo = min(minimo, log10(ns));
+                massimo = max(massimo, log10(ns));
+            }
+        }
+    }
+    // la scala parte una decade sotto il minimo, così anche la barra più corta è visibile
+    minimo = floor(minimo) - 1;
+    massimo = max(ceil(massimo), minimo + 1);
+    printf("tempo per riga, scala logaritmica da %g a %g ns\n\n", pow(10, minimo), pow(10, massimo));
+    for (const char* fase : FASI) {
+        auto f = perFase.find(fase);
+        if (f == perFase.end()) continue;
+        printf("%s (esponente %.2f)\n", fase, esponente(f->second));
+        for (const Misura& m : f->second) {
+            double ns = m.ms * 1e6 / m.righe;
+            int lunghezza = ns > 0 ? static_cast<int>((log10(ns) - minimo) / (massimo - minimo) * LARGHEZZA + 0.5) : 0;
+            printf("%10zu | %-*s %10.1f ns/riga\n", m.righe, LARGHEZZA, string(lunghezza, '#').c_str(), ns);
+        }
+        printf("\n");
+    }
+}
+
+
+/**
+ * @brief Stampa l'uso del programma.
+ */
+void uso() {
+    cerr << "Uso: benchmark.exe [--min N] [--max N] [--repeat N] [--seed N] [--set-limit N] [--plot]" << endl
+         << "     benchmark.exe --generate RIGHE FILE [--seed N]" << endl
+         << "--min e --max sono le dimensioni minima e massima (default 1000 e 1000000, decadi intermedie);" << endl
+         << "il Set<string> viene misurato solo fino a --set-limit righe (default 100000)." << endl;
+}
+
+
+/**
+ * @brief Funzione principale
+ *
+ * Legge le opzioni, poi genera un catalogo in un file oppure esegue le misure
+ * e scrive i risultati sullo standard output. Ritorna 1 in caso di errore.
+ */
+int main(int argc, char* argv[]) {
+    size_t minimo = 1000, massimo = 1000000, limiteSet = 100000, righeGenerate = 0;
+    int ripetizioni = 3;
+    unsigned long long seme = 1;
+    string fileGenerato;
+    bool grafico = false;
+    for (int i = 1; i < argc; ++i) {
+        string opzione = argv[i];
+        bool valore = i + 1 < argc;
+        if (opzione == "--min" && valore) minimo = strtoull(argv[++i], nullptr, 10);
+        else if (opzione == "--max" && valore) massimo = strtoull(argv[++i], nullptr, 10);
+        else if (opzione == "--repeat" && valore) ripetizioni = atoi(argv[++i]);
+        else if (opzione == "--seed" && valore) seme = strtoull(argv[++i], nullptr, 10);
+        else if (opzione == "--set-limit" && valore) limiteSet = strtoull(argv[++i], nullptr, 10);
+        else if (opzione == "--generate" && i + 2 < argc) {
+            righeGenerate = strtoull(argv[++i], nullptr, 10);
+            fileGenerato = argv[++i];
+        }
+        else if (opzione == "--plot") grafico = true;
+        else if (opzione == "--help" || opzione == "-h") { uso(); return 0; }
+        else { uso(); return 1; }
+    }
+    if (minimo < 1 || massimo < minimo || ripetizioni < 1) {
+        uso();
+        return 1;
+    }
+
+    CatalogGenerator generatore(seme);
+    if (!fileGenerato.empty()) {
+        try {
+            generatore.write(fileGenerato, righeGenerate);
+        } catch (const exception& e) {
+            cerr << "Errore: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    map<string, vector<Misura>> perFase;
+    vector<Misura> misure;
+    for (size_t righe = minimo; righe <= massimo; righe *= 10) {
+        string dati = generatore.generate(righe);
+        bool conSet = righe <= limiteSet;
+        // per ogni fase si tiene il tempo migliore, il meno disturbato dal resto del sistema
+        map<string, double> migliori;
+        for (int r = 0; r < ripetizioni; ++r) {
+            for (const pair<const string, double>& t : esegui(dati, conSet)) {
+                auto m = migliori.find(t.first);
+                if (m == migliori.end() || t.second < m->second) {
+                    migliori[t.first] = t.second;
+                }
+            }
+        }
+        for (const char* fase : FASI) {
+            auto m = migliori.find(fase);
+            if (m != migliori.end()) {
+                misure.push_back(Misura{righe, fase, m->second});
+                perFase[fase].push_back(misure.back());
+            }
+        }
+        cerr << righe << " righe misurate" << endl;
+        if (righe > massimo / 10) break;
+    }
+
+    if (grafico) {
+        disegna(perFase);
+        return 0;
+    }
+    string out = "# tempi\nrighe,fase,ms,ns_per_riga\n";
+    char numero[64];
+    for (const Misura& m : misure) {
+        out += to_string(m.righe);
+        out += ',';
+        append_csv_field(out, m.fase);
+        snprintf(numero, sizeof(numero), ",%.3f,%.1f\n", m.ms, m.ms * 1e6 / m.righe);
+        out += numero;
+    }
+    out += "\n# esponenti\nfase,esponente\n";
+    for (const char* fase : FASI) {
+        auto f = perFase.find(fase);
+        if (f == perFase.end()) continue;
+        append_csv_field(out, fase);
+        snprintf(numero, sizeof(numero), ",%.2f\n", esponente(f->second));
+        out += numero;
+    }
+    cout.write(out.data(), static_cast<streamsize>(out.size()));
+    return 0;
+}
@@ -0,0 +1,464 @@
+/**
+  @file binaryset.h
+
+  @brief File header del formato binario della classe Set templata
+
+  File di dichiarazioni/definizioni delle funzioni che salvano e caricano un Set
+  in formato binario e della classe MappedSet, che interroga un file binario
+  mappato in memoria senza deserializzarlo.
+*/
+
+#ifndef BINARYSET_H
+#define BINARYSET_H
+
+#include "set.h"
+
+#include <climits>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+/**
+ * @brief Intestazione di un file binario di un Set.
+ *
+ * Il file è formato dall'intestazione, dal contenuto e dall'indice hash opzionale:
+ * - contenuto a larghezza fissa (T banalmente copiabile): count elementi di dimElemento byte;
+ * - contenuto di stringhe: count + 1 offset a 64 bit seguiti dai byte delle stringhe
+ *   (la stringa i occupa i byte [offset[i], offset[i+1]) a partire dall'inizio dei byte);
+ * - indice: slotIndice interi a 32 bit, ognuno 0 (vuoto) oppure la posizione dell'elemento + 1,
+ *   con sondaggio lineare a partire da hash(elemento) & (slotIndice - 1).
+ *
+ * Tutte le sezioni iniziano a un offset multiplo di 16, così il file mappato in memoria
+ * si può leggere direttamente. I numeri sono scritti nell'ordine dei byte della macchina:
+ * il campo endian permette di rifiutare un file scritto su una macchina diversa.
+ */
+struct binary_set_header {
+    char magic[4];         ///< "SETB"
+    uint32_t versione;     ///< versione del formato
+    uint32_t endian;       ///< 0x01020304 scritto nell'ordine dei byte della macchina
+    uint32_t tipo;         ///< 0 = elementi a larghezza fissa, 1 = stringhe
+    uint64_t dimElemento;  ///< sizeof(T) per gli elementi a larghezza fissa, 0 per le stringhe
+    uint64_t count;        ///< numero di elementi
+    uint64_t offsetDati;   ///< offset del contenuto dall'inizio del file
+    uint64_t dimDati;      ///< dimensione del contenuto in byte
+    uint64_t offsetIndice; ///< offset dell'indice hash (0 se assente)
+    uint64_t slotIndice;   ///< numero di posizioni dell'indice (potenza di 2, 0 se assente)
+};
+
+/**
+ * @brief Versione corrente del formato binario.
+ */
+const uint32_t BINARY_SET_VERSION = 1;
+
+
+   /**
+     * @brief Hash FNV-1a a 64 bit di una sequenza di byte.
+     *
+     * L'hash viene salvato nel file insieme all'indice, quindi non deve dipendere
+     * dall'implementazione di std::hash.
+     *
+     * @param dati puntatore ai byte
+     * @param n il numero di byte
+     *
+     * @return l'hash
+    */
+    inline uint64_t binary_set_hash(const void* dati, size_t n) {
+        const unsigned char* p = static_cast<const unsigned char*>(dati);
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < n; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+
+   /**
+     * @brief Funzione GLOBALE che salva un set in formato binario.
+     *
+     * Sono supportati i tipi banalmente copiabili (salvati byte per byte) e le stringhe.
+     * Il file viene scritto con la stessa procedura di save: file temporaneo e rename.
+     *
+     * @param s set da salvare
+     * @param filename il nome del file
+     * @param conIndice se true viene salvato anche l'indice hash usato da MappedSet::contains
+     * @param sincronizza se true il file viene forzato su disco (fsync) prima della rename
+     *
+     * @throw invoca runtime_error
+    */
+    template <typename T>
+    void save_binary(const Set<T>& s, const string& filename, bool conIndice = true, bool sincronizza = false) {
+        static_assert(is_trivially_copyable<T>::value || is_same<T, string>::value,
+                      "save_binary supporta solo tipi banalmente copiabili e stringhe");
+        const bool stringhe = is_same<T, string>::value;
+        const uint64_t n = static_cast<uint64_t>(s.size());
+        auto allinea = [](uint64_t x) { return (x + 15) & ~uint64_t(15); };
+
+        binary_set_header h;
+        memset(&h, 0, sizeof(h));
+        memcpy(h.magic, "SETB", 4);
+        h.versione = BINARY_SET_VERSION;
+        h.endian = 0x01020304;
+        h.tipo = stringhe ? 1 : 0;
+        h.dimElemento = stringhe ? 0 : sizeof(T);
+        h.count = n;
+        h.offsetDati = allinea(sizeof(h));
+
+        // si prepara il contenuto e l'hash di ogni elemento
+        string dati;
+        vector<uint64_t> hash;
+        hash.reserve(s.size());
+        if constexpr (is_same<T, string>::value) {
+            vector<uint64_t> offset;
+            offset.reserve(s.size() + 1);
+            uint64_t pos = 0;
+            for (Set<string>::const_iterator it = s.begin(); it != s.end(); ++it) {
+                offset.push_back(pos);
+                pos += it->size();
+                hash.push_back(binary_set_hash(it->data(), it->size()));
+            }
+            offset.push_back(pos);
+            dati.reserve(offset.size() * sizeof(uint64_t) + pos);
+            dati.append(reinterpret_cast<const char*>(offset.data()), offset.size() * sizeof(uint64_t));
+            for (Set<string>::const_iterator it = s.begin(); it != s.end(); ++it) {
+                dati += *it;
+            }
+        } else {
+            dati.resize(s.size() * sizeof(T));
+            for (int i = 0; i < s.size(); ++i) {
+                memcpy(&dati[i * sizeof(T)], &s[i], sizeof(T));
+                hash.push_back(binary_set_hash(&s[i], sizeof(T)));
+            }
+        }
+        h.dimDati = dati.size();
+
+        // indice hash con sondaggio lineare, riempito al massimo a metà
+        vector<uint32_t> indice;
+        if (conIndice && n < UINT32_MAX) {
+            uint64_t slot = 1;
+            while (slot < 2 * n) slot *= 2;
+            indice.assign(slot, 0);
+            for (uint64_t i = 0; i < n; ++i) {
+                uint64_t k = hash[i] & (slot - 1);
+                while (indice[k] != 0) k = (k + 1) & (slot - 1);
+                indice[k] = static_cast<uint32_t>(i + 1);
+            }
+            h.offsetIndice = allinea(h.offsetDati + h.dimDati);
+            h.slotIndice = slot;
+        }
+
+        const string temp = filename + ".tmp";
+        int fd = open_temp_file(temp);
+        const char zeri[16] = {0};
+        bool ok = write_all(fd, reinterpret_cast<const char*>(&h), sizeof(h));
+        ok = ok && write_all(fd, zeri, h.offsetDati - sizeof(h));
+        ok = ok && write_all(fd, dati.data(), dati.size());
+        if (h.slotIndice > 0) {
+            ok = ok && write_all(fd, zeri, h.offsetIndice - (h.offsetDati + h.dimDati));
+            ok = ok && write_all(fd, reinterpret_cast<const char*>(indice.data()), indice.size() * sizeof(uint32_t));
+        }
+        commit_temp_file(fd, temp, filename, ok, sincronizza);
+    }
+
+
+/**
+  @brief classe MappedSet
+
+  Vista in sola lettura su un file scritto da save_binary. Il file viene mappato
+  in memoria e interrogato direttamente: l'apertura controlla gli offset e l'indice
+  ma non copia gli elementi, e contains usa l'indice hash salvato nel file (se presente),
+  altrimenti scorre gli elementi.
+*/
+template <typename T>
+class MappedSet {
+    static_assert(is_trivially_copyable<T>::value || is_same<T, string>::value,
+                  "MappedSet supporta solo tipi banalmente copiabili e stringhe");
+
+    const char* base; ///< inizio del file mappato
+    size_t dimFile; ///< dimensione del file mappato
+    binary_set_header h; ///< intestazione del file
+    const uint64_t* offset; ///< offset delle stringhe (solo per le stringhe)
+    const char* testo; ///< byte delle stringhe (solo per le stringhe)
+    const uint32_t* indice; ///< indice hash (nullptr se assente)
+#ifdef _WIN32
+    HANDLE file; ///< handle del file
+    HANDLE mappa; ///< handle della mappatura
+#endif
+
+    // Libera la mappatura e il file
+    void chiudi() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mappa) CloseHandle(mappa);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (base) munmap(const_cast<char*>(base), dimFile);
+#endif
+    }
+
+    // Controlla che l'intestazione, gli offset delle stringhe e l'indice descrivano un file
+    // coerente: dopo il controllo nessuna lettura esce dal file mappato. I confronti sono
+    // scritti per non superare mai il massimo di uint64_t con valori danneggiati
+    bool valido() const {
+        if (memcmp(h.magic, "SETB", 4) != 0 || h.versione != BINARY_SET_VERSION || h.endian != 0x01020304
+            || h.tipo != (is_same<T, string>::value ? 1u : 0u)
+            || h.dimElemento != (is_same<T, string>::value ? 0 : sizeof(T))) {
+            return false;
+        }
+        // le sezioni iniziano a un multiplo di 16 dopo l'intestazione e finiscono entro il file
+        if (h.offsetDati < sizeof(h) || h.offsetDati % 16 != 0 || h.offsetDati > dimFile
+            || h.dimDati > dimFile - h.offsetDati) {
+            return false;
+        }
+        if (h.slotIndice > 0 && ((h.slotIndice & (h.slotIndice - 1)) != 0 || h.offsetIndice % 16 != 0
+            || h.offsetIndice < sizeof(h) || h.offsetIndice > dimFile
+            || h.slotIndice > (dimFile - h.offsetIndice) / sizeof(uint32_t))) {
+            return false;
+        }
+
+        if constexpr (is_same<T, string>::value) {
+            // count + 1 offset non decrescenti, l'ultimo entro i byte delle stringhe
+            if (h.count >= h.dimDati / sizeof(uint64_t)) {
+                return false;
+            }
+            const uint64_t* o = reinterpret_cast<const uint64_t*>(base + h.offsetDati);
+            for (uint64_t i = 0; i < h.count; ++i) {
+                if (o[i] > o[i + 1]) return false;
+            }
+            if (o[h.count] > h.dimDati - (h.count + 1) * sizeof(uint64_t)) {
+                return false;
+            }
+        } else if (h.count > h.dimDati / sizeof(T)) {
+            return false;
+        }
+
+        // ogni posizione dell'indice è vuota o si riferisce a un elemento, e almeno una è vuota
+        // (altrimenti il sondaggio di contains di un elemento assente non finirebbe)
+        if (h.slotIndice > 0) {
+            const uint32_t* k = reinterpret_cast<const uint32_t*>(base + h.offsetIndice);
+            bool vuota = false;
+            for (uint64_t i = 0; i < h.slotIndice; ++i) {
+                if (k[i] > h.count) return false;
+                vuota = vuota || k[i] == 0;
+            }
+            if (!vuota) return false;
+        }
+        return true;
+    }
+
+    // Controlla che l'elemento in posizione i sia uguale a value
+    bool uguale(uint64_t i, const T& value) const {
+        if constexpr (is_same<T, string>::value) {
+            return offset[i + 1] - offset[i] == value.size()
+                && memcmp(testo + offset[i], value.data(), value.size()) == 0;
+        } else {
+            return memcmp(base + h.offsetDati + i * sizeof(T), &value, sizeof(T)) == 0;
+        }
+    }
+
+public:
+    /**
+     * @brief Tipo restituito dall'operatore di accesso: string_view per le stringhe, T per gli altri tipi.
+     */
+    typedef typename conditional<is_same<T, string>::value, string_view, T>::type value_view;
+
+    /**
+     * @brief Costruttore che mappa in memoria un file scritto da save_binary.
+     *
+     * @param filename il nome del file
+     *
+     * @throw invoca runtime_error se il file non si può aprire o non è nel formato atteso
+     */
+    explicit MappedSet(const string& filename)
+        : base(nullptr), dimFile(0), offset(nullptr), testo(nullptr), indice(nullptr) {
+#ifdef _WIN32
+        mappa = nullptr;
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER dim;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &dim)) {
+            chiudi();
+            throw runtime_error("Impossibile aprire il file");
+        }
+        dimFile = static_cast<size_t>(dim.QuadPart);
+        if (dimFile >= sizeof(h)) {
+            mappa = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            base = mappa ? static_cast<const char*>(MapViewOfFile(mappa, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        }
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            if (fd >= 0) ::close(fd);
+            throw runtime_error("Impossibile aprire il file");
+        }
+        dimFile = static_cast<size_t>(st.st_size);
+        if (dimFile >= sizeof(h)) {
+            void* p = mmap(nullptr, dimFile, PROT_READ, MAP_SHARED, fd, 0);
+            base = p == MAP_FAILED ? nullptr : static_cast<const char*>(p);
+        }
+        // la mappatura resta valida anche dopo la chiusura del descrittore
+        ::close(fd);
+#endif
+        if (base == nullptr) {
+            chiudi();
+            throw runtime_error("File binario non valido");
+        }
+
+        memcpy(&h, base, sizeof(h));
+        if (!valido()) {
+            chiudi();
+            throw runtime_error("File binario non valido");
+        }
+        if constexpr (is_same<T, string>::value) {
+            offset = reinterpret_cast<const uint64_t*>(base + h.offsetDati);
+            testo = base + h.offsetDati + (h.count + 1) * sizeof(uint64_t);
+        }
+        if (h.slotIndice > 0) {
+            indice = reinterpret_cast<const uint32_t*>(base + h.offsetIndice);
+        }
+    }
+
+    MappedSet(const MappedSet&) = delete;
+    MappedSet& operator=(const MappedSet&) = delete;
+
+    /**
+     * @brief Distruttore, libera la mappatura.
+     */
+    ~MappedSet() {
+        chiudi();
+    }
+
+    /**
+     * @brief Ritorna il numero di elementi presenti nel file.
+     *
+     * @return il numero di elementi
+    */
+    size_t size() const {
+        return static_cast<size_t>(h.count);
+    }
+
+    /**
+     * @brief Ritorna true se il file contiene l'indice hash.
+     *
+     * @return true o false
+    */
+    bool has_index() const {
+        return indice != nullptr;
+    }
+
+    /**
+     * @brief Controlla se un dato elemento è presente nel file.
+     *
+     * Con l'indice il costo è quello di una ricerca in una tabella hash,
+     * senza l'indice gli elementi vengono confrontati uno ad uno.
+     *
+     * @param value il valore da controllare
+     *
+     * @return true o false
+    */
+    bool contains(const T& value) const {
+        if (indice == nullptr) {
+            for (uint64_t i = 0; i < h.count; ++i) {
+                if (uguale(i, value)) return true;
+            }
+            return false;
+        }
+        uint64_t hash;
+        if constexpr (is_same<T, string>::value) {
+            hash = binary_set_hash(value.data(), value.size());
+        } else {
+            hash = binary_set_hash(&value, sizeof(T));
+        }
+        for (uint64_t k = hash & (h.slotIndice - 1); indice[k] != 0; k = (k + 1) & (h.slotIndice - 1)) {
+            if (uguale(indice[k] - 1, value)) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Operatore di accesso in sola lettura.
+     *
+     * @param index l'indice dell'elemento
+     *
+     * @return l'elemento (string_view sul file mappato per le stringhe)
+     *
+     * @throw invoca std::out_of_range
+    */
+    value_view operator[](size_t index) const {
+        if (index >= h.count) {
+            throw out_of_range("Indice è fuori dai limiti");
+        }
+        if constexpr (is_same<T, string>::value) {
+            return string_view(testo + offset[index], offset[index + 1] - offset[index]);
+        } else {
+            T value;
+            memcpy(&value, base + h.offsetDati + index * sizeof(T), sizeof(T));
+            return value;
+        }
+    }
+};
+
+
+   /**
+     * @brief Funzione GLOBALE che carica un set da un file scritto da save_binary.
+     *
+     * Il file può essere danneggiato o scritto a mano, quindi l'unicità degli elementi
+     * viene controllata con una tabella hash temporanea (un costo lineare, invece di
+     * quello quadratico di add); gli elementi vengono poi aggiunti senza altri controlli
+     * in un set con la capacità già riservata.
+     *
+     * @param s il set da caricare
+     * @param filename il nome del file
+     *
+     * @throw invoca runtime_error se il file non è valido, ha più di INT_MAX elementi
+     * o contiene un elemento ripetuto; in questi casi s resta invariato
+    */
+    template <typename T>
+    void load_binary(Set<T>& s, const string& filename) {
+        MappedSet<T> mappato(filename);
+        if (mappato.size() > static_cast<size_t>(INT_MAX)) {
+            throw runtime_error("File binario non valido");
+        }
+
+        // tabella con sondaggio lineare delle posizioni già lette (+1, 0 = vuota), riempita al massimo a metà
+        size_t slot = 1;
+        while (slot < 2 * mappato.size()) {
+            slot *= 2;
+        }
+        vector<uint32_t> viste(slot, 0);
+        for (size_t i = 0; i < mappato.size(); ++i) {
+            typename MappedSet<T>::value_view value = mappato[i];
+            uint64_t hash;
+            if constexpr (is_same<T, string>::value) {
+                hash = binary_set_hash(value.data(), value.size());
+            } else {
+                // elementi uguali per operator== devono avere lo stesso hash (0.0 e -0.0)
+                if constexpr (is_floating_point<T>::value) {
+                    if (value == 0) value = T(0);
+                }
+                hash = binary_set_hash(&value, sizeof(T));
+            }
+            size_t k = hash & (slot - 1);
+            for (; viste[k] != 0; k = (k + 1) & (slot - 1)) {
+                if (mappato[viste[k] - 1] == value) {
+                    throw runtime_error("File binario non valido");
+                }
+            }
+            viste[k] = static_cast<uint32_t>(i + 1);
+        }
+
+        Set<T> result;
+        result.reserve(static_cast<int>(mappato.size()));
+        for (size_t i = 0; i < mappato.size(); ++i) {
+            result.add_unchecked(T(mappato[i]));
+        }
+        s.swap(result);
+    }
+
+#endif
@@ -0,0 +1,434 @@
+/**
+ * @file catalogo.cpp
+ * @brief Strumento da riga di comando per interrogare il catalogo dei dipinti senza interfaccia grafica
+ *
+ * Carica il catalogo (file CSV o snapshot) con la classe Catalog, la stessa usata dalla
+ * finestra principale, esegue uno script di comandi e scrive i risultati in CSV o JSON,
+ * insieme alla durata di ogni operazione.
+ *
+ * Uso:
+ * @code
+ * catalogo.exe [--csv FILE | --snapshot FILE] [--format csv|json] [--repeat N] [--timings] [--trace FILE] [SCRIPT]
+ * @endcode
+ *
+ * Lo script (un file, oppure "-" per lo standard input) contiene un comando per riga;
+ * le righe vuote e quelle che iniziano con # vengono ignorate. Comandi:
+ * - count: numero di dipinti;
+ * - schools: numero e percentuale di dipinti per scuola;
+ * - counts COLONNA: numero di dipinti per ogni valore di una colonna;
+ * - dates [AMPIEZZA]: numero di dipinti per periodo di anni (default 10);
+ * - search TESTO: ricerca in tutte le colonne, oppure interrogazione ("Scuola = fiorentina AND Data in 1500-1550");
+ * - find COLONNA TESTO: ricerca in una colonna;
+ * - add SCUOLA,AUTORE,TITOLO,DATA,SALA: aggiunge un dipinto;
+ * - delete POSIZIONE: elimina il dipinto in una posizione;
+ * - undo, redo: annulla l'ultima modifica oppure la ripristina;
+ * - reset: riporta il catalogo ai dipinti iniziali (si può annullare con undo);
+ * - diff [DA A]: dipinti aggiunti e rimossi tra due versioni (default: dalla versione 0 a quella corrente).
+ * Senza script vengono eseguiti "count", "schools" e "dates 10".
+ */
+
+#include "set.h"
+#include "catalog.h"
+#include "catalogquery.h"
+#include "catalogsnapshot.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+/**
+ * @brief Risultato di un comando: una tabella con intestazione.
+ */
+struct Tabella {
+    string comando;               ///< il comando che ha prodotto la tabella
+    vector<string> colonne;       ///< nomi delle colonne
+    vector<bool> numeriche;       ///< true per le colonne numeriche (scritte senza virgolette in JSON)
+    vector<vector<string>> righe; ///< valori delle righe
+};
+
+
+/**
+ * @brief Scrive un numero reale con due decimali.
+ *
+ * @param x il numero
+ *
+ * @return il testo del numero
+ */
+string decimale(double x) {
+    char testo[32];
+    snprintf(testo, sizeof(testo), "%.2f", x);
+    return testo;
+}
+
+
+/**
+ * @brief Ritorna il testo senza spazi iniziali e finali.
+ *
+ * @param s il testo
+ *
+ * @return il testo senza spazi
+ */
+string senzaSpazi(const string& s) {
+    size_t inizio = s.find_first_not_of(" \t\r\n");
+    if (inizio == string::npos) {
+        return string();
+    }
+    return s.substr(inizio, s.find_last_not_of(" \t\r\n") - inizio + 1);
+}
+
+
+/**
+ * @brief Crea la tabella delle righe trovate da una ricerca.
+ *
+ * @param catalogo il catalogo
+ * @param comando il comando eseguito
+ * @param ids gli id stabili delle righe trovate, in ordine di rilevanza
+ *
+ * @return la tabella con posizione e valori di ogni riga
+ */
+Tabella righeTrovate(const Catalog& catalogo, const string& comando, const vector<int>& ids) {
+    Tabella t{comando, {"posizione", "Scuola", "Autore", "Soggetto/Titolo", "Data", "Sala"},
+              {true, false, false, false, false, false}, {}};
+    for (int id : ids) {
+        int posizione = catalogo.position(id);
+        vector<string> riga{to_string(posizione)};
+        for (const string& valore : catalogo.dictionary().values(catalogo.row(posizione))) {
+            riga.push_back(valore);
+        }
+        t.righe.push_back(riga);
+    }
+    return t;
+}
+
+
+/**
+ * @brief Esegue un comando dello script.
+ *
+ * @param catalogo il catalogo
+ * @param traccia il tracer in cui misurare il comando
+ * @param comando la riga dello script
+ *
+ * @return la tabella dei risultati
+ *
+ * @throw invalid_argument se il comando non è valido
+ */
+Tabella esegui(Catalog& catalogo, Tracer& traccia, const string& comando) {
+    istringstream in(comando);
+    string nome;
+    in >> nome;
+    string argomento;
+    getline(in, argomento);
+    argomento = senzaSpazi(argomento);
+
+    if (nome == "count") {
+        Tracer::Scope misura(traccia, "count", "comandi");
+        return Tabella{comando, {"dipinti"}, {true}, {{to_string(catalogo.size())}}};
+    }
+    if (nome == "schools") {
+        Tracer::Scope misura(traccia, "schools", "comandi");
+        Tabella t{comando, {"Scuola", "dipinti", "percentuale"}, {false, true, true}, {}};
+        vector<pair<string, int>> conteggi = catalogo.counts(0);
+        vector<pair<string, double>> percentuali = catalogo.percentages(0);
+        for (size_t i = 0; i < conteggi.size(); ++i) {
+            t.righe.push_back({conteggi[i].first, to_string(conteggi[i].second), decimale(percentuali[i].second)});
+        }
+        return t;
+    }
+    if (nome == "counts") {
+        Tracer::Scope misura(traccia, "counts", "comandi");
+        int colonna = CatalogQuery::columnFromName(argomento);
+        if (colonna < 0) {
+            throw invalid_argument("Colonna sconosciuta: " + argomento);
+        }
+        Tabella t{comando, {argomento, "dipinti"}, {false, true}, {}};
+        for (const pair<string, int>& c : catalogo.counts(colonna)) {
+            t.righe.push_back({c.first, to_string(c.second)});
+        }
+        return t;
+    }
+    if (nome == "dates") {
+        Tracer::Scope misura(traccia, "dates", "comandi");
+        int ampiezza = argomento.empty() ? 10 : atoi(argomento.c_str());
+        if (ampiezza <= 0) {
+            throw invalid_argument("Ampiezza del periodo non valida: " + argomento);
+        }
+        Tabella t{comando, {"da", "a", "dipinti"}, {true, true, true}, {}};
+        for (const pair<int, int>& p : catalogo.histogram(ampiezza)) {
+            t.righe.push_back({to_string(p.first), to_string(p.first + ampiezza - 1), to_string(p.second)});
+        }
+        // i dipinti senza data hanno una riga a parte, senza anni
+        if (catalogo.undatedCount() > 0) {
+            t.righe.push_back({"", "", to_string(catalogo.undatedCount())});
+        }
+        return t;
+    }
+    if (nome == "search") {
+        Tracer::Scope misura(traccia, "search", "comandi");
+        return righeTrovate(catalogo, comando, catalogo.search(argomento));
+    }
+    if (nome == "find") {
+        Tracer::Scope misura(traccia, "find", "comandi");
+        size_t spazio = argomento.find(' ');
+        int colonna = CatalogQuery::columnFromName(argomento.substr(0, spazio));
+        if (colonna < 0 || spazio == string::npos) {
+            throw invalid_argument("Uso: find COLONNA TESTO");
+        }
+        return righeTrovate(catalogo, comando, catalogo.search(senzaSpazi(argomento.substr(spazio)), colonna));
+    }
+    if (nome == "add") {
+        Tracer::Scope misura(traccia, "add", "comandi");
+        vector<string> valori = Catalog::parseCsvLine(argomento.data(), argomento.size());
+        if (valori.size() != COLONNE_CATALOGO) {
+            throw invalid_argument("Uso: add SCUOLA,AUTORE,TITOLO,DATA,SALA");
+        }
+        return Tabella{comando, {"posizione"}, {true}, {{to_string(catalogo.add(valori))}}};
+    }
+    if (nome == "delete") {
+        Tracer::Scope misura(traccia, "delete", "comandi");
+        int posizione = atoi(argomento.c_str());
+        if (argomento.empty() || posizione < 0 || posizione >= catalogo.size()) {
+            throw invalid_argument("Posizione non valida: " + argomento);
+        }
+        catalogo.remove(posizione);
+        return Tabella{comando, {"dipinti"}, {true}, {{to_string(catalogo.size())}}};
+    }
+    if (nome == "undo" || nome == "redo" || nome == "reset") {
+        Tracer::Scope misura(traccia, nome.c_str(), "comandi");
+        if (nome == "undo" && !catalogo.undo()) {
+            throw invalid_argument("Nessuna modifica da annullare");
+        }
+        if (nome == "redo" && !catalogo.redo()) {
+            throw invalid_argument("Nessuna modifica da ripristinare");
+        }
+        if (nome == "reset") {
+            catalogo.reset();
+        }
+        return Tabella{comando, {"versione", "dipinti"}, {true, true},
+                       {{to_string(catalogo.version()), to_string(catalogo.size())}}};
+    }
+    if (nome == "diff") {
+        Tracer::Scope misura(traccia, "diff", "comandi");
+        size_t da = 0, a = catalogo.version();
+        if (!argomento.empty()) {
+            istringstream versioni(argomento);
+            long long primo = -1, secondo = -1;
+            versioni >> primo >> secondo;
+            if (primo < 0 || secondo < 0 || static_cast<size_t>(primo) >= catalogo.versionCount()
+                || static_cast<size_t>(secondo) >= catalogo.versionCount()) {
+                throw invalid_argument("Uso: diff DA A, con versioni da 0 a " + to_string(catalogo.versionCount() - 1));
+            }
+            da = static_cast<size_t>(primo);
+            a = static_cast<size_t>(secondo);
+        }
+        // ogni riga è nella posizione che ha nella versione in cui è presente
+        Tabella t{comando, {"modifica", "posizione", "Scuola", "Autore", "Soggetto/Titolo", "Data", "Sala"},
+                  {false, true, false, false, false, false, false}, {}};
+        Catalog::Differenza modifica = catalogo.diff(da, a);
+        for (int rimossa = 0; rimossa < 2; ++rimossa) {
+            const PersistentRows& righe = catalogo.versionRows(rimossa ? da : a);
+            for (int id : rimossa ? modifica.rimosse : modifica.aggiunte) {
+                vector<string> riga{rimossa ? "rimossa" : "aggiunta", to_string(righe.position(id))};
+                for (const string& valore : catalogo.dictionary().values(righe.find(id)->riga)) {
+                    riga.push_back(valore);
+                }
+                t.righe.push_back(riga);
+            }
+        }
+        return t;
+    }
+    throw invalid_argument("Comando sconosciuto: " + nome);
+}
+
+
+/**
+ * @brief Aggiunge una tabella al testo dei risultati in formato CSV.
+ *
+ * Ogni tabella inizia con una riga di commento con il comando ed è seguita da una riga vuota.
+ *
+ * @param out il testo dei risultati
+ * @param t la tabella
+ */
+void scriviCsv(string& out, const Tabella& t) {
+    out += "# ";
+    out += t.comando;
+    out += '\n';
+    vector<const vector<string>*> righe{&t.colonne};
+    for (const vector<string>& riga : t.righe) {
+        righe.push_back(&riga);
+    }
+    for (const vector<string>* riga : righe) {
+        for (size_t j = 0; j < riga->size(); ++j) {
+            if (j > 0) out += ',';
+            append_csv_field(out, (*riga)[j]);
+        }
+        out += '\n';
+    }
+    out += '\n';
+}
+
+
+/**
+ * @brief Aggiunge una tabella al testo dei risultati in formato JSON.
+ *
+ * @param out il testo dei risultati
+ * @param t la tabella
+ */
+void scriviJson(string& out, const Tabella& t) {
+    out += "{\"command\":";
+    append_json_string(out, t.comando);
+    out += ",\"columns\":[";
+    for (size_t j = 0; j < t.colonne.size(); ++j) {
+        if (j > 0) out += ',';
+        append_json_string(out, t.colonne[j]);
+    }
+    out += "],\"rows\":[";
+    for (size_t i = 0; i < t.righe.size(); ++i) {
+        out += (i > 0) ? ",[" : "[";
+        for (size_t j = 0; j < t.righe[i].size(); ++j) {
+            if (j > 0) out += ',';
+            if (t.numeriche[j] && !t.righe[i][j].empty()) {
+                out += t.righe[i][j];
+            } else if (t.numeriche[j]) {
+                out += "null";
+            } else {
+                append_json_string(out, t.righe[i][j]);
+            }
+        }
+        out += ']';
+    }
+    out += "]}";
+}
+
+
+/**
+ * @brief Crea la tabella della durata delle operazioni.
+ *
+ * @param traccia il tracer con le misure
+ *
+ * @return la tabella con numero di esecuzioni, tempo totale, medio e massimo di ogni operazione
+ */
+Tabella tempi(const Tracer& traccia) {
+    Tabella t{"timings", {"operazione", "volte", "totale_ms", "medio_ms", "massimo_ms"},
+              {false, true, true, true, true}, {}};
+    for (const Tracer::Riepilogo& r : traccia.summary()) {
+        char medio[32], totale[32], massimo[32];
+        snprintf(totale, sizeof(totale), "%.3f", r.totaleMs);
+        snprintf(medio, sizeof(medio), "%.3f", r.totaleMs / r.volte);
+        snprintf(massimo, sizeof(massimo), "%.3f", r.massimoMs);
+        t.righe.push_back({r.nome, to_string(r.volte), totale, medio, massimo});
+    }
+    return t;
+}
+
+
+/**
+ * @brief Stampa l'uso del programma.
+ */
+void uso() {
+    cerr << "Uso: catalogo.exe [--csv FILE | --snapshot FILE] [--format csv|json] [--repeat N]"
+            " [--timings] [--trace FILE] [SCRIPT]" << endl
+         << "SCRIPT contiene un comando per riga (\"-\" = standard input): count, schools, counts COLONNA," << endl
+         << "dates [AMPIEZZA], search TESTO, find COLONNA TESTO, add SCUOLA,AUTORE,TITOLO,DATA,SALA, delete POSIZIONE," << endl
+         << "undo, redo, reset, diff [DA A]" << endl;
+}
+
+
+/**
+ * @brief Funzione principale
+ *
+ * Legge le opzioni, carica il catalogo, esegue lo script e scrive i risultati
+ * sullo standard output. Ritorna 1 in caso di errore.
+ */
+int main(int argc, char* argv[]) {
+    string csv = "dipinti_uffizi.csv", snapshot, formato = "csv", script, fileTraccia;
+    int ripetizioni = 1;
+    bool conTempi = false;
+    for (int i = 1; i < argc; ++i) {
+        string opzione = argv[i];
+        bool valore = i + 1 < argc;
+        if (opzione == "--csv" && valore) csv = argv[++i];
+        else if (opzione == "--snapshot" && valore) snapshot = argv[++i];
+        else if (opzione == "--format" && valore) formato = argv[++i];
+        else if (opzione == "--repeat" && valore) ripetizioni = atoi(argv[++i]);
+        else if (opzione == "--trace" && valore) fileTraccia = argv[++i];
+        else if (opzione == "--timings") conTempi = true;
+        else if (opzione == "--help" || opzione == "-h") { uso(); return 0; }
+        else if (script.empty() && (opzione == "-" || opzione[0] != '-')) script = opzione;
+        else { uso(); return 1; }
+    }
+    if ((formato != "csv" && formato != "json") || ripetizioni < 1) {
+        uso();
+        return 1;
+    }
+
+    // comandi dello script
+    vector<string> comandi;
+    if (script.empty()) {
+        comandi = {"count", "schools", "dates 10"};
+    } else {
+        ifstream file;
+        if (script != "-") {
+            file.open(script);
+            if (!file) {
+                cerr << "Impossibile aprire lo script " << script << endl;
+                return 1;
+            }
+        }
+        istream& in = (script == "-") ? cin : file;
+        string riga;
+        while (getline(in, riga)) {
+            riga = senzaSpazi(riga);
+            if (!riga.empty() && riga[0] != '#') {
+                comandi.push_back(riga);
+            }
+        }
+    }
+
+    Tracer traccia(fileTraccia);
+    Catalog catalogo(&traccia);
+    vector<Tabella> risultati;
+    try {
+        if (!snapshot.empty()) {
+            vector<RigaCatalogo> righe;
+            {
+                Tracer::Scope misura(traccia, "lettura snapshot", "avvio");
+                CatalogSnapshot(snapshot).readAll(catalogo.dictionary(), righe);
+            }
+            catalogo.loadRows(righe);
+        } else {
+            catalogo.loadCsv(csv);
+        }
+        // con più ripetizioni si conservano solo i risultati dell'ultima
+        for (int r = 0; r < ripetizioni; ++r) {
+            risultati.clear();
+            for (const string& comando : comandi) {
+                risultati.push_back(esegui(catalogo, traccia, comando));
+            }
+        }
+    } catch (const exception& e) {
+        cerr << "Errore: " << e.what() << endl;
+        return 1;
+    }
+    if (conTempi) {
+        risultati.push_back(tempi(traccia));
+    }
+
+    string out;
+    if (formato == "csv") {
+        for (const Tabella& t : risultati) {
+            scriviCsv(out, t);
+        }
+    } else {
+        out += "[\n";
+        for (size_t i = 0; i < risultati.size(); ++i) {
+            if (i > 0) out += ",\n";
+            scriviJson(out, risultati[i]);
+        }
+        out += "\n]\n";
+    }
+    cout.write(out.data(), static_cast<streamsize>(out.size()));
+    return 0;
+}
@@ -0,0 +1,516 @@
+/**
+  @file flatstringset.h
+
+  @brief File header della classe FlatStringSet
+
+  File di dichiarazioni/definizioni della classe FlatStringSet, un set di stringhe
+  che conserva tutti i caratteri in un unico buffer contiguo, e delle funzioni
+  save e load per questa classe.
+*/
+
+#ifndef FLATSTRINGSET_H
+#define FLATSTRINGSET_H
+
+#include "set.h"
+
+#include <functional>
+#include <string_view>
+#include <vector>
+
+
+/**
+  @brief classe FlatStringSet
+
+  Set di stringhe alternativo a Set<string>. In un Set<string> ogni elemento è un
+  oggetto string con il proprio buffer sullo heap (quando supera la small string
+  optimization), quindi i caratteri sono sparsi in memoria. FlatStringSet invece
+  accoda i caratteri di tutti gli elementi a un unico buffer e tiene per ogni
+  elemento solo posizione, lunghezza e hash; una tabella hash con sondaggio lineare
+  trova un elemento senza scandire il set.
+
+  Gli elementi restano nell'ordine di inserimento, come in Set. Le ricerche accettano
+  string_view (anche letterali e sottostringhe, senza creare string temporanee) e
+  l'accesso restituisce string_view nel buffer, valide fino alla modifica successiva.
+  I caratteri degli elementi rimossi restano nel buffer finché non superano la metà
+  del buffer; a quel punto il buffer viene compattato.
+*/
+class FlatStringSet {
+    /**
+     * @brief Posizione di un elemento nel buffer dei caratteri.
+     */
+    struct Voce {
+        size_t inizio;      ///< posizione del primo carattere nel buffer
+        uint32_t lunghezza; ///< numero di caratteri
+        uint32_t impronta;  ///< hash dell'elemento, conservato per ricostruire l'indice e scartare i confronti
+    };
+
+    string caratteri;   ///< i caratteri di tutti gli elementi, uno dopo l'altro
+    vector<Voce> voci;  ///< gli elementi in ordine di inserimento
+    vector<int> indice; ///< tabella hash: -1 (vuota) oppure la posizione dell'elemento in voci
+    size_t sprecati;    ///< byte del buffer occupati da elementi rimossi
+
+
+    /**
+     * @brief Calcola l'hash di una stringa.
+     */
+    static uint32_t impronta(string_view s) {
+        uint64_t h = hash<string_view>()(s);
+        return static_cast<uint32_t>(h ^ (h >> 32));
+    }
+
+    /**
+     * @brief Ritorna la stringa di un elemento.
+     */
+    string_view testo(const Voce& v) const {
+        return string_view(caratteri.data() + v.inizio, v.lunghezza);
+    }
+
+    /**
+     * @brief Cerca un elemento nella tabella hash.
+     *
+     * @return la posizione nella tabella dell'elemento, oppure quella vuota in cui andrebbe inserito
+     */
+    size_t cella(string_view s, uint32_t h) const {
+        size_t maschera = indice.size() - 1;
+        size_t i = h & maschera;
+        while (indice[i] >= 0) {
+            const Voce& v = voci[indice[i]];
+            if (v.impronta == h && testo(v) == s) {
+                return i;
+            }
+            i = (i + 1) & maschera;
+        }
+        return i;
+    }
+
+    /**
+     * @brief Ricostruisce la tabella hash con almeno il doppio delle celle degli elementi.
+     *
+     * @param n il numero di elementi che la tabella deve poter contenere
+     */
+    void ricostruisci_indice(size_t n) {
+        size_t celle = 16;
+        while (celle < 2 * n) {
+            celle *= 2;
+        }
+        indice.assign(celle, -1);
+        for (size_t k = 0; k < voci.size(); ++k) {
+            size_t i = voci[k].impronta & (celle - 1);
+            while (indice[i] >= 0) {
+                i = (i + 1) & (celle - 1);
+            }
+            indice[i] = static_cast<int>(k);
+        }
+    }
+
+    /**
+     * @brief Svuota una cella della tabella hash.
+     *
+     * Gli elementi successivi della stessa sequenza di sondaggio vengono spostati
+     * indietro (cancellazione con spostamento), così la tabella non ha bisogno di
+     * celle segnate come cancellate.
+     */
+    void svuota_cella(size_t i) {
+        size_t maschera = indice.size() - 1;
+        size_t j = i;
+        while (true) {
+            j = (j + 1) & maschera;
+            if (indice[j] < 0) {
+                break;
+            }
+            size_t k = voci[indice[j]].impronta & maschera;
+            // l'elemento in j può andare in i solo se la sua cella naturale k non è tra i (escluso) e j
+            bool traIeJ = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+            if (!traIeJ) {
+                indice[i] = indice[j];
+                i = j;
+            }
+        }
+        indice[i] = -1;
+    }
+
+    /**
+     * @brief Copia i caratteri degli elementi presenti in un nuovo buffer senza spazi vuoti.
+     */
+    void compatta() {
+        string nuovi;
+        nuovi.reserve(caratteri.size() - sprecati);
+        for (Voce& v : voci) {
+            size_t inizio = nuovi.size();
+            nuovi.append(caratteri, v.inizio, v.lunghezza);
+            v.inizio = inizio;
+        }
+        caratteri.swap(nuovi);
+        sprecati = 0;
+    }
+
+    /**
+     * @brief Accoda un elemento che non è presente, nella cella vuota indicata.
+     */
+    void inserisci(string_view s, uint32_t h, size_t i) {
+        if (s.size() > UINT32_MAX) {
+            throw length_error("Elemento troppo lungo per FlatStringSet");
+        }
+        indice[i] = static_cast<int>(voci.size());
+        voci.push_back(Voce{caratteri.size(), static_cast<uint32_t>(s.size()), h});
+        caratteri.append(s.data(), s.size());
+        // la tabella resta piena al massimo per metà, così le sequenze di sondaggio sono brevi
+        if (2 * voci.size() > indice.size()) {
+            ricostruisci_indice(voci.size());
+        }
+    }
+
+public:
+    /**
+     * @brief Costruttore di default, crea un set vuoto.
+     */
+    FlatStringSet() : sprecati(0) {
+        ricostruisci_indice(0);
+    }
+
+
+    /**
+     * @brief Costruttore che copia gli elementi di un Set<string>.
+     *
+     * @param s il set da copiare
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    explicit FlatStringSet(const Set<string>& s) : sprecati(0) {
+        ricostruisci_indice(0);
+        size_t totale = 0;
+        for (Set<string>::const_iterator it = s.begin(); it != s.end(); ++it) {
+            totale += it->size();
+        }
+        reserve(s.size(), totale);
+        for (Set<string>::const_iterator it = s.begin(); it != s.end(); ++it) {
+            uint32_t h = impronta(*it);
+            inserisci(*it, h, cella(*it, h));
+        }
+    }
+
+
+    /**
+     * @brief Costruttore da una sequenza di stringhe definita da due iteratori.
+     *
+     * Gli elementi ripetuti vengono inseriti una sola volta.
+     *
+     * @param begin iteratore di inizio sequenza
+     * @param end iteratore di fine sequenza
+     */
+    template <typename Iterator>
+    FlatStringSet(Iterator begin, Iterator end) : sprecati(0) {
+        ricostruisci_indice(0);
+        for (Iterator it = begin; it != end; ++it) {
+            string_view s(*it);
+            uint32_t h = impronta(s);
+            size_t i = cella(s, h);
+            if (indice[i] < 0) {
+                inserisci(s, h, i);
+            }
+        }
+    }
+
+
+    /**
+     * @brief Riserva spazio per n elementi con un totale di byte caratteri.
+     *
+     * @param n il numero di elementi
+     * @param byte il numero totale di caratteri degli elementi
+     */
+    void reserve(int n, size_t byte = 0) {
+        if (n < 0) {
+            return;
+        }
+        voci.reserve(static_cast<size_t>(n));
+        caratteri.reserve(byte);
+        if (2 * static_cast<size_t>(n) > indice.size()) {
+            ricostruisci_indice(static_cast<size_t>(n));
+        }
+    }
+
+
+    /**
+     * @brief Svuota il set.
+     */
+    void clear() {
+        caratteri.clear();
+        voci.clear();
+        sprecati = 0;
+        ricostruisci_indice(0);
+    }
+
+
+    /**
+     * @brief Scambia il contenuto di questo set con un altro set.
+     *
+     * @param other il set con cui scambiare i dati
+     */
+    void swap(FlatStringSet& other) {
+        caratteri.swap(other.caratteri);
+        voci.swap(other.voci);
+        indice.swap(other.indice);
+        std::swap(sprecati, other.sprecati);
+    }
+
+
+    /**
+     * @brief Ritorna il numero di elementi presenti nel set.
+     *
+     * @return il numero di elementi
+     */
+    int size() const {
+        return static_cast<int>(voci.size());
+    }
+
+
+    /**
+     * @brief Controlla se un dato elemento è presente nel set.
+     *
+     * @param value il valore da controllare
+     *
+     * @return true o false
+     */
+    bool contains(string_view value) const {
+        return indice[cella(value, impronta(value))] >= 0;
+    }
+
+
+    /**
+     * @brief Aggiunge un nuovo elemento nel set.
+     *
+     * @param value il valore da aggiungere
+     *
+     * @throw invoca duplicateElementException()
+     */
+    void add(string_view value) {
+        uint32_t h = impronta(value);
+        size_t i = cella(value, h);
+        if (indice[i] >= 0) {
+            throw duplicateElementException();
+        }
+        inserisci(value, h, i);
+    }
+
+
+    /**
+     * @brief Elimina un certo elemento dal set.
+     *
+     * Gli elementi successivi avanzano di una posizione, come in Set.
+     *
+     * @param value il valore da rimuovere
+     *
+     * @throw invoca elementNotFoundException()
+     */
+    void remove(string_view value) {
+        size_t i = cella(value, impronta(value));
+        if (indice[i] < 0) {
+            throw elementNotFoundException();
+        }
+        int posizione = indice[i];
+        svuota_cella(i);
+        sprecati += voci[posizione].lunghezza;
+        voci.erase(voci.begin() + posizione);
+        // gli elementi successivi avanzano di una posizione anche nella tabella
+        for (int& p : indice) {
+            p -= (p > posizione);
+        }
+        if (sprecati > caratteri.size() / 2) {
+            compatta();
+        }
+    }
+
+
+    /**
+     * @brief Operatore di accesso in sola lettura.
+     *
+     * @param index l'indice dell'elemento
+     *
+     * @return la stringa dell'elemento, valida fino alla modifica successiva del set
+     *
+     * @throw invoca std::out_of_range
+     */
+    string_view operator[](int index) const {
+        if (index < 0 || index >= size()) {
+            throw out_of_range("Indice fuori dai limiti");
+        }
+        return testo(voci[index]);
+    }
+
+
+    /**
+     * @brief Ritorna i byte di memoria usati dal set (buffer, elementi e tabella hash).
+     *
+     * @return il numero di byte allocati
+     */
+    size_t memory_usage() const {
+        return caratteri.capacity() + voci.capacity() * sizeof(Voce) + indice.capacity() * sizeof(int);
+    }
+
+
+    /**
+     * @brief Ritorna un Set<string> con gli stessi elementi nello stesso ordine.
+     *
+     * @return il nuovo set
+     */
+    Set<string> to_set() const {
+        Set<string> result;
+        result.reserve(size());
+        for (const Voce& v : voci) {
+            result.add_unchecked(string(testo(v)));
+        }
+        return result;
+    }
+
+
+    /**
+     * @brief Funzione GLOBALE che implementa l'operatore di uguaglianza.
+     *
+     * Due set sono uguali se contengono gli stessi elementi, in qualunque ordine.
+     */
+    friend bool operator==(const FlatStringSet& a, const FlatStringSet& b) {
+        if (a.size() != b.size()) return false;
+        for (const Voce& v : a.voci) {
+            if (!b.contains(a.testo(v))) return false;
+        }
+        return true;
+    }
+
+
+    /**
+     * @brief Funzione GLOBALE che implementa l'operatore di stream, nel formato di Set.
+     */
+    friend ostream& operator<<(ostream& os, const FlatStringSet& s) {
+        string buffer = to_string(s.size());
+        for (size_t i = 0; i < s.voci.size(); ++i) {
+            buffer += (i == 0) ? " (" : ") (";
+            buffer.append(s.testo(s.voci[i]));
+        }
+        if (!s.voci.empty()) buffer += ")";
+        return os.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+    }
+
+
+    /**
+     * @class const_iterator
+     * @brief Iteratore costante per la classe FlatStringSet.
+     *
+     * Restituisce gli elementi come string_view nel buffer dei caratteri.
+     */
+    class const_iterator {
+        const FlatStringSet* set; ///< il set attraversato
+        int posizione;            ///< la posizione dell'elemento corrente
+
+        friend class FlatStringSet;
+
+        const_iterator(const FlatStringSet* s, int p) : set(s), posizione(p) {}
+
+    public:
+        typedef forward_iterator_tag iterator_category; ///< Categoria di iteratore
+        typedef string_view          value_type;        ///< Tipo degli elementi restituiti
+        typedef ptrdiff_t            difference_type;   ///< Tipo della differenza tra due iteratori
+        typedef const string_view*   pointer;           ///< Puntatore a un elemento
+        typedef string_view          reference;         ///< Gli elementi sono restituiti per valore
+
+        const_iterator() : set(nullptr), posizione(0) {}
+
+        string_view operator*() const {
+            return set->testo(set->voci[posizione]);
+        }
+
+        const_iterator& operator++() {
+            ++posizione;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator tmp(*this);
+            ++posizione;
+            return tmp;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return set == other.set && posizione == other.posizione;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * @brief Ritorna l'iteratore all'inizio del set.
+     */
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    /**
+     * @brief Ritorna l'iteratore alla fine del set.
+     */
+    const_iterator end() const {
+        return const_iterator(this, size());
+    }
+};
+
+
+   /**
+     * @brief Funzione GLOBALE che salva un FlatStringSet in un file, un elemento per riga.
+     *
+     * Il file ha lo stesso formato di save per Set<string> e viene scritto con la
+     * stessa procedura (file temporaneo e rename). I caratteri vengono copiati a
+     * blocchi dal buffer del set, senza creare stringhe intermedie.
+     *
+     * @param s set da salvare
+     * @param filename il nome del file
+     * @param sincronizza se true il file viene forzato su disco (fsync) prima della rename
+     * @param dimBuffer la dimensione del buffer di scrittura in byte
+     *
+     * @throw invoca runtime_error
+    */
+    inline void save(const FlatStringSet& s, const string& filename, bool sincronizza = false,
+                     size_t dimBuffer = 1 << 20) {
+        const string temp = filename + ".tmp";
+        int fd = open_temp_file(temp);
+
+        bool ok = true;
+        string buffer;
+        buffer.reserve(dimBuffer + 256);
+        for (FlatStringSet::const_iterator it = s.begin(); it != s.end() && ok; ++it) {
+            buffer.append(*it);
+            buffer += '\n';
+            if (buffer.size() >= dimBuffer) {
+                ok = write_all(fd, buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        }
+        ok = ok && write_all(fd, buffer.data(), buffer.size());
+        commit_temp_file(fd, temp, filename, ok, sincronizza);
+    }
+
+
+   /**
+     * @brief Funzione GLOBALE che carica un FlatStringSet da un file scritto da save.
+     *
+     * Il contenuto precedente del set viene sostituito solo se il caricamento
+     * termina senza errori; le righe duplicate vengono ignorate.
+     *
+     * @param s il set da caricare
+     * @param filename il nome del file
+     *
+     * @throw invoca runtime_error
+    */
+    inline void load(FlatStringSet& s, const string& filename) {
+        SetReader<string> reader(filename);
+        FlatStringSet result;
+        size_t stima = reader.estimated_count();
+        result.reserve(static_cast<int>(stima < INT_MAX ? stima : INT_MAX));
+        reader.for_each([&result](const string& value) {
+            if (!result.contains(value)) {
+                result.add(value);
+            }
+        });
+        s.swap(result);
+    }
+
+#endif // FLATSTRINGSET_H
@@ -2,14 +2,25 @@
  * @file main.cpp
  * @brief File dei test per la classe Set, specializzata per gestire le collezioni degli elementi 
  * 
- * File dei test per la classe Set, specializzata per gestire le collezioni degli elementi.
+ * File dei test per la classe Set, specializzata per gestire le collezioni degli elementi,
+ * e per la persistenza del catalogo (registro delle modifiche, compressione e snapshot).
  */
 
 #include "set.h"
+#include "binaryset.h"
+#include "flatstringset.h"
+#include "orderedset.h"
+#include "blockcompress.h"
+#include "catalog.h"
+#include "catalogjournal.h"
+#include "catalogsnapshot.h"
+#include "editlog.h"
+#include <filesystem>
 #include <iostream>
 #include <cassert>
 #include <vector>
 #include <list>
+#include <unordered_set>
 
 using namespace std;
  
@@ -21,6 +32,51 @@ using namespace std;
  */
 typedef Set<int> defaultSet;
 
+/**
+ * @brief Strumentazione dei set di double, usata dal test dei contatori.
+ */
+template <> struct set_instrumentation<double> { typedef set_counting_stats type; };
+
+/**
+ * @brief Scuole note a tempo di compilazione, usate dal test di StaticSet.
+ */
+constexpr auto SCUOLE_NOTE = make_static_set<string_view>({"fiorentina", "veneta", "olandese", "fiamminga", "senese"});
+static_assert(SCUOLE_NOTE.contains(string_view("veneta")) && !SCUOLE_NOTE.contains(string_view("romana")),
+              "la ricerca in un StaticSet si calcola durante la compilazione");
+
+/**
+ * @brief Numeri primi minori di 20, usati come predicato di filter_out.
+ */
+constexpr auto PRIMI = make_static_set({2, 3, 5, 7, 11, 13, 17, 19});
+
+/**
+ * @brief Intero la cui copia fallisce dopo un certo numero di copie, usato dal test di OrderedSet.
+ */
+struct CopiaFragile {
+    static int copieRimaste; ///< copie ancora permesse (-1 = nessun limite)
+    int valore;
+
+    CopiaFragile(int v = 0) : valore(v) {}
+    CopiaFragile(const CopiaFragile& other) : valore(other.valore) { conta(); }
+    CopiaFragile& operator=(const CopiaFragile& other) {
+        conta();
+        valore = other.valore;
+        return *this;
+    }
+    bool operator<(const CopiaFragile& other) const { return valore < other.valore; }
+    bool operator==(const CopiaFragile& other) const { return valore == other.valore; }
+
+    static void conta() {
+        if (copieRimaste == 0) {
+            throw runtime_error("copia fallita");
+        }
+        if (copieRimaste > 0) {
+            --copieRimaste;
+        }
+    }
+};
+int CopiaFragile::copieRimaste = -1;
+
 /**
  * @brief Test della classe Set e delle sue funzioni
  * 
@@ -268,6 +324,591 @@ void test_set() {
     save(myStringSet, filename);
     cout << "Il set è stato salvato in " << filename << endl;
     cout << "------------------------------------------------" << endl;
+
+    cout << "Test della funzione save con un formattatore e la sincronizzazione su disco" << endl;
+    cout << "Esempio: save(primoSet, \"test_set_interi.txt\", formattatore, true) " << endl;
+    save(primoSet, "test_set_interi.txt", [](string& buffer, int x) {
+        buffer += "valore=" + to_string(x);
+    }, true);
+    ifstream salvato("test_set_interi.txt");
+    string primaRiga;
+    getline(salvato, primaRiga);
+    assert(primaRiga == "valore=" + to_string(primoSet[0]));
+    cout << "Prima riga del file: " << primaRiga << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della funzione load" << endl;
+    cout << "Esempio: load(setCaricato, filename) con il file scritto da save" << endl;
+    Set<string> setCaricato;
+    load(setCaricato, filename, true); // il file viene da save: nessun duplicato da controllare
+    assert(setCaricato == myStringSet);
+    cout << "Stampa del setCaricato: " << endl;
+    cout << setCaricato << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della classe SetReader" << endl;
+    cout << "Esempio: somma degli elementi letti uno alla volta da test_set_interi.txt" << endl;
+    SetReader<string> reader("test_set_interi.txt", 1 << 16);
+    int somma = 0;
+    size_t letti = reader.for_each([&somma](const string& riga) {
+        somma += stoi(riga.substr(riga.find('=') + 1));
+    });
+    cout << "Elementi letti: " << letti << ", somma: " << somma << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test delle funzioni save_binary e load_binary e della classe MappedSet" << endl;
+    cout << "Esempio: save_binary(myStringSet, \"test_set.bin\"), poi contains sul file mappato" << endl;
+    save_binary(myStringSet, "test_set.bin");
+    {
+        MappedSet<string> mappato("test_set.bin");
+        cout << "mappato.contains(\"Mondo\")? -> " << mappato.contains("Mondo") << endl;
+        cout << "mappato.contains(\"Addio\")? -> " << mappato.contains("Addio") << endl;
+        assert(mappato.size() == 3 && mappato.contains("Mondo") && !mappato.contains("Addio"));
+    }
+    {
+        // copie di test_set.bin con un offset fuori ordine e con un indice senza posizioni vuote
+        ifstream in("test_set.bin", ios::binary);
+        string originale((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        binary_set_header h;
+        memcpy(&h, originale.data(), sizeof(h));
+        vector<string> danneggiati(2, originale);
+        uint64_t fuoriOrdine = h.dimDati;
+        memcpy(&danneggiati[0][h.offsetDati + sizeof(uint64_t)], &fuoriOrdine, sizeof(fuoriOrdine));
+        for (uint64_t k = 0; k < h.slotIndice; ++k) {
+            uint32_t pieno = 1;
+            memcpy(&danneggiati[1][h.offsetIndice + k * sizeof(uint32_t)], &pieno, sizeof(pieno));
+        }
+        int rifiutati = 0;
+        for (const string& contenuto : danneggiati) {
+            ofstream("test_set_danneggiato.bin", ios::binary) << contenuto;
+            try {
+                MappedSet<string> mappato("test_set_danneggiato.bin");
+            } catch (const runtime_error&) {
+                ++rifiutati;
+            }
+        }
+        assert(rifiutati == 2);
+        cout << "File danneggiati rifiutati: " << rifiutati << endl;
+    }
+    Set<string> setBinario;
+    load_binary(setBinario, "test_set.bin");
+    assert(setBinario == myStringSet);
+    {
+        // un file con un elemento ripetuto non rispetta l'invariante del set e viene rifiutato
+        Set<int> interi;
+        interi.add(1);
+        interi.add(2);
+        interi.add(3);
+        save_binary(interi, "test_set_danneggiato.bin");
+        fstream file("test_set_danneggiato.bin", ios::in | ios::out | ios::binary);
+        binary_set_header h;
+        file.read(reinterpret_cast<char*>(&h), sizeof(h));
+        int ripetuto = interi[0];
+        file.seekp(h.offsetDati + 2 * sizeof(int));
+        file.write(reinterpret_cast<const char*>(&ripetuto), sizeof(ripetuto));
+        file.close();
+        Set<int> caricato;
+        caricato.add(7);
+        bool rifiutato = false;
+        try {
+            load_binary(caricato, "test_set_danneggiato.bin");
+        } catch (const runtime_error&) {
+            rifiutato = true;
+        }
+        assert(rifiutato && caricato.size() == 1 && caricato.contains(7));
+        cout << "File con un elemento ripetuto rifiutato da load_binary: " << rifiutato << endl;
+    }
+    cout << "Stampa del setBinario: " << endl;
+    cout << setBinario << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della funzione write_set nei formati JSON e CSV" << endl;
+    string testo;
+    write_set(testo, myStringSet, set_format::json);
+    cout << "JSON: " << testo << endl;
+    testo.clear();
+    write_set(testo, primoSet, set_format::json);
+    cout << "JSON: " << testo << endl;
+    // NaN e infiniti non sono numeri JSON validi
+    Set<double> nonFiniti;
+    nonFiniti.add(1.5);
+    nonFiniti.add(numeric_limits<double>::quiet_NaN());
+    nonFiniti.add(numeric_limits<double>::infinity());
+    nonFiniti.add(-numeric_limits<double>::infinity());
+    testo.clear();
+    write_set(testo, nonFiniti, set_format::json);
+    assert(testo == "[1.5,null,null,null]");
+    cout << "JSON: " << testo << endl;
+    cout << "CSV su standard output:" << endl;
+    cout.flush();
+    write_set(1, myStringSet, set_format::csv);
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test dei contatori di un set strumentato (Set<double>)" << endl;
+    cout << "Esempio: 100 add, 10 remove e un add duplicato" << endl;
+    Set<double> misure;
+    for (int i = 0; i < 100; ++i) {
+        misure.add(i * 0.5);
+    }
+    for (int i = 0; i < 10; ++i) {
+        misure.remove(i * 0.5);
+    }
+    try {
+        misure.add(20.0);
+    } catch (const duplicateElementException&) {
+    }
+    set_stats contatori = misure.stats();
+    cout << "confronti: " << contatori.comparisons << ", riallocazioni: " << contatori.reallocations
+         << ", byte copiati: " << contatori.bytes_copied << ", spostamenti: " << contatori.shifts
+         << ", eccezioni: " << contatori.exceptions << endl;
+    assert(contatori.reallocations == 7 && contatori.exceptions == 1);
+    assert(primoSet.stats().comparisons == 0);
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della copia e dello spostamento con memcpy/memmove (Set<int>)" << endl;
+    Set<int> grande;
+    for (int i = 0; i < 100000; ++i) {
+        grande.add_unchecked(i);
+    }
+    Set<int> copiaGrande(grande);
+    copiaGrande.remove(0);
+    copiaGrande.remove(50000);
+    grande = copiaGrande;
+    assert(grande.size() == 99998 && grande[0] == 1 && grande[49998] == 49999 && grande[49999] == 50001 && grande[99997] == 99999);
+    cout << "Dimensione dopo copia, due remove e assegnamento: " << grande.size() << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test delle impronte di un set di stringhe con un lungo prefisso comune" << endl;
+    Set<string> titoli;
+    for (int i = 0; i < 1000; ++i) {
+        titoli.add("Madonna con il Bambino e san Giovannino, bottega di Andrea del Sarto n. " + to_string(i));
+    }
+    titoli.remove("Madonna con il Bambino e san Giovannino, bottega di Andrea del Sarto n. 500");
+    assert(titoli.size() == 999);
+    assert(titoli.contains("Madonna con il Bambino e san Giovannino, bottega di Andrea del Sarto n. 999"));
+    assert(!titoli.contains("Madonna con il Bambino e san Giovannino, bottega di Andrea del Sarto n. 500"));
+    cout << "Titoli nel set: " << titoli.size() << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della classe FlatStringSet (caratteri in un unico buffer)" << endl;
+    FlatStringSet titoliCompatti(titoli);
+    assert(titoliCompatti.size() == titoli.size());
+    assert(titoliCompatti.contains(string_view("Madonna con il Bambino e san Giovannino, bottega di Andrea del Sarto n. 42")));
+    titoliCompatti.remove("Madonna con il Bambino e san Giovannino, bottega di Andrea del Sarto n. 0");
+    assert(titoliCompatti[0] == "Madonna con il Bambino e san Giovannino, bottega di Andrea del Sarto n. 1");
+    save(titoliCompatti, "test_set_titoli.txt");
+    FlatStringSet titoliRiletti;
+    load(titoliRiletti, "test_set_titoli.txt");
+    assert(titoliRiletti == titoliCompatti);
+    FlatStringSet colori(myStringSet.begin(), myStringSet.end());
+    cout << "Stampa di un FlatStringSet: " << colori << endl;
+    cout << "Memoria usata da " << titoliCompatti.size() << " titoli: " << titoliCompatti.memory_usage() << " byte" << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della funzione freeze (FrozenSet con layout di Eytzinger)" << endl;
+    Set<string> scuole;
+    scuole.add("fiorentina");
+    scuole.add("veneta");
+    scuole.add("olandese");
+    scuole.add("fiamminga");
+    scuole.add("senese");
+    FrozenSet<string> scuoleAmmesse = scuole.freeze();
+    assert(scuoleAmmesse.size() == 5);
+    assert(scuoleAmmesse.contains("senese") && !scuoleAmmesse.contains("romana"));
+    cout << "Scuole nel layout del set immutabile:";
+    for (FrozenSet<string>::const_iterator it = scuoleAmmesse.begin(); it != scuoleAmmesse.end(); ++it) {
+        cout << " " << *it;
+    }
+    cout << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della classe StaticSet (set constexpr)" << endl;
+    defaultSet primiFiltrati = filter_out(unionSet, PRIMI);
+    cout << "Filtered Set (numeri primi): " << primiFiltrati << endl;
+    Set<string> scuoleCatalogo;
+    scuoleCatalogo.add("veneta");
+    scuoleCatalogo.add("romana");
+    Set<string> scuoleComuni = scuoleCatalogo - SCUOLE_NOTE;
+    Set<string> tutteLeScuole = scuoleCatalogo + SCUOLE_NOTE;
+    assert(scuoleComuni.size() == 1 && scuoleComuni[0] == "veneta");
+    assert(tutteLeScuole.size() == 6);
+    cout << "Unione con le scuole note: " << tutteLeScuole << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della classe OrderedSet (B+-tree con ricerche per intervallo)" << endl;
+    OrderedSet<int> anni;
+    for (int i = 0; i < 1000; i++) {
+        anni.add(1300 + (i * 337) % 1000);
+    }
+    for (int anno = 1300; anno < 2300; anno += 3) {
+        anni.remove(anno);
+    }
+    assert(anni.size() == 666 && !anni.contains(1501) && anni.contains(1502));
+    assert(anni.count_range(1500, 1550) == 34);
+    assert(*anni.lower_bound(1501) == 1502 && *anni.upper_bound(1502) == 1503);
+    cout << "Anni tra 1500 e 1520:";
+    for (int anno : anni.range(1500, 1520)) {
+        cout << " " << anno;
+    }
+    cout << endl;
+    OrderedSet<string> titoliOrdinati(myStringSet);
+    cout << "Titoli tra \"B\" e \"N\":";
+    for (const string& titolo : titoliOrdinati.range("B", "N")) {
+        cout << " " << titolo;
+    }
+    cout << endl;
+    // una copia che fallisce a metà non lascia memoria persa né liberata due volte
+    Set<CopiaFragile> fragili;
+    OrderedSet<CopiaFragile> fragiliOrdinati;
+    for (int i = 0; i < 200; i++) {
+        fragili.add(CopiaFragile(i));
+        fragiliOrdinati.add(CopiaFragile(i));
+    }
+    int copieFallite = 0;
+    CopiaFragile::copieRimaste = 150;
+    try {
+        OrderedSet<CopiaFragile> copia(fragiliOrdinati);
+    } catch (const runtime_error&) {
+        copieFallite++;
+    }
+    CopiaFragile::copieRimaste = 150;
+    try {
+        OrderedSet<CopiaFragile> copia(fragili);
+    } catch (const runtime_error&) {
+        copieFallite++;
+    }
+    CopiaFragile::copieRimaste = -1;
+    assert(copieFallite == 2 && fragiliOrdinati.size() == 200);
+    cout << "Copie interrotte da un'eccezione: " << copieFallite << endl;
+    // un'aggiunta interrotta da una copia fallita, anche mentre divide i nodi, lascia il set invariato
+    OrderedSet<CopiaFragile, 4> piccoli;
+    for (int i = 0; i < 200; i++) {
+        piccoli.add(CopiaFragile(2 * i));
+    }
+    int aggiunteFallite = 0;
+    for (int permesse = 0; permesse < 60; permesse++) {
+        int prima = piccoli.size();
+        CopiaFragile::copieRimaste = permesse % 12;
+        try {
+            piccoli.add(CopiaFragile(2 * ((permesse * 37) % 200) + 1));
+        } catch (const runtime_error&) {
+            aggiunteFallite++;
+            assert(piccoli.size() == prima);
+        }
+        CopiaFragile::copieRimaste = -1;
+        int contati = 0;
+        int precedente = -1;
+        for (const CopiaFragile& c : piccoli) {
+            assert(c.valore > precedente);
+            precedente = c.valore;
+            contati++;
+        }
+        assert(contati == piccoli.size());
+        for (int i = 0; i < 200; i += 7) {
+            assert(piccoli.contains(CopiaFragile(2 * i)));
+        }
+    }
+    assert(aggiunteFallite > 0 && aggiunteFallite < 60);
+    cout << "Aggiunte interrotte da un'eccezione: " << aggiunteFallite << ", elementi: " << piccoli.size() << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della funzione contains_many (ricerca di molte chiavi insieme)" << endl;
+    defaultSet inventario;
+    for (int i = 0; i < 1000; i++) {
+        inventario.add_unchecked(i * 2);
+    }
+    vector<int> richieste = {0, 1, 2, 3, 998, 1998, 1999, 5000};
+    vector<bool> presenti;
+    assert(inventario.contains_many(richieste.data(), richieste.size(), presenti) == 4);
+    assert(presenti[0] && !presenti[1] && presenti[4] && !presenti[7]);
+    defaultSet multipli;
+    for (int i = 0; i < 1000; i++) {
+        multipli.add_unchecked(i * 3);
+    }
+    defaultSet multipliDiSei = inventario - multipli;
+    assert(multipliDiSei.size() == 334 && multipliDiSei == filter_out(inventario, multipli));
+    cout << "Chiavi trovate: " << inventario.contains_many(richieste.data(), richieste.size()) << " su " << richieste.size() << endl;
+    cout << "Multipli di 6 minori di 2000: " << multipliDiSei.size() << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test dell'impronta del contenuto (content_hash e std::hash<Set>)" << endl;
+    Set<string> riga1, riga2, riga3;
+    riga1.add("Tiziano");
+    riga1.add("veneta");
+    riga2.add("veneta");
+    riga2.add("Tiziano");
+    riga3.add("Tiziano");
+    riga3.add("fiorentina");
+    assert(riga1.content_hash() == riga2.content_hash() && riga1 == riga2);
+    assert(!(riga1 == riga3));
+    riga3.remove("fiorentina");
+    riga3.add("veneta");
+    assert(riga3.content_hash() == riga1.content_hash());
+    unordered_set<Set<string>> righeDistinte = {riga1, riga2, riga3};
+    Set<Set<string>> righe;
+    righe.add(riga1);
+    assert(righeDistinte.size() == 1 && righe.contains(riga2));
+    cout << "Righe distinte: " << righeDistinte.size() << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della classe SharedSet (copy-on-write)" << endl;
+    SharedSet<string> originale(titoli);
+    SharedSet<string> vista = originale;
+    assert(vista.is_shared() && &vista.get() == &originale.get());
+    vista.remove("Madonna con il Bambino e san Giovannino, bottega di Andrea del Sarto n. 7");
+    assert(!vista.is_shared() && !originale.is_shared());
+    assert(originale.size() == vista.size() + 1);
+    vista = originale;
+    assert(vista == originale);
+    cout << "Elementi condivisi tra le due copie: " << vista.size() << endl;
+    cout << "------------------------------------------------" << endl;
+}
+
+
+/**
+ * @brief Test della copia dei dizionari del catalogo
+ *
+ * Le chiavi della tabella di ricerca di StringPool sono viste sulle sue stringhe:
+ * una copia deve restare utilizzabile dopo la distruzione dell'originale.
+*/
+void test_dizionari() {
+    cout << "Test della copia di StringPool e CatalogDictionary" << endl;
+    StringPool copia;
+    CatalogDictionary dizionarioCopiato;
+    RigaCatalogo riga;
+    {
+        StringPool originale;
+        // stringhe corte (nel buffer interno della stringa) e lunghe (allocate a parte)
+        originale.intern("Sala 2");
+        originale.intern("Adorazione dei Magi con i ritratti della famiglia Medici");
+        StringPool costruita(originale);
+        copia = originale;
+        assert(costruita.find("Sala 2") == 0);
+
+        CatalogDictionary dizionario;
+        riga = dizionario.intern({"fiorentina", "Botticelli", "Nascita di Venere", "1485", "Sala 10"});
+        dizionarioCopiato = dizionario;
+    }
+    assert(copia.size() == 2 && copia.find("Sala 2") == 0);
+    assert(copia.find("Adorazione dei Magi con i ritratti della famiglia Medici") == 1);
+    assert(copia.intern("Sala 2") == 0 && copia.intern("Sala 3") == 2);
+    assert(dizionarioCopiato.values(riga)[2] == "Nascita di Venere");
+    assert(dizionarioCopiato.intern(2, "Nascita di Venere") == riga[2]);
+    cout << "Valori ritrovati nella copia dopo la distruzione dell'originale: " << copia.size() << endl;
+    cout << "------------------------------------------------" << endl;
+}
+
+
+/**
+ * @brief Test della ricerca nel catalogo con un limite di risultati
+ *
+ * La ricerca durante la digitazione chiede solo le prime righe: devono essere
+ * le stesse, nello stesso ordine, che si ottengono senza limite. Nelle
+ * interrogazioni un AND tra virgolette resta nel valore.
+*/
+void test_ricerca() {
+    cout << "Test della ricerca con un limite di risultati (Catalog::search)" << endl;
+    string csv = "Scuola,Autore,Titolo,Data,Sala\n";
+    for (int i = 0; i < 300; ++i) {
+        csv += string(i % 3 ? "fiorentina" : "ferrarese") + ",Autore " + to_string(i % 17) + ",Madonna col Bambino "
+             + to_string(i) + "," + to_string(1450 + i % 100) + ",Sala " + to_string(i % 12) + "\n";
+    }
+    Catalog catalogo;
+    catalogo.loadCsvData(csv);
+    // alcune righe eliminate, che la ricerca con il limite deve saltare
+    for (int i = 0; i < 20; ++i) {
+        catalogo.remove(i * 5);
+    }
+    for (const char* testo : {"f", "fe", "madonna", "bambino 1", "madona", "sala 1"}) {
+        for (int colonna = -1; colonna < COLONNE_CATALOGO; ++colonna) {
+            vector<int> tutte = catalogo.search(testo, colonna);
+            for (size_t limite : {1, 10, 100}) {
+                vector<int> prime = catalogo.search(testo, colonna, limite);
+                assert(prime.size() == min(limite, tutte.size()));
+                assert(equal(prime.begin(), prime.end(), tutte.begin()));
+            }
+        }
+    }
+    cout << "Righe trovate per \"f\": " << catalogo.search("f").size() << ", con limite 10: "
+         << catalogo.search("f", -1, 10).size() << endl;
+
+    // un AND tra virgolette fa parte del valore e non separa i predicati
+    Catalog quadri;
+    quadri.loadCsvData("Scuola,Autore,Titolo,Data,Sala\n"
+                       "fiorentina,Botticelli,Venus and Mars,1485,Sala 10\n"
+                       "fiorentina,Botticelli,Venus,1486,Sala 10\n"
+                       "veneziana,Tiziano,Mars,1530,Sala 83\n");
+    vector<int> trovate = quadri.search("Titolo ~ \"Venus and Mars\"");
+    assert(trovate.size() == 1 && quadri.position(trovate[0]) == 0);
+    trovate = quadri.search("Titolo ~ \"venus AND mars\" and Autore = Botticelli");
+    assert(trovate.size() == 1 && quadri.position(trovate[0]) == 0);
+    assert(quadri.search("Titolo ~ Venus and Autore = Tiziano").empty());
+    cout << "Righe trovate per Titolo ~ \"Venus and Mars\": " << quadri.search("Titolo ~ \"Venus and Mars\"").size() << endl;
+    cout << "------------------------------------------------" << endl;
+}
+
+
+/**
+ * @brief Test dell'interpretazione della colonna Data (DateIndex::parse)
+ *
+ * La colonna Data è testo libero letto dal CSV: i numeri troppo lunghi per essere
+ * anni non devono far traboccare i calcoli.
+*/
+void test_date() {
+    cout << "Test di DateIndex::parse con numeri lunghi nel testo libero" << endl;
+    DateIndex::Intervallo intervallo;
+    assert(!DateIndex::parse("inv. 123456789012345", intervallo));
+    assert(DateIndex::parse("1522-28", intervallo) && intervallo.da == 1522 && intervallo.a == 1528);
+    assert(DateIndex::parse("1480 circa", intervallo) && intervallo.precisione == DateIndex::CIRCA);
+    assert(DateIndex::parse("1500-123456789012345", intervallo) && intervallo.da == 1500 && intervallo.a == 1500);
+    cout << "\"1500-123456789012345\" letto come: " << intervallo.da << "-" << intervallo.a << endl;
+    cout << "------------------------------------------------" << endl;
+}
+
+
+/**
+ * @brief Test del registro delle modifiche, della compressione a blocchi e degli snapshot del catalogo
+ *
+ * Test delle classi EditLog, CatalogJournal e CatalogSnapshot e delle funzioni compressBlock
+ * e decompressBlock. I file creati vengono eliminati alla fine.
+*/
+void test_persistenza() {
+    cout << "Test della classe EditLog con una coda troncata o danneggiata" << endl;
+    const string registro = "test_registro.wal";
+    {
+        EditLog log(registro);
+        log.add({"fiorentina", "Botticelli", "Primavera", "1480", "Sala 10"});
+        log.remove(0);
+        log.insert(1, {"veneta", "Tiziano", "Flora", "1515", "Sala 83"});
+        assert(log.pending() == 3);
+        assert(log.commit(false) && log.pending() == 0);
+    }
+    vector<EditLog::Tipo> tipi;
+    size_t letti = EditLog::replay(registro, [&tipi](const EditLog::Operazione& op) { tipi.push_back(op.tipo); });
+    assert(letti == 3 && tipi.size() == 3);
+    assert(tipi[0] == EditLog::AGGIUNTA && tipi[1] == EditLog::ELIMINAZIONE && tipi[2] == EditLog::INSERIMENTO);
+    uintmax_t completo = filesystem::file_size(registro);
+
+    // un byte del contenuto dell'ultimo record cambiato: il CRC non corrisponde più
+    {
+        fstream file(registro, ios::in | ios::out | ios::binary);
+        file.seekp(static_cast<streamoff>(completo) - 1);
+        file.put('#');
+    }
+    letti = EditLog::replay(registro, [](const EditLog::Operazione&) {});
+    assert(letti == 2);
+    // l'ultimo record scritto a metà (interruzione durante la scrittura)
+    filesystem::resize_file(registro, completo - 5);
+    letti = EditLog::replay(registro, [](const EditLog::Operazione&) {});
+    assert(letti == 2);
+    cout << "Record riletti dopo la coda danneggiata e dopo quella troncata: 2 e 2" << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test di compressBlock e decompressBlock" << endl;
+    string testo;
+    for (int i = 0; i < 2000; ++i) {
+        testo += "Galleria degli Uffizi, sala " + to_string(i % 45) + ";";
+    }
+    string compresso = compressBlock(testo.data(), testo.size());
+    assert(compresso.size() < testo.size());
+    assert(decompressBlock(compresso.data(), compresso.size(), testo.size()) == testo);
+    assert(decompressBlock(compressBlock("", 0).data(), compressBlock("", 0).size(), 0).empty());
+    bool rifiutato = false;
+    try {
+        decompressBlock(compresso.data(), compresso.size(), testo.size() + 1);
+    } catch (const runtime_error&) {
+        rifiutato = true;
+    }
+    assert(rifiutato);
+    cout << "Byte originali: " << testo.size() << ", compressi: " << compresso.size() << endl;
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della classe CatalogSnapshot (scrittura, lettura, intestazione non valida)" << endl;
+    CatalogDictionary dizionario;
+    vector<RigaCatalogo> righe;
+    for (int i = 0; i < 10000; ++i) {
+        righe.push_back(dizionario.intern({i % 2 ? "fiorentina" : "veneta", "Autore " + to_string(i % 37),
+                                           "Titolo " + to_string(i), to_string(1400 + i % 300), "Sala " + to_string(i % 90)}));
+    }
+    const string snapshot = "test_catalogo.snap";
+    CatalogSnapshot::write(snapshot, righe, dizionario);
+    {
+        CatalogSnapshot letto(snapshot);
+        assert(letto.rowCount() == righe.size());
+        assert(letto.blockCount() == static_cast<int>((righe.size() + letto.rowsPerBlock() - 1) / letto.rowsPerBlock()));
+        CatalogDictionary dizionarioLetto;
+        vector<RigaCatalogo> righeLette;
+        letto.readAll(dizionarioLetto, righeLette);
+        assert(righeLette.size() == righe.size());
+        for (size_t i = 0; i < righe.size(); ++i) {
+            assert(dizionarioLetto.values(righeLette[i]) == dizionario.values(righe[i]));
+        }
+        assert(letto.readBlock(0)[0][2] == "Titolo 0");
+    }
+    // il numero di blocchi dell'intestazione (dopo magic, versione, endian, colonne e righe per blocco)
+    // non corrisponde più al numero di righe
+    {
+        fstream file(snapshot, ios::in | ios::out | ios::binary);
+        file.seekg(20);
+        uint32_t blocchi = 0;
+        file.read(reinterpret_cast<char*>(&blocchi), sizeof(blocchi));
+        ++blocchi;
+        file.seekp(20);
+        file.write(reinterpret_cast<const char*>(&blocchi), sizeof(blocchi));
+    }
+    rifiutato = false;
+    try {
+        CatalogSnapshot danneggiato(snapshot);
+    } catch (const runtime_error& e) {
+        rifiutato = true;
+        cout << "Snapshot con un blocco in più rifiutato: " << e.what() << endl;
+    }
+    assert(rifiutato);
+    cout << "------------------------------------------------" << endl;
+
+    cout << "Test della classe CatalogJournal (recover, compact, recover)" << endl;
+    const string prefisso = "test_registro";
+    vector<RigaCatalogo> originali(righe.begin(), righe.begin() + 3);
+    vector<RigaCatalogo> correnti;
+    {
+        CatalogJournal journal(prefisso, 64);
+        assert(!journal.recover(dizionario, originali, correnti));
+        assert(correnti == originali);
+        vector<string> nuova = {"senese", "Duccio", "Maestà", "1285", "Sala 2"};
+        journal.add(nuova);
+        correnti.push_back(dizionario.intern(nuova));
+        journal.remove(0);
+        correnti.erase(correnti.begin());
+        assert(journal.commit(false) && journal.needsCompaction());
+        journal.compact(correnti, dizionario);
+        // le modifiche successive vanno nel nuovo segmento, mentre il checkpoint viene scritto
+        journal.insert(0, dizionario.values(originali[0]));
+        correnti.insert(correnti.begin(), originali[0]);
+        assert(journal.commit(false));
+    }
+    vector<RigaCatalogo> recuperate;
+    {
+        CatalogJournal journal(prefisso, 64);
+        assert(journal.recover(dizionario, originali, recuperate));
+        assert(recuperate == correnti);
+        assert(!journal.compacting());
+    }
+    // le stesse modifiche non si rileggono su righe iniziali diverse
+    {
+        CatalogJournal journal(prefisso, 64);
+        assert(!journal.recover(dizionario, correnti, recuperate));
+        assert(recuperate == correnti);
+    }
+    cout << "Righe iniziali: " << originali.size() << ", righe dopo recover: " << correnti.size() << endl;
+    cout << "------------------------------------------------" << endl;
+
+    std::error_code errore;
+    for (const filesystem::directory_entry& file : filesystem::directory_iterator(".")) {
+        string nome = file.path().filename().string();
+        if (nome.rfind(prefisso, 0) == 0 || nome == snapshot) {
+            filesystem::remove(file.path(), errore);
+        }
+    }
 }
 
 
@@ -280,6 +921,10 @@ void test_set() {
 int main() {
     try {
         test_set();
+        test_dizionari();
+        test_ricerca();
+        test_date();
+        test_persistenza();
     } catch (const duplicateElementException& e) {
         cerr << "######################################################" << std::endl;
         cerr << "Exception: " << e.what() << endl;
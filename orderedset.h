@@ -0,0 +1,712 @@
+/**
+  @file orderedset.h
+
+  @brief File header della classe OrderedSet
+
+  File di dichiarazioni/definizioni della classe OrderedSet, un set ordinato
+  implementato con un B+-tree, con ricerche per intervallo.
+*/
+
+#ifndef ORDEREDSET_H
+#define ORDEREDSET_H
+
+#include "set.h"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
+
+/**
+ * @brief Numero di chiavi di un nodo di OrderedSet<T>.
+ *
+ * Un nodo occupa circa quattro linee di cache (256 byte di chiavi), che vengono
+ * lette in sequenza e quindi caricate insieme dal prefetch hardware; per gli
+ * elementi grandi si tengono comunque almeno 8 chiavi per nodo.
+ */
+template <typename T>
+constexpr int ordered_set_node_keys() {
+    return (256 / sizeof(T)) > 8 ? static_cast<int>(256 / sizeof(T)) : 8;
+}
+
+
+/**
+  @brief classe OrderedSet
+
+  Set ordinato di elementi generici T, confrontati con operator<. Gli elementi
+  sono conservati in un B+-tree: i nodi interni contengono solo le chiavi di
+  separazione, le foglie contengono gli elementi in ordine e sono collegate tra
+  loro, così una scansione ordinata o di un intervallo legge le foglie una dopo
+  l'altra senza risalire l'albero. add, remove e contains costano O(log n).
+
+  L'interfaccia segue quella di Set (add, remove, contains, size, const_iterator)
+  con in più lower_bound, upper_bound e range per le ricerche per intervallo.
+  Ogni nodo contiene al massimo B chiavi; i nodi pieni vengono divisi durante la
+  discesa di add e i nodi al minimo vengono riempiti (prestito o fusione con un
+  fratello) durante la discesa di remove, quindi nessuna delle due risale l'albero.
+*/
+template <typename T, int B = ordered_set_node_keys<T>()>
+class OrderedSet {
+    static_assert(B >= 4, "un nodo di OrderedSet deve contenere almeno 4 chiavi");
+
+    static const int MIN_FOGLIA = B / 2;        ///< chiavi minime di una foglia (tranne la radice)
+    static const int MIN_INTERNO = (B - 1) / 2; ///< chiavi minime di un nodo interno (tranne la radice)
+
+    /**
+     * @brief Parte comune di foglie e nodi interni.
+     */
+    struct Nodo {
+        bool foglia; ///< true per le foglie
+        int n;       ///< numero di chiavi presenti
+        T chiavi[B]; ///< chiavi in ordine crescente
+
+        explicit Nodo(bool f) : foglia(f), n(0) {}
+    };
+
+    /**
+     * @brief Foglia: contiene gli elementi ed è collegata alle foglie vicine.
+     */
+    struct Foglia : Nodo {
+        Foglia* precedente; ///< foglia precedente (nullptr per la prima)
+        Foglia* successiva; ///< foglia successiva (nullptr per l'ultima)
+
+        Foglia() : Nodo(true), precedente(nullptr), successiva(nullptr) {}
+    };
+
+    /**
+     * @brief Nodo interno: il figlio i contiene le chiavi tra chiavi[i-1] (inclusa) e chiavi[i] (esclusa).
+     */
+    struct Interno : Nodo {
+        Nodo* figli[B + 1]; ///< n + 1 figli
+
+        Interno() : Nodo(false) {}
+    };
+
+    Nodo* radice;    ///< radice dell'albero (una foglia se il set è piccolo)
+    Foglia* prima;   ///< foglia con gli elementi più piccoli
+    int currentSize; ///< il numero di elementi nel set
+
+
+    /**
+     * @brief Dealloca un sottoalbero.
+     */
+    static void libera(Nodo* nodo) {
+        if (nodo->foglia) {
+            delete static_cast<Foglia*>(nodo);
+        } else {
+            Interno* interno = static_cast<Interno*>(nodo);
+            for (int i = 0; i <= interno->n; ++i) {
+                libera(interno->figli[i]);
+            }
+            delete interno;
+        }
+    }
+
+    /**
+     * @brief Ritorna l'indice del figlio di un nodo interno in cui si trova value.
+     */
+    static int figlio(const Nodo* nodo, const T& value) {
+        return static_cast<int>(std::upper_bound(nodo->chiavi, nodo->chiavi + nodo->n, value) - nodo->chiavi);
+    }
+
+    /**
+     * @brief Scende fino alla foglia in cui si trova (o andrebbe) value.
+     */
+    const Foglia* foglia_di(const T& value) const {
+        const Nodo* nodo = radice;
+        while (!nodo->foglia) {
+            nodo = static_cast<const Interno*>(nodo)->figli[figlio(nodo, value)];
+        }
+        return static_cast<const Foglia*>(nodo);
+    }
+
+    /**
+     * @brief Inserisce una chiave nella posizione pos di un nodo non pieno.
+     *
+     * Se l'assegnamento per spostamento di T non lancia eccezioni, la chiave viene
+     * copiata prima di fare spazio nel nodo; altrimenti si prepara una copia del nodo
+     * con la nuova chiave, che prende il posto del vecchio solo quando è completa.
+     * In entrambi i casi, se la copia di T lancia un'eccezione, il nodo resta invariato.
+     *
+     * @param posto il puntatore al nodo (la radice oppure un figlio del padre), aggiornato se il nodo viene sostituito
+     * @param pos la posizione della nuova chiave
+     * @param chiave la chiave da inserire
+     */
+    void inserisciChiave(Nodo*& posto, int pos, const T& chiave) {
+        Nodo* nodo = posto;
+        if constexpr (std::is_nothrow_move_assignable<T>::value) {
+            T copia(chiave);
+            std::move_backward(nodo->chiavi + pos, nodo->chiavi + nodo->n, nodo->chiavi + nodo->n + 1);
+            nodo->chiavi[pos] = std::move(copia);
+            ++nodo->n;
+            return;
+        }
+
+        std::unique_ptr<Foglia> nuovaFoglia;
+        std::unique_ptr<Interno> nuovoInterno;
+        Nodo* nuovo;
+        if (nodo->foglia) {
+            nuovaFoglia.reset(new Foglia());
+            nuovo = nuovaFoglia.get();
+        } else {
+            nuovoInterno.reset(new Interno());
+            nuovo = nuovoInterno.get();
+        }
+        std::copy(nodo->chiavi, nodo->chiavi + pos, nuovo->chiavi);
+        nuovo->chiavi[pos] = chiave;
+        std::copy(nodo->chiavi + pos, nodo->chiavi + nodo->n, nuovo->chiavi + pos + 1);
+
+        // da qui in poi si spostano solo puntatori e contatori
+        nuovo->n = nodo->n + 1;
+        if (nodo->foglia) {
+            Foglia* vecchia = static_cast<Foglia*>(nodo);
+            Foglia* nuova = nuovaFoglia.release();
+            nuova->precedente = vecchia->precedente;
+            nuova->successiva = vecchia->successiva;
+            if (vecchia->precedente != nullptr) {
+                vecchia->precedente->successiva = nuova;
+            } else {
+                prima = nuova;
+            }
+            if (vecchia->successiva != nullptr) {
+                vecchia->successiva->precedente = nuova;
+            }
+            delete vecchia;
+        } else {
+            Interno* vecchio = static_cast<Interno*>(nodo);
+            std::copy(vecchio->figli, vecchio->figli + vecchio->n + 1, nuovoInterno->figli);
+            nuovoInterno.release();
+            delete vecchio;
+        }
+        posto = nuovo;
+    }
+
+    /**
+     * @brief Divide il figlio i di un nodo interno, che deve essere pieno.
+     *
+     * Una foglia copia la prima chiave della nuova foglia nel padre; un nodo
+     * interno vi sposta la chiave centrale. Se la copia di T lancia un'eccezione
+     * l'albero resta invariato.
+     *
+     * @param posto il puntatore al padre (la radice oppure un figlio del nonno), aggiornato se il padre viene sostituito
+     * @param i l'indice del figlio da dividere
+     */
+    void dividi(Nodo*& posto, int i) {
+        // le chiavi vengono copiate nel nuovo nodo e nel padre prima di collegare il nuovo nodo:
+        // se una copia di T lancia un'eccezione il nuovo nodo viene liberato e il padre è invariato
+        const int resta = B / 2;
+        Nodo* sinistro = static_cast<Interno*>(posto)->figli[i];
+        std::unique_ptr<Foglia> nuovaFoglia;
+        std::unique_ptr<Interno> nuovoInterno;
+        if (sinistro->foglia) {
+            nuovaFoglia.reset(new Foglia());
+            std::copy(sinistro->chiavi + resta, sinistro->chiavi + B, nuovaFoglia->chiavi);
+            inserisciChiave(posto, i, nuovaFoglia->chiavi[0]);
+        } else {
+            nuovoInterno.reset(new Interno());
+            std::copy(sinistro->chiavi + resta + 1, sinistro->chiavi + B, nuovoInterno->chiavi);
+            inserisciChiave(posto, i, sinistro->chiavi[resta]);
+        }
+
+        // da qui in poi si spostano solo puntatori e contatori
+        Interno* padre = static_cast<Interno*>(posto);
+        Nodo* destro;
+        if (nuovaFoglia) {
+            Foglia* vecchia = static_cast<Foglia*>(sinistro);
+            Foglia* nuova = nuovaFoglia.release();
+            nuova->n = B - resta;
+            nuova->successiva = vecchia->successiva;
+            nuova->precedente = vecchia;
+            if (vecchia->successiva != nullptr) {
+                vecchia->successiva->precedente = nuova;
+            }
+            vecchia->successiva = nuova;
+            destro = nuova;
+        } else {
+            Interno* vecchio = static_cast<Interno*>(sinistro);
+            Interno* nuovo = nuovoInterno.release();
+            std::copy(vecchio->figli + resta + 1, vecchio->figli + B + 1, nuovo->figli);
+            nuovo->n = B - resta - 1;
+            destro = nuovo;
+        }
+        sinistro->n = resta;
+        // il padre ha già la nuova chiave: i suoi figli passano da n a n + 1
+        std::copy_backward(padre->figli + i + 1, padre->figli + padre->n, padre->figli + padre->n + 1);
+        padre->figli[i + 1] = destro;
+    }
+
+    /**
+     * @brief Porta il figlio i di un nodo interno sopra il minimo di chiavi.
+     *
+     * Prende una chiave da un fratello che ne ha più del minimo, altrimenti fonde
+     * il figlio con un fratello.
+     *
+     * @return l'indice del figlio in cui continuare la discesa
+     */
+    int riempi(Interno* padre, int i) {
+        Nodo* nodo = padre->figli[i];
+        Nodo* sinistro = (i > 0) ? padre->figli[i - 1] : nullptr;
+        Nodo* destro = (i < padre->n) ? padre->figli[i + 1] : nullptr;
+        const int minimo = nodo->foglia ? MIN_FOGLIA : MIN_INTERNO;
+
+        if (sinistro != nullptr && sinistro->n > minimo) {
+            std::copy_backward(nodo->chiavi, nodo->chiavi + nodo->n, nodo->chiavi + nodo->n + 1);
+            if (nodo->foglia) {
+                nodo->chiavi[0] = sinistro->chiavi[sinistro->n - 1];
+                padre->chiavi[i - 1] = nodo->chiavi[0];
+            } else {
+                Interno* in = static_cast<Interno*>(nodo);
+                Interno* is = static_cast<Interno*>(sinistro);
+                std::copy_backward(in->figli, in->figli + in->n + 1, in->figli + in->n + 2);
+                in->chiavi[0] = padre->chiavi[i - 1];
+                in->figli[0] = is->figli[is->n];
+                padre->chiavi[i - 1] = is->chiavi[is->n - 1];
+            }
+            ++nodo->n;
+            --sinistro->n;
+            return i;
+        }
+        if (destro != nullptr && destro->n > minimo) {
+            if (nodo->foglia) {
+                nodo->chiavi[nodo->n] = destro->chiavi[0];
+                std::copy(destro->chiavi + 1, destro->chiavi + destro->n, destro->chiavi);
+                padre->chiavi[i] = destro->chiavi[0];
+            } else {
+                Interno* in = static_cast<Interno*>(nodo);
+                Interno* id = static_cast<Interno*>(destro);
+                in->chiavi[in->n] = padre->chiavi[i];
+                in->figli[in->n + 1] = id->figli[0];
+                padre->chiavi[i] = id->chiavi[0];
+                std::copy(id->chiavi + 1, id->chiavi + id->n, id->chiavi);
+                std::copy(id->figli + 1, id->figli + id->n + 1, id->figli);
+            }
+            ++nodo->n;
+            --destro->n;
+            return i;
+        }
+        // nessun fratello può cedere una chiave: si fonde con il fratello destro (o con il sinistro)
+        if (destro == nullptr) {
+            fondi(padre, i - 1);
+            return i - 1;
+        }
+        fondi(padre, i);
+        return i;
+    }
+
+    /**
+     * @brief Fonde i figli i e i+1 di un nodo interno nel figlio i.
+     */
+    void fondi(Interno* padre, int i) {
+        Nodo* sinistro = padre->figli[i];
+        Nodo* destro = padre->figli[i + 1];
+        if (sinistro->foglia) {
+            Foglia* fs = static_cast<Foglia*>(sinistro);
+            Foglia* fd = static_cast<Foglia*>(destro);
+            std::copy(fd->chiavi, fd->chiavi + fd->n, fs->chiavi + fs->n);
+            fs->n += fd->n;
+            fs->successiva = fd->successiva;
+            if (fd->successiva != nullptr) {
+                fd->successiva->precedente = fs;
+            }
+            delete fd;
+        } else {
+            Interno* is = static_cast<Interno*>(sinistro);
+            Interno* id = static_cast<Interno*>(destro);
+            is->chiavi[is->n] = padre->chiavi[i];
+            std::copy(id->chiavi, id->chiavi + id->n, is->chiavi + is->n + 1);
+            std::copy(id->figli, id->figli + id->n + 1, is->figli + is->n + 1);
+            is->n += 1 + id->n;
+            delete id;
+        }
+        std::copy(padre->chiavi + i + 1, padre->chiavi + padre->n, padre->chiavi + i);
+        std::copy(padre->figli + i + 2, padre->figli + padre->n + 1, padre->figli + i + 1);
+        --padre->n;
+    }
+
+public:
+    /**
+     * @class const_iterator
+     * @brief Iteratore costante che attraversa gli elementi in ordine crescente.
+     *
+     * Scorre le chiavi di una foglia e passa alla foglia successiva tramite il
+     * collegamento tra le foglie.
+     */
+    class const_iterator {
+        const Foglia* foglia; ///< foglia corrente (nullptr per la fine)
+        int indice;           ///< posizione dell'elemento nella foglia
+
+        friend class OrderedSet;
+
+        const_iterator(const Foglia* f, int i) : foglia(f), indice(i) {
+            // una posizione oltre l'ultima chiave di una foglia è il primo elemento della successiva
+            if (foglia != nullptr && indice >= foglia->n) {
+                foglia = foglia->successiva;
+                indice = 0;
+            }
+        }
+
+    public:
+        typedef forward_iterator_tag iterator_category; ///< Categoria di iteratore
+        typedef T                    value_type;        ///< Tipo degli elementi
+        typedef ptrdiff_t            difference_type;   ///< Tipo della differenza tra due iteratori
+        typedef const T*             pointer;           ///< Puntatore a un elemento costante
+        typedef const T&             reference;         ///< Riferimento a un elemento costante
+
+        const_iterator() : foglia(nullptr), indice(0) {}
+
+        reference operator*() const {
+            return foglia->chiavi[indice];
+        }
+
+        pointer operator->() const {
+            return &foglia->chiavi[indice];
+        }
+
+        const_iterator& operator++() {
+            if (++indice >= foglia->n) {
+                foglia = foglia->successiva;
+                indice = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return foglia == other.foglia && indice == other.indice;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * @brief Intervallo di elementi [begin, end), utilizzabile in un ciclo for.
+     */
+    struct range_type {
+        const_iterator inizio; ///< primo elemento dell'intervallo
+        const_iterator fine;   ///< elemento successivo all'ultimo
+
+        const_iterator begin() const { return inizio; }
+        const_iterator end() const { return fine; }
+    };
+
+
+    /**
+     * @brief Costruttore di default, crea un set vuoto.
+     */
+    OrderedSet() : radice(nullptr), prima(nullptr), currentSize(0) {
+        prima = new Foglia();
+        radice = prima;
+    }
+
+
+    /**
+     * @brief Costruttore che copia gli elementi di un Set.
+     *
+     * @param s il set da copiare
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione, oltre a quelle della copia di T
+     */
+    explicit OrderedSet(const Set<T>& s) : OrderedSet() {
+        // il costruttore delegato è già terminato: se una copia fallisce
+        // è il distruttore a liberare l'albero
+        for (typename Set<T>::const_iterator it = s.begin(); it != s.end(); ++it) {
+            add(*it);
+        }
+    }
+
+
+    /**
+     * @brief Costruttore di copia.
+     *
+     * @param other il set da copiare
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione, oltre a quelle della copia di T
+     */
+    OrderedSet(const OrderedSet& other) : OrderedSet() {
+        for (const_iterator it = other.begin(); it != other.end(); ++it) {
+            add(*it);
+        }
+    }
+
+
+    /**
+     * @brief Operatore di assegnamento (copia e scambio).
+     *
+     * @param other il set da copiare
+     *
+     * @return reference a questo set
+     */
+    OrderedSet& operator=(const OrderedSet& other) {
+        if (this != &other) {
+            OrderedSet temp(other);
+            swap(temp);
+        }
+        return *this;
+    }
+
+
+    /**
+     * @brief Distruttore.
+     */
+    ~OrderedSet() {
+        libera(radice);
+    }
+
+
+    /**
+     * @brief Scambia il contenuto di questo set con un altro set.
+     *
+     * @param other il set con cui scambiare i dati
+     */
+    void swap(OrderedSet& other) {
+        std::swap(radice, other.radice);
+        std::swap(prima, other.prima);
+        std::swap(currentSize, other.currentSize);
+    }
+
+
+    /**
+     * @brief Svuota il set.
+     */
+    void clear() {
+        OrderedSet vuoto;
+        swap(vuoto);
+    }
+
+
+    /**
+     * @brief Ritorna il numero di elementi presenti nel set.
+     *
+     * @return il numero di elementi
+     */
+    int size() const {
+        return currentSize;
+    }
+
+
+    /**
+     * @brief Controlla se un dato elemento è presente nel set.
+     *
+     * @param value il valore da controllare
+     *
+     * @return true o false
+     */
+    bool contains(const T& value) const {
+        const Foglia* f = foglia_di(value);
+        const T* p = std::lower_bound(f->chiavi, f->chiavi + f->n, value);
+        return p != f->chiavi + f->n && !(value < *p);
+    }
+
+
+    /**
+     * @brief Aggiunge un nuovo elemento nel set, nella sua posizione in ordine.
+     *
+     * Se la copia di un elemento lancia un'eccezione, anche durante la divisione
+     * di un nodo, il set resta invariato.
+     *
+     * @param value il valore da aggiungere
+     *
+     * @throw invoca duplicateElementException()
+     */
+    void add(const T& value) {
+        if (contains(value)) {
+            throw duplicateElementException();
+        }
+        // una radice piena viene divisa sotto una nuova radice: l'albero cresce dall'alto,
+        // e la nuova radice viene collegata solo se la divisione riesce
+        if (radice->n == B) {
+            Interno* vuota = new Interno();
+            vuota->figli[0] = radice;
+            Nodo* nuova = vuota;
+            try {
+                dividi(nuova, 0);
+            } catch (...) {
+                delete vuota;
+                throw;
+            }
+            radice = nuova;
+        }
+        // si scende tenendo il puntatore al nodo corrente, che una divisione può sostituire
+        Nodo** posto = &radice;
+        while (!(*posto)->foglia) {
+            int i = figlio(*posto, value);
+            if (static_cast<Interno*>(*posto)->figli[i]->n == B) {
+                dividi(*posto, i);
+                i = figlio(*posto, value);
+            }
+            posto = &static_cast<Interno*>(*posto)->figli[i];
+        }
+        Nodo* nodo = *posto;
+        int pos = static_cast<int>(std::lower_bound(nodo->chiavi, nodo->chiavi + nodo->n, value) - nodo->chiavi);
+        inserisciChiave(*posto, pos, value);
+        ++currentSize;
+    }
+
+
+    /**
+     * @brief Elimina un certo elemento dal set.
+     *
+     * @param value il valore da rimuovere
+     *
+     * @throw invoca elementNotFoundException()
+     */
+    void remove(const T& value) {
+        if (!contains(value)) {
+            throw elementNotFoundException();
+        }
+        Nodo* nodo = radice;
+        while (!nodo->foglia) {
+            Interno* interno = static_cast<Interno*>(nodo);
+            int i = figlio(interno, value);
+            const int minimo = interno->figli[i]->foglia ? MIN_FOGLIA : MIN_INTERNO;
+            if (interno->figli[i]->n <= minimo) {
+                i = riempi(interno, i);
+                // dopo una fusione la radice può essere rimasta senza chiavi
+                if (interno == radice && interno->n == 0) {
+                    radice = interno->figli[0];
+                    delete interno;
+                    nodo = radice;
+                    continue;
+                }
+                i = figlio(interno, value);
+            }
+            nodo = interno->figli[i];
+        }
+        T* p = std::lower_bound(nodo->chiavi, nodo->chiavi + nodo->n, value);
+        std::copy(p + 1, nodo->chiavi + nodo->n, p);
+        --nodo->n;
+        --currentSize;
+    }
+
+
+    /**
+     * @brief Ritorna l'iteratore al primo elemento non minore di value.
+     *
+     * @param value il valore cercato
+     *
+     * @return l'iteratore, oppure end() se tutti gli elementi sono minori di value
+     */
+    const_iterator lower_bound(const T& value) const {
+        const Foglia* f = foglia_di(value);
+        return const_iterator(f, static_cast<int>(std::lower_bound(f->chiavi, f->chiavi + f->n, value) - f->chiavi));
+    }
+
+
+    /**
+     * @brief Ritorna l'iteratore al primo elemento maggiore di value.
+     *
+     * @param value il valore cercato
+     *
+     * @return l'iteratore, oppure end() se nessun elemento è maggiore di value
+     */
+    const_iterator upper_bound(const T& value) const {
+        const Foglia* f = foglia_di(value);
+        return const_iterator(f, static_cast<int>(std::upper_bound(f->chiavi, f->chiavi + f->n, value) - f->chiavi));
+    }
+
+
+    /**
+     * @brief Ritorna gli elementi compresi tra da e a, estremi inclusi.
+     *
+     * Ad esempio tutti gli anni tra 1500 e 1550, oppure tutti i titoli tra "A" e "C":
+     * @code
+     * for (int anno : anni.range(1500, 1550)) { ... }
+     * @endcode
+     *
+     * @param da il primo valore dell'intervallo
+     * @param a l'ultimo valore dell'intervallo
+     *
+     * @return l'intervallo [lower_bound(da), upper_bound(a)), vuoto se a < da
+     */
+    range_type range(const T& da, const T& a) const {
+        if (a < da) {
+            return range_type{end(), end()};
+        }
+        return range_type{lower_bound(da), upper_bound(a)};
+    }
+
+
+    /**
+     * @brief Conta gli elementi compresi tra da e a, estremi inclusi.
+     *
+     * Le foglie interamente comprese nell'intervallo vengono contate senza leggerne le chiavi.
+     *
+     * @param da il primo valore dell'intervallo
+     * @param a l'ultimo valore dell'intervallo
+     *
+     * @return il numero di elementi nell'intervallo
+     */
+    int count_range(const T& da, const T& a) const {
+        if (a < da) {
+            return 0;
+        }
+        const_iterator inizio = lower_bound(da), fine = upper_bound(a);
+        if (inizio.foglia == nullptr) {
+            return 0;
+        }
+        if (inizio.foglia == fine.foglia) {
+            return fine.indice - inizio.indice;
+        }
+        int totale = inizio.foglia->n - inizio.indice;
+        for (const Foglia* f = inizio.foglia->successiva; f != fine.foglia; f = f->successiva) {
+            totale += f->n;
+        }
+        return totale + fine.indice;
+    }
+
+
+    /**
+     * @brief Ritorna un iteratore costante al primo (più piccolo) elemento del set.
+     */
+    const_iterator begin() const {
+        return const_iterator(prima, 0);
+    }
+
+
+    /**
+     * @brief Ritorna un iteratore costante che punta appena oltre l'ultimo elemento del set.
+     */
+    const_iterator end() const {
+        return const_iterator();
+    }
+
+
+    /**
+     * @brief Funzione GLOBALE che implementa l'operatore di uguaglianza.
+     *
+     * Gli elementi sono in ordine in entrambi i set, quindi basta un confronto in sequenza.
+     */
+    friend bool operator==(const OrderedSet& a, const OrderedSet& b) {
+        if (a.size() != b.size()) return false;
+        for (const_iterator i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j) {
+            if (*i < *j || *j < *i) return false;
+        }
+        return true;
+    }
+
+
+    /**
+     * @brief Funzione GLOBALE che implementa l'operatore di stream, nel formato di Set.
+     */
+    friend ostream& operator<<(ostream& os, const OrderedSet& s) {
+        os << s.size();
+        const char* separatore = " (";
+        for (const_iterator it = s.begin(); it != s.end(); ++it) {
+            os << separatore << *it;
+            separatore = ") (";
+        }
+        if (s.size() > 0) {
+            os << ")";
+        }
+        return os;
+    }
+};
+
+#endif // ORDEREDSET_H